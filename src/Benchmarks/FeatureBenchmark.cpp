@@ -0,0 +1,158 @@
+//
+// Measures the cost of updating each rolling window operator, and of feature pipelines of one and of
+// every feature, with one book update. Updates are timed in batches so that reading the clock does not swamp
+// the few nanoseconds an update takes, and each batch is recorded as its cost per update. The updates
+// are a random walk of the BBO with a book update every 10us on average, so the time windows hold
+// samples from about 100,000 updates per second. Updates are spread across INSTRUMENTS slots.
+//
+// Usage: FeatureBenchmark [iterations]
+//
+// Created by Michael Lewis on 1/28/24.
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../CommonServer/telemetry/LatencyHistogram.hpp"
+#include "../StrategyCommon/features/FeaturePipeline.hpp"
+#include "../StrategyCommon/features/Features.hpp"
+#include "../StrategyCommon/features/WindowOperators.hpp"
+
+using namespace BeaconTech;
+
+namespace
+{
+    constexpr std::uint64_t BATCH_SIZE = 64;
+    constexpr std::int64_t WINDOW_NANOS = 1'000'000'000;
+    constexpr std::uint32_t WINDOW_CAPACITY = 131072;
+    constexpr std::uint32_t INSTRUMENTS = 8;
+
+    struct Update
+    {
+        std::int64_t nanos;
+        double bidPrice;
+        double bidSize;
+        double askPrice;
+        double askSize;
+    };
+
+    std::int64_t now() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Features are NaN until a window has enough samples
+    void consume(double& sink, double feature) noexcept
+    {
+        if (!std::isnan(feature)) sink += feature;
+    }
+
+    std::vector<Update> generateUpdates(std::uint64_t count)
+    {
+        std::mt19937_64 random{42};
+        std::exponential_distribution<double> gaps{1.0 / 10'000.0};
+        std::uniform_int_distribution<int> ticks{-1, 1};
+        std::uniform_int_distribution<int> sizes{1, 500};
+        std::uniform_int_distribution<int> spreadTicks{1, 3};
+
+        std::vector<Update> updates;
+        updates.reserve(count);
+
+        std::int64_t nanos = 0;
+        double bidPrice = 100.0;
+        for (std::uint64_t i = 0; i < count; ++i)
+        {
+            nanos += static_cast<std::int64_t>(gaps(random));
+            bidPrice += 0.01 * ticks(random);
+            updates.push_back(Update{nanos, bidPrice, static_cast<double>(sizes(random)),
+                                     bidPrice + 0.01 * spreadTicks(random), static_cast<double>(sizes(random))});
+        }
+
+        return updates;
+    }
+
+    template<typename UpdateCall>
+    void run(const std::string& name, const std::vector<Update>& updates, UpdateCall&& updateCall)
+    {
+        Common::LatencyHistogram histogram;
+
+        for (std::uint64_t batch = 0; batch + BATCH_SIZE <= updates.size(); batch += BATCH_SIZE)
+        {
+            const std::int64_t start = now();
+            for (std::uint64_t i = batch; i < batch + BATCH_SIZE; ++i) updateCall(updates[i]);
+            histogram.record(static_cast<std::uint64_t>(now() - start) / BATCH_SIZE);
+        }
+
+        std::cout << name << " (ns/update): mean=" << histogram.getMean()
+                  << " p50=" << histogram.percentile(50.0)
+                  << " p99=" << histogram.percentile(99.0)
+                  << " p99.9=" << histogram.percentile(99.9)
+                  << " max=" << histogram.getMax() << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const std::vector<Update> updates = generateUpdates(iterations);
+    double sink = 0.0;
+
+    Strategies::TimeDecayEwma ewma{WINDOW_NANOS};
+    run("TimeDecayEwma", updates, [&](const Update& update) {
+        ewma.update(update.nanos, update.bidPrice);
+        consume(sink, ewma.getValue());
+    });
+
+    Strategies::CountWindow countWindow{100};
+    run("CountWindow(100)", updates, [&](const Update& update) {
+        countWindow.add(update.askPrice - update.bidPrice);
+        consume(sink, countWindow.getStdDev());
+    });
+
+    Strategies::TimeWindow timeWindow{WINDOW_NANOS, WINDOW_CAPACITY};
+    run("TimeWindow(1s)", updates, [&](const Update& update) {
+        timeWindow.add(update.nanos, update.bidSize - update.askSize);
+        consume(sink, timeWindow.getSum());
+    });
+
+    const Strategies::FeatureParams params{WINDOW_NANOS, WINDOW_NANOS, WINDOW_CAPACITY / INSTRUMENTS, 100};
+    std::uint32_t slot = 0;
+
+    Strategies::FeaturePipeline<Strategies::FairPrice> fairPrice{"features-benchmark", INSTRUMENTS, params};
+    run("FeaturePipeline<FairPrice>", updates, [&](const Update& update) {
+        slot = (slot + 1) % INSTRUMENTS;
+        fairPrice.update(slot, Strategies::BookTop{update.nanos, update.bidPrice, update.bidSize,
+                                                   update.askPrice, update.askSize});
+        consume(sink, fairPrice.get<Strategies::FairPrice>().getValue(slot));
+    });
+
+    Strategies::FeaturePipeline<Strategies::FairPrice, Strategies::BookImbalance, Strategies::EwmaMidPrice,
+                                Strategies::RealizedVolatility, Strategies::OrderFlowImbalance,
+                                Strategies::UpdateIntensity, Strategies::SpreadStats>
+            allFeatures{"features-benchmark", INSTRUMENTS, params};
+    run("FeaturePipeline<every feature>", updates, [&](const Update& update) {
+        slot = (slot + 1) % INSTRUMENTS;
+        allFeatures.update(slot, Strategies::BookTop{update.nanos, update.bidPrice, update.bidSize,
+                                                     update.askPrice, update.askSize});
+        consume(sink, allFeatures.get<Strategies::FairPrice>().getValue(slot));
+        consume(sink, allFeatures.get<Strategies::BookImbalance>().getValue(slot));
+        consume(sink, allFeatures.get<Strategies::EwmaMidPrice>().getValue(slot));
+        consume(sink, allFeatures.get<Strategies::RealizedVolatility>().getValue(slot));
+        consume(sink, allFeatures.get<Strategies::OrderFlowImbalance>().getValue(slot));
+        consume(sink, allFeatures.get<Strategies::UpdateIntensity>().getValue(slot));
+        consume(sink, allFeatures.get<Strategies::SpreadStats>().getMean(slot));
+        consume(sink, allFeatures.get<Strategies::SpreadStats>().getStdDev(slot));
+    });
+
+    // Keeps the updates from being optimized away
+    std::cout << "checksum=" << sink << std::endl;
+
+    return EXIT_SUCCESS;
+}
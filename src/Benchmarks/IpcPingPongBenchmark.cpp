@@ -0,0 +1,108 @@
+//
+// Measures the one-way latency of the shared memory rings between the Strategies and RiskManager
+// processes. The parent publishes an OrderRequest, a forked child echoes it back as an ExecutionReport
+// and the parent records half of the round trip. Both processes busy-spin, so pin them to separate
+// cores (e.g. taskset -c 2,3) for meaningful numbers.
+//
+// Usage: IpcPingPongBenchmark [iterations]
+//
+// Created by Michael Lewis on 1/13/24.
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../CommonServer/ipc/IpcChannels.hpp"
+#include "../CommonServer/ipc/SharedMemoryRing.hpp"
+#include "../CommonServer/telemetry/LatencyHistogram.hpp"
+#include "../MessageObjects/strategies/ExecutionReport.hpp"
+#include "../MessageObjects/strategies/OrderRequest.hpp"
+
+using namespace BeaconTech;
+
+namespace
+{
+    constexpr std::size_t RING_SIZE = 1024;
+    constexpr std::uint64_t MAX_WARMUP_ITERATIONS = 10000;
+
+    // Echoes every request back as a report until the final request arrives
+    void echo(const std::string& requestName, const std::string& reportName, std::uint64_t iterations)
+    {
+        Common::SharedMemoryRing<Strategies::OrderRequest> requests{requestName, RING_SIZE};
+        Common::SharedMemoryRing<Strategies::ExecutionReport> reports{reportName, RING_SIZE};
+
+        Strategies::OrderRequest request{};
+        for (std::uint64_t i = 0; i < iterations; ++i)
+        {
+            while (!requests.tryConsume(request)) {}
+
+            Strategies::ExecutionReport report{};
+            report.requestId = request.requestId;
+            report.sendNanos = request.sendNanos;
+            report.instrumentId = request.instrumentId;
+            while (!reports.tryPublish(report)) {}
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::uint64_t warmup = std::min(MAX_WARMUP_ITERATIONS, iterations / 10);
+    const std::uint64_t total = warmup + iterations;
+
+    // Unique names so that concurrent runs and the live system never share a ring
+    const std::string suffix = std::to_string(getpid());
+    const std::string requestName = "/beacontech-bench-requests-" + suffix;
+    const std::string reportName = "/beacontech-bench-reports-" + suffix;
+
+    Common::SharedMemoryRing<Strategies::OrderRequest> requests{requestName, RING_SIZE};
+    Common::SharedMemoryRing<Strategies::ExecutionReport> reports{reportName, RING_SIZE};
+
+    pid_t child = fork();
+    if (child < 0)
+    {
+        std::cerr << "Unable to fork the echo process" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (child == 0)
+    {
+        echo(requestName, reportName, total);
+        _exit(EXIT_SUCCESS);
+    }
+
+    Common::LatencyHistogram histogram;
+    Strategies::ExecutionReport report{};
+
+    for (std::uint64_t i = 0; i < total; ++i)
+    {
+        Strategies::OrderRequest request{};
+        request.requestId = i;
+        request.sendNanos = Common::IpcChannels::now();
+        while (!requests.tryPublish(request)) {}
+
+        while (!reports.tryConsume(report)) {}
+        const std::int64_t roundTrip = Common::IpcChannels::now() - report.sendNanos;
+
+        if (i >= warmup) histogram.record(static_cast<std::uint64_t>(roundTrip / 2));
+    }
+
+    waitpid(child, nullptr, 0);
+    Common::SharedMemoryRing<Strategies::OrderRequest>::unlink(requestName);
+    Common::SharedMemoryRing<Strategies::ExecutionReport>::unlink(reportName);
+
+    std::cout << "One-way latency over " << histogram.getCount() << " round trips (ns):"
+              << " p50=" << histogram.percentile(50.0)
+              << " p99=" << histogram.percentile(99.0)
+              << " p99.9=" << histogram.percentile(99.9)
+              << " max=" << histogram.getMax() << std::endl;
+
+    return EXIT_SUCCESS;
+}
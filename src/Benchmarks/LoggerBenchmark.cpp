@@ -0,0 +1,80 @@
+//
+// Measures the cost of a log call on the calling thread. The calls are made in bursts with a pause
+// between them so the flush thread keeps up and no records are dropped, which would flatter the result.
+//
+// Usage: LoggerBenchmark [iterations]
+//
+// Created by Michael Lewis on 1/14/24.
+//
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "../CommonServer/logging/Logger.hpp"
+#include "../CommonServer/logging/LoggerManager.hpp"
+#include "../CommonServer/telemetry/LatencyHistogram.hpp"
+
+using namespace BeaconTech;
+
+namespace
+{
+    constexpr std::uint64_t BURST_SIZE = 256;
+    const std::string CLASS = "LoggerBenchmark";
+
+    std::int64_t now() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    template<typename LogCall>
+    void run(const std::string& name, std::uint64_t iterations, LogCall&& logCall)
+    {
+        Common::LatencyHistogram histogram;
+
+        for (std::uint64_t i = 0; i < iterations; ++i)
+        {
+            const std::int64_t start = now();
+            logCall(i);
+            histogram.record(static_cast<std::uint64_t>(now() - start));
+
+            if (i % BURST_SIZE == BURST_SIZE - 1) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        std::cout << name << " (ns): mean=" << histogram.getMean()
+                  << " p50=" << histogram.percentile(50.0)
+                  << " p99=" << histogram.percentile(99.0)
+                  << " p99.9=" << histogram.percentile(99.9)
+                  << " max=" << histogram.getMax() << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    const std::string directory = std::filesystem::temp_directory_path().string() + "/beacontech-logger-benchmark";
+
+    {
+        Common::Logger logger{directory, "BENCHMARK", 0};
+
+        run("No arguments", iterations, [&logger](std::uint64_t) {
+            logger.logInfo(CLASS, "run", "Processed a book update for the instrument");
+        });
+
+        run("Six arguments", iterations, [&logger](std::uint64_t i) {
+            logger.logInfo(CLASS, "run", "InstrumentId=% bestBid=$% x % bestAsk=$% x % fairPrice=$%",
+                           static_cast<std::uint32_t>(i), 101.25, 12U, 101.5, 7U, 101.375);
+        });
+    }
+
+    // The sink keeps the log file open and may still be flushing it until the manager shuts down
+    Common::LoggerManager::getInstance().shutdown();
+    std::filesystem::remove_all(directory);
+
+    return EXIT_SUCCESS;
+}
@@ -34,6 +34,15 @@ namespace BeaconTech::Common
         trade.side;
         trade.size;
     };
+
+    // Concept to enforce compile-time validation of the idle strategy used by consumer threads
+    template<typename T>
+    concept IdleStrategy = requires(T idleStrategy, bool (*hasWork)())
+    {
+        idleStrategy.idle(hasWork);
+        idleStrategy.reset();
+        idleStrategy.wake();
+    };
 } // namespace BeaconTech::Common
 
 #endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_BTCONCEPTS_HPP
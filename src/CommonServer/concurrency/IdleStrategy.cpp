@@ -0,0 +1,129 @@
+//
+// Idle strategies decide what a consumer thread does when it polls its queue and finds no work.
+// Each strategy trades wake-up latency for CPU usage:
+//
+// 1) BUSY_SPIN  - Spins on the queue with the pause instruction. Lowest latency, burns a full core.
+// 2) SPIN_YIELD - Spins for a bounded number of polls and then yields the core to the scheduler.
+// 3) BACKOFF    - Spins, yields and then sleeps with an exponentially increasing duration.
+// 4) PARK       - Spins for a bounded number of polls and then parks on a futex. The producer only
+//                 issues the wake-up syscall when the consumer is actually parked.
+//
+// Created by Michael Lewis on 1/6/24.
+//
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <string>
+
+#if defined(__linux__)
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "IdleStrategy.hpp"
+#include "../utils/ConfigManager.hpp"
+
+namespace BeaconTech::Common
+{
+    // Converts the config value into an IdleStrategyType. Unknown values default to BUSY_SPIN,
+    // which matches the behavior of the processors before idle strategies were introduced
+    IdleStrategyType idleStrategyTypeFromString(const std::string& name) noexcept
+    {
+        std::string upper{name};
+        std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) { return std::toupper(c); });
+
+        if (upper == "SPIN_YIELD") return IdleStrategyType::SPIN_YIELD;
+        if (upper == "BACKOFF") return IdleStrategyType::BACKOFF;
+        if (upper == "PARK") return IdleStrategyType::PARK;
+
+        return IdleStrategyType::BUSY_SPIN;
+    }
+
+    SpinYieldIdleStrategy::SpinYieldIdleStrategy() : maxSpins{1'000}, spins{0}
+    {
+
+    }
+
+    SpinYieldIdleStrategy::SpinYieldIdleStrategy(const std::string& role)
+        : maxSpins{ConfigManager::roleIntConfigValueDefaultIfNull(role, "idleMaxSpins", 1'000)}, spins{0}
+    {
+
+    }
+
+    BackoffIdleStrategy::BackoffIdleStrategy()
+        : maxSpins{1'000}, maxYields{100}, minSleep{1}, maxSleep{1'000},
+          spins{0}, yields{0}, sleep{minSleep}
+    {
+
+    }
+
+    BackoffIdleStrategy::BackoffIdleStrategy(const std::string& role)
+        : maxSpins{ConfigManager::roleIntConfigValueDefaultIfNull(role, "idleMaxSpins", 1'000)},
+          maxYields{ConfigManager::roleIntConfigValueDefaultIfNull(role, "idleMaxYields", 100)},
+          minSleep{ConfigManager::roleIntConfigValueDefaultIfNull(role, "idleMinSleepMicros", 1)},
+          maxSleep{ConfigManager::roleIntConfigValueDefaultIfNull(role, "idleMaxSleepMicros", 1'000)},
+          spins{0}, yields{0}, sleep{minSleep}
+    {
+
+    }
+
+    ParkingIdleStrategy::ParkingIdleStrategy() : maxSpins{1'000}, maxPark{100'000}, spins{0}, state{RUNNING}
+    {
+
+    }
+
+    ParkingIdleStrategy::ParkingIdleStrategy(const std::string& role)
+        : maxSpins{ConfigManager::roleIntConfigValueDefaultIfNull(role, "idleMaxSpins", 1'000)},
+          maxPark{ConfigManager::roleIntConfigValueDefaultIfNull(role, "idleMaxParkMicros", 100'000)},
+          spins{0}, state{RUNNING}
+    {
+
+    }
+
+    // Blocks the consumer until the producer wakes it or maxPark elapses. The timeout is a safety net
+    // that bounds how long a missed wake-up could delay the consumer and lets it observe shutdown.
+    void ParkingIdleStrategy::park() noexcept
+    {
+#if defined(__linux__)
+        static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+
+        auto seconds = std::chrono::duration_cast<std::chrono::seconds>(maxPark);
+        auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(maxPark - seconds);
+        timespec timeout{static_cast<time_t>(seconds.count()), static_cast<long>(nanos.count())};
+
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&state), FUTEX_WAIT_PRIVATE, PARKED, &timeout, nullptr, 0);
+#else
+        state.wait(PARKED);
+#endif
+    }
+
+    void ParkingIdleStrategy::unpark() noexcept
+    {
+        state.store(RUNNING);
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+        state.notify_one();
+#endif
+    }
+
+    ConfiguredIdleStrategy::ConfiguredIdleStrategy() : type{IdleStrategyType::BUSY_SPIN}
+    {
+
+    }
+
+    ConfiguredIdleStrategy::ConfiguredIdleStrategy(const std::string& role)
+        : type{idleStrategyTypeFromString(ConfigManager::roleConfigValueDefaultIfNull(role, "idleStrategy", "BUSY_SPIN"))},
+          busySpin{role}, spinYield{role}, backoff{role}, parking{role}
+    {
+
+    }
+
+    IdleStrategyType ConfiguredIdleStrategy::getType() const noexcept
+    {
+        return type;
+    }
+} // namespace BeaconTech::Common
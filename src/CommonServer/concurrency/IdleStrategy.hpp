@@ -0,0 +1,268 @@
+//
+// Idle strategies decide what a consumer thread does when it polls its queue and finds no work.
+// Each strategy trades wake-up latency for CPU usage:
+//
+// 1) BUSY_SPIN  - Spins on the queue with the pause instruction. Lowest latency, burns a full core.
+// 2) SPIN_YIELD - Spins for a bounded number of polls and then yields the core to the scheduler.
+// 3) BACKOFF    - Spins, yields and then sleeps with an exponentially increasing duration.
+// 4) PARK       - Spins for a bounded number of polls and then parks on a futex. The producer only
+//                 issues the wake-up syscall when the consumer is actually parked.
+//
+// The strategy is a template parameter of the processors so the idle path is inlined into the event
+// loop. The ConfiguredIdleStrategy selects one of the above at runtime from config.json using the role
+// of the owning thread (e.g. engine-0.idleStrategy), falling back to the global idleStrategy key.
+//
+// Created by Michael Lewis on 1/6/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_IDLESTRATEGY_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_IDLESTRATEGY_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace BeaconTech::Common
+{
+    // Hints to the CPU that the thread is in a spin-wait loop. Reduces power and avoids the
+    // memory order violation penalty when the loop exits.
+    inline void cpuRelax() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+#endif
+    }
+
+    enum class IdleStrategyType : std::int8_t
+    {
+        BUSY_SPIN = 0,
+        SPIN_YIELD = 1,
+        BACKOFF = 2,
+        PARK = 3
+    };
+
+    IdleStrategyType idleStrategyTypeFromString(const std::string& name) noexcept;
+
+    class BusySpinIdleStrategy
+    {
+    public:
+        BusySpinIdleStrategy() = default;
+
+        explicit BusySpinIdleStrategy(const std::string&) {}
+
+        template<typename HasWork>
+        inline void idle(const HasWork&) noexcept { cpuRelax(); }
+
+        inline void reset() noexcept {}
+
+        inline void wake() noexcept {}
+    };
+
+    class SpinYieldIdleStrategy
+    {
+    private:
+        std::uint32_t maxSpins;
+        std::uint32_t spins;
+
+    public:
+        SpinYieldIdleStrategy();
+
+        explicit SpinYieldIdleStrategy(const std::string& role);
+
+        template<typename HasWork>
+        inline void idle(const HasWork&) noexcept
+        {
+            if (spins < maxSpins) [[likely]]
+            {
+                ++spins;
+                cpuRelax();
+                return;
+            }
+
+            std::this_thread::yield();
+        }
+
+        inline void reset() noexcept { spins = 0; }
+
+        inline void wake() noexcept {}
+    };
+
+    class BackoffIdleStrategy
+    {
+    private:
+        std::uint32_t maxSpins;
+        std::uint32_t maxYields;
+        std::chrono::microseconds minSleep;
+        std::chrono::microseconds maxSleep;
+
+        std::uint32_t spins;
+        std::uint32_t yields;
+        std::chrono::microseconds sleep;
+
+    public:
+        BackoffIdleStrategy();
+
+        explicit BackoffIdleStrategy(const std::string& role);
+
+        template<typename HasWork>
+        inline void idle(const HasWork&) noexcept
+        {
+            if (spins < maxSpins) [[likely]]
+            {
+                ++spins;
+                cpuRelax();
+            }
+            else if (yields < maxYields)
+            {
+                ++yields;
+                std::this_thread::yield();
+            }
+            else
+            {
+                std::this_thread::sleep_for(sleep);
+                sleep = std::min(sleep * 2, maxSleep);
+            }
+        }
+
+        inline void reset() noexcept
+        {
+            spins = 0;
+            yields = 0;
+            sleep = minSleep;
+        }
+
+        inline void wake() noexcept {}
+    };
+
+    class ParkingIdleStrategy
+    {
+    private:
+        static constexpr std::uint32_t RUNNING = 0;
+        static constexpr std::uint32_t PARKED = 1;
+
+        std::uint32_t maxSpins;
+        std::chrono::microseconds maxPark;
+        std::uint32_t spins;
+
+        // Written by the consumer and read by the producer, so it lives on its own cache line
+        alignas(64) std::atomic<std::uint32_t> state;
+
+        void park() noexcept;
+
+        void unpark() noexcept;
+
+    public:
+        ParkingIdleStrategy();
+
+        explicit ParkingIdleStrategy(const std::string& role);
+
+        // Publishing PARKED and then re-checking the queue pairs with the producer publishing work and then
+        // checking for PARKED (both sequentially consistent), so one side always observes the other
+        template<typename HasWork>
+        inline void idle(const HasWork& hasWork) noexcept
+        {
+            if (spins < maxSpins) [[likely]]
+            {
+                ++spins;
+                cpuRelax();
+                return;
+            }
+
+            state.store(PARKED);
+            if (!hasWork()) park();
+            state.store(RUNNING, std::memory_order_relaxed);
+        }
+
+        inline void reset() noexcept { spins = 0; }
+
+        // Called by the producer after publishing work. Only enters the kernel when the consumer is parked.
+        inline void wake() noexcept
+        {
+            if (state.load() == PARKED) [[unlikely]] unpark();
+        }
+
+        // Deleted default ctors and assignment operators
+        ParkingIdleStrategy(const ParkingIdleStrategy& other) = delete;
+
+        ParkingIdleStrategy& operator=(const ParkingIdleStrategy& other) = delete;
+    };
+
+    // Selects the idle strategy at runtime from config.json. The dispatch only runs on the idle path,
+    // so the cost of the switch is never paid while there is work in the queue.
+    class ConfiguredIdleStrategy
+    {
+    private:
+        IdleStrategyType type;
+        BusySpinIdleStrategy busySpin;
+        SpinYieldIdleStrategy spinYield;
+        BackoffIdleStrategy backoff;
+        ParkingIdleStrategy parking;
+
+    public:
+        ConfiguredIdleStrategy();
+
+        explicit ConfiguredIdleStrategy(const std::string& role);
+
+        template<typename HasWork>
+        inline void idle(const HasWork& hasWork) noexcept
+        {
+            switch (type)
+            {
+                case IdleStrategyType::BUSY_SPIN:
+                    busySpin.idle(hasWork);
+                    break;
+                case IdleStrategyType::SPIN_YIELD:
+                    spinYield.idle(hasWork);
+                    break;
+                case IdleStrategyType::BACKOFF:
+                    backoff.idle(hasWork);
+                    break;
+                case IdleStrategyType::PARK:
+                    parking.idle(hasWork);
+                    break;
+            }
+        }
+
+        inline void reset() noexcept
+        {
+            switch (type)
+            {
+                case IdleStrategyType::BUSY_SPIN:
+                    break;
+                case IdleStrategyType::SPIN_YIELD:
+                    spinYield.reset();
+                    break;
+                case IdleStrategyType::BACKOFF:
+                    backoff.reset();
+                    break;
+                case IdleStrategyType::PARK:
+                    parking.reset();
+                    break;
+            }
+        }
+
+        inline void wake() noexcept
+        {
+            if (type == IdleStrategyType::PARK) parking.wake();
+        }
+
+        IdleStrategyType getType() const noexcept;
+
+        // Deleted default ctors and assignment operators
+        ConfiguredIdleStrategy(const ConfiguredIdleStrategy& other) = delete;
+
+        ConfiguredIdleStrategy& operator=(const ConfiguredIdleStrategy& other) = delete;
+    };
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_IDLESTRATEGY_HPP
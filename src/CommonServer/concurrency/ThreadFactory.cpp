@@ -0,0 +1,214 @@
+//
+// Creates every long-lived thread in the system. Each thread is created for a named role
+// (e.g. md-consumer, engine-0, logger-0) and the factory applies the thread topology
+// configured for that role before the thread runs its function:
+//
+// 1) Names the thread so it can be identified in top, perf, gdb, etc.
+// 2) Pins the thread to a set of cores and/or the cores of a NUMA node
+// 3) Prefers memory allocations from the configured NUMA node
+// 4) Optionally runs the thread under the SCHED_FIFO real-time policy
+//
+// Created by Michael Lewis on 1/7/24.
+//
+
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "ThreadFactory.hpp"
+#include "../logging/LogLevel.hpp"
+#include "../utils/ConfigManager.hpp"
+
+namespace BeaconTech::Common
+{
+    namespace
+    {
+        // Strips the trailing -N index from a role (e.g. engine-3 -> engine). Returns an empty group
+        // when the role has no index so that unscoped keys are never used for topology
+        std::string roleGroup(const std::string& role)
+        {
+            auto dash = role.find_last_of('-');
+            if (dash == std::string::npos || dash + 1 == role.size()) return "";
+
+            for (auto i = dash + 1; i < role.size(); ++i)
+            {
+                if (!std::isdigit(static_cast<unsigned char>(role[i]))) return "";
+            }
+
+            return role.substr(0, dash);
+        }
+
+        // Reads a role scoped config and falls back to the role group
+        std::string topologyConfig(const std::string& role, const std::string& configName)
+        {
+            const std::string group = roleGroup(role);
+            const std::string groupValue = group.empty()
+                    ? "" : ConfigManager::stringConfigValueDefaultIfNull(group + "." + configName, "");
+
+            return ConfigManager::stringConfigValueDefaultIfNull(role + "." + configName, groupValue);
+        }
+    }
+
+    // Resolves the topology of a role from config.json
+    ThreadTopology ThreadTopology::fromConfig(const std::string& role)
+    {
+        ThreadTopology topology;
+        topology.role = role;
+
+        try
+        {
+            topology.cpus = ThreadFactory::parseCpuList(topologyConfig(role, "cpus"));
+
+            const std::string numaNode = topologyConfig(role, "numaNode");
+            if (!numaNode.empty()) topology.numaNode = std::stoi(numaNode);
+
+            const std::string fifoPriority = topologyConfig(role, "fifoPriority");
+            if (!fifoPriority.empty()) topology.fifoPriority = std::stoi(fifoPriority);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << Common::LogLevel::WARN.getDesc()
+                      << " : Invalid thread topology for " << role << " - " << e.what() << std::endl;
+        }
+
+        return topology;
+    }
+
+    // Thread names are limited to 15 characters on Linux. Long roles keep their -N suffix
+    // so that threads of the same group remain distinguishable (e.g. engine-listene-1)
+    std::string ThreadFactory::threadName(const std::string& role)
+    {
+        constexpr std::size_t MAX_NAME_LENGTH = 15;
+        if (role.size() <= MAX_NAME_LENGTH) return role;
+
+        auto dash = role.find_last_of('-');
+        std::string suffix = dash == std::string::npos ? "" : role.substr(dash);
+        if (suffix.size() >= MAX_NAME_LENGTH) return role.substr(0, MAX_NAME_LENGTH);
+
+        return role.substr(0, MAX_NAME_LENGTH - suffix.size()) + suffix;
+    }
+
+    // Parses a Linux style cpu list (e.g. "0,2,4-7")
+    std::vector<int> ThreadFactory::parseCpuList(const std::string& cpuList)
+    {
+        std::vector<int> cpus;
+        std::stringstream ss{cpuList};
+        std::string range;
+
+        while (std::getline(ss, range, ','))
+        {
+            if (range.empty()) continue;
+
+            auto dash = range.find('-');
+            if (dash == std::string::npos)
+            {
+                cpus.push_back(std::stoi(range));
+                continue;
+            }
+
+            int first = std::stoi(range.substr(0, dash));
+            int last = std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        }
+
+        return cpus;
+    }
+
+    // Reads the cores that belong to a NUMA node from sysfs
+    std::vector<int> ThreadFactory::numaNodeCpus(int numaNode)
+    {
+        std::ifstream file{"/sys/devices/system/node/node" + std::to_string(numaNode) + "/cpulist"};
+        std::string cpuList;
+        std::getline(file, cpuList);
+
+        return parseCpuList(cpuList);
+    }
+
+    // Applies the topology to the calling thread. Failures are reported but never prevent the thread
+    // from running because a misconfigured topology should degrade latency, not availability.
+    bool ThreadFactory::applyTopology(const ThreadTopology& topology) noexcept
+    {
+        bool applied = true;
+        const std::string name = threadName(topology.role);
+
+        try
+        {
+#if defined(__linux__)
+            pthread_setname_np(pthread_self(), name.c_str());
+
+            std::vector<int> cpus = topology.cpus;
+            if (cpus.empty() && topology.numaNode >= 0) cpus = numaNodeCpus(topology.numaNode);
+
+            if (!cpus.empty())
+            {
+                cpu_set_t cpuSet;
+                CPU_ZERO(&cpuSet);
+                for (int cpu : cpus) CPU_SET(cpu, &cpuSet);
+
+                if (int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet); error != 0)
+                {
+                    std::cerr << Common::LogLevel::WARN.getDesc() << " : Unable to pin " << name
+                              << " - " << std::strerror(error) << std::endl;
+                    applied = false;
+                }
+            }
+
+            constexpr int MAX_NUMA_NODES = static_cast<int>(sizeof(unsigned long) * 8);
+            if (topology.numaNode >= MAX_NUMA_NODES)
+            {
+                std::cerr << Common::LogLevel::WARN.getDesc() << " : NUMA node " << topology.numaNode
+                          << " of " << name << " is out of range, memory policy not set" << std::endl;
+                applied = false;
+            }
+            else if (topology.numaNode >= 0)
+            {
+                unsigned long nodeMask = 1UL << topology.numaNode;
+                if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, &nodeMask, sizeof(nodeMask) * 8) != 0)
+                {
+                    std::cerr << Common::LogLevel::WARN.getDesc() << " : Unable to set NUMA memory policy for "
+                              << name << " - " << std::strerror(errno) << std::endl;
+                    applied = false;
+                }
+            }
+#elif defined(__APPLE__)
+            // macOS only supports naming the calling thread and has no API for hard core affinity
+            pthread_setname_np(name.c_str());
+#endif
+
+            if (topology.fifoPriority > 0)
+            {
+                sched_param param{};
+                param.sched_priority = topology.fifoPriority;
+
+                if (int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param); error != 0)
+                {
+                    std::cerr << Common::LogLevel::WARN.getDesc() << " : Unable to set SCHED_FIFO for "
+                              << name << " - " << std::strerror(error) << std::endl;
+                    applied = false;
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << Common::LogLevel::WARN.getDesc()
+                      << " : Unable to apply thread topology for " << name << " - " << e.what() << std::endl;
+            applied = false;
+        }
+
+        return applied;
+    }
+} // namespace BeaconTech::Common
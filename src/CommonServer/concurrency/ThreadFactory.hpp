@@ -0,0 +1,75 @@
+//
+// Creates every long-lived thread in the system. Each thread is created for a named role
+// (e.g. md-consumer, engine-0, logger-0) and the factory applies the thread topology
+// configured for that role before the thread runs its function:
+//
+// 1) Names the thread so it can be identified in top, perf, gdb, etc.
+// 2) Pins the thread to a set of cores and/or the cores of a NUMA node
+// 3) Prefers memory allocations from the configured NUMA node
+// 4) Optionally runs the thread under the SCHED_FIFO real-time policy
+//
+// Topologies are read from config.json using role scoped keys, which fall back to the role group
+// (the role without its trailing -N index) so that all engines can share a policy:
+//
+//   "engine-0.cpus": "2,3"      "engine.numaNode": "0"      "engine.fifoPriority": "80"
+//   "md-consumer.cpus": "1"     "logger.cpus": "6-7"
+//
+// Created by Michael Lewis on 1/7/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_THREADFACTORY_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_THREADFACTORY_HPP
+
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace BeaconTech::Common
+{
+
+    struct ThreadTopology
+    {
+        std::string role;
+        std::vector<int> cpus;   // Empty means the thread may run on any core
+        int numaNode = -1;       // -1 means no NUMA preference
+        int fifoPriority = 0;    // 0 means the default scheduling policy
+
+        static ThreadTopology fromConfig(const std::string& role);
+    };
+
+    class ThreadFactory
+    {
+    private:
+        static std::string threadName(const std::string& role);
+
+        static std::vector<int> parseCpuList(const std::string& cpuList);
+
+        static std::vector<int> numaNodeCpus(int numaNode);
+
+        friend struct ThreadTopology;
+
+    public:
+        // Creates a thread for the role. The topology is resolved on the calling thread and applied
+        // by the new thread to itself before it invokes the function.
+        template<typename Function, typename... Args>
+        static std::thread createThread(const std::string& role, Function&& function, Args&&... args)
+        {
+            return std::thread([topology = ThreadTopology::fromConfig(role),
+                                function = std::forward<Function>(function),
+                                ...args = std::forward<Args>(args)]() mutable {
+                applyTopology(topology);
+                std::invoke(std::move(function), std::move(args)...);
+            });
+        }
+
+        static bool applyTopology(const ThreadTopology& topology) noexcept;
+
+        // Deleted default ctors and assignment operators
+        ThreadFactory() = delete;
+    };
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_THREADFACTORY_HPP
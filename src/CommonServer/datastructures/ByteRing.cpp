@@ -0,0 +1,108 @@
+//
+// A single producer, single consumer ring buffer of variable length records.
+//
+// Created by Michael Lewis on 1/14/24.
+//
+
+#include <algorithm>
+#include <bit>
+
+#include "ByteRing.hpp"
+
+namespace BeaconTech::Common
+{
+    // The capacity is rounded up to a power of two so offsets can be calculated with a mask
+    ByteRing::ByteRing(const std::string& name, std::size_t capacity)
+        : buffer(std::bit_ceil(std::max(capacity, 2 * ALIGNMENT)), HugePageAllocator<std::byte>{name}),
+          mask{buffer.size() - 1}, writePosition{0}, readPosition{0}, claimPosition{0}, cachedReadPosition{0},
+          nextReadPosition{0}
+    {
+
+    }
+
+    ByteRing::RecordHeader* ByteRing::headerAt(std::uint64_t position) noexcept
+    {
+        return reinterpret_cast<RecordHeader*>(buffer.data() + (position & mask));
+    }
+
+    // Claims a contiguous region of at least bytes for the next record. Returns nullptr if the ring does
+    // not have room for the record, in which case nothing is claimed. Must be followed by publish()
+    // before the next claim
+    std::byte* ByteRing::claim(std::size_t bytes) noexcept
+    {
+        if (bytes > maxRecordSize()) [[unlikely]] return nullptr;
+
+        const std::uint64_t recordSize = aligned(HEADER_SIZE + bytes);
+        const std::uint64_t start = writePosition.load(std::memory_order_relaxed);
+        const std::uint64_t remaining = buffer.size() - (start & mask);
+        const std::uint64_t wrapSize = remaining < recordSize ? remaining : 0;
+
+        if (start + wrapSize + recordSize - cachedReadPosition > buffer.size())
+        {
+            cachedReadPosition = readPosition.load(std::memory_order_acquire);
+            if (start + wrapSize + recordSize - cachedReadPosition > buffer.size()) return nullptr;
+        }
+
+        // Fill the end of the buffer so the record starts at the beginning
+        if (wrapSize) *headerAt(start) = RecordHeader{static_cast<std::uint32_t>(wrapSize), 1};
+
+        const std::uint64_t recordStart = start + wrapSize;
+        *headerAt(recordStart) = RecordHeader{static_cast<std::uint32_t>(bytes), 0};
+        claimPosition = recordStart + recordSize;
+
+        return buffer.data() + (recordStart & mask) + HEADER_SIZE;
+    }
+
+    // Makes the claimed record (and any padding before it) visible to the consumer
+    void ByteRing::publish() noexcept
+    {
+        writePosition.store(claimPosition, std::memory_order_release);
+    }
+
+    // Returns the next published record or an empty span if there is none. The record remains valid
+    // until release() is called
+    std::span<const std::byte> ByteRing::read() noexcept
+    {
+        std::uint64_t position = readPosition.load(std::memory_order_relaxed);
+        const std::uint64_t end = writePosition.load(std::memory_order_acquire);
+
+        while (position != end)
+        {
+            const RecordHeader* header = headerAt(position);
+            if (header->padding)
+            {
+                position += header->bytes;
+                continue;
+            }
+
+            nextReadPosition = position + aligned(HEADER_SIZE + header->bytes);
+            return {reinterpret_cast<const std::byte*>(header) + HEADER_SIZE, header->bytes};
+        }
+
+        return {};
+    }
+
+    // Returns the space of the record returned by read() to the producer
+    void ByteRing::release() noexcept
+    {
+        readPosition.store(nextReadPosition, std::memory_order_release);
+    }
+
+    // The number of bytes waiting to be consumed, including headers and padding
+    std::size_t ByteRing::size() const noexcept
+    {
+        return writePosition.load(std::memory_order_acquire) - readPosition.load(std::memory_order_acquire);
+    }
+
+    std::size_t ByteRing::capacity() const noexcept
+    {
+        return buffer.size();
+    }
+
+    // Records are limited to half the ring so that a record always fits once the ring has drained,
+    // wherever the write position is
+    std::size_t ByteRing::maxRecordSize() const noexcept
+    {
+        return buffer.size() / 2 - HEADER_SIZE;
+    }
+} // namespace BeaconTech::Common
@@ -0,0 +1,100 @@
+//
+// A single producer, single consumer ring buffer of variable length records.
+//
+// The producer claims a contiguous region for a record, writes the record in place and publishes it
+// with a single store, so a record of any size costs one index update rather than one per element.
+// Records never wrap around the end of the buffer: when a record does not fit in the space left before
+// the end, that space is filled with a padding record the consumer skips over.
+//
+// Every record is prefixed with an 8 byte header and padded to a multiple of 8 bytes so that headers
+// are always aligned. The buffer is allocated up front from pre-faulted (and where possible huge page)
+// memory (see MemoryProvider.hpp).
+//
+// NOTE - Ctors and assignment operators have been deleted to ensure these functions aren't
+// unintentionally used by clients.
+//
+// Created by Michael Lewis on 1/14/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_BYTERING_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_BYTERING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../memory/HugePageAllocator.hpp"
+
+namespace BeaconTech::Common
+{
+
+    class ByteRing final
+    {
+    private:
+        struct RecordHeader
+        {
+            std::uint32_t bytes;    // Size of the record excluding the header and alignment
+            std::uint32_t padding;  // Non-zero for the padding record that fills the end of the buffer
+        };
+
+        static constexpr std::size_t ALIGNMENT = 8;
+        static constexpr std::size_t HEADER_SIZE = sizeof(RecordHeader);
+
+        std::vector<std::byte, HugePageAllocator<std::byte>> buffer;
+        std::uint64_t mask;
+
+        // Positions are byte offsets that only ever increase. The offset into the buffer is position & mask
+        alignas(64) std::atomic<std::uint64_t> writePosition;  // End of the last published record
+        alignas(64) std::atomic<std::uint64_t> readPosition;   // End of the last released record
+
+        // Producer only state
+        alignas(64) std::uint64_t claimPosition;                // End of the claimed record
+        std::uint64_t cachedReadPosition;
+
+        // Consumer only state
+        alignas(64) std::uint64_t nextReadPosition;             // End of the record returned by read()
+
+        static constexpr std::size_t aligned(std::size_t bytes) noexcept
+        {
+            return (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        }
+
+        RecordHeader* headerAt(std::uint64_t position) noexcept;
+
+    public:
+        ByteRing(const std::string& name, std::size_t capacity);
+
+        ~ByteRing() = default;
+
+        std::byte* claim(std::size_t bytes) noexcept;
+
+        void publish() noexcept;
+
+        std::span<const std::byte> read() noexcept;
+
+        void release() noexcept;
+
+        std::size_t size() const noexcept;
+
+        std::size_t capacity() const noexcept;
+
+        std::size_t maxRecordSize() const noexcept;
+
+        // Deleted default ctors and assignment operators
+        ByteRing() = delete;
+
+        ByteRing(const ByteRing& other) = delete;
+
+        ByteRing(ByteRing&& other) = delete;
+
+        ByteRing& operator=(const ByteRing& other) = delete;
+
+        ByteRing& operator=(ByteRing&& other) = delete;
+    };
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_BYTERING_HPP
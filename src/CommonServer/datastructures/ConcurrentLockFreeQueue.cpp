@@ -22,13 +22,20 @@
 
 namespace BeaconTech::Common
 {
-    // Pre-allocates the size of the CLFQueue with numElements and default initializes the write and read indices
     template<typename T>
-    ConcurrentLockFreeQueue<T>::ConcurrentLockFreeQueue()
-        : nextWriteIndex{0}, nextReadIndex{0}, numElements{0}
+    ConcurrentLockFreeQueue<T>::ConcurrentLockFreeQueue() : ConcurrentLockFreeQueue{"CLFQ"}
     {
-        size_t size = Common::ConfigManager::intConfigValueDefaultIfNull("CLFQSize", 4096);
-        CLFQueue = std::vector<T>{size};
+
+    }
+
+    // Pre-allocates the size of the CLFQueue with numElements and default initializes the write and read indices.
+    // The name identifies the queue in the memory report
+    template<typename T>
+    ConcurrentLockFreeQueue<T>::ConcurrentLockFreeQueue(const std::string& name)
+        : CLFQueue(Common::ConfigManager::config().CLFQSize, HugePageAllocator<T>{name}),
+          nextWriteIndex{0}, nextReadIndex{0}, numElements{0}
+    {
+
     }
 
     template<typename T>
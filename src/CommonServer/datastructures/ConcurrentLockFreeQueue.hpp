@@ -7,6 +7,9 @@
 // The circular FIFO nature of the ring buffer acts as a pipeline for packets to be
 // deterministically written and consumed. Consumption occurs in the engine thread.
 //
+// The slots are allocated up front from pre-faulted (and where possible huge page) memory so the
+// producer and consumer never take a page fault on the critical path (see MemoryProvider.hpp).
+//
 // NOTE 1 - A Multiple Producer Multiple Consumer lock free queue will be released in a future version
 // NOTE 2 - Ctors and assignment operators have been deleted to ensure these functions aren't
 // unintentionally used by clients.
@@ -19,8 +22,11 @@
 
 #include <atomic>
 #include <functional>
+#include <string>
 #include <vector>
 
+#include "../memory/HugePageAllocator.hpp"
+
 namespace BeaconTech::Common
 {
 
@@ -28,7 +34,7 @@ namespace BeaconTech::Common
     class ConcurrentLockFreeQueue final
     {
     private:
-        std::vector<T> CLFQueue;
+        std::vector<T, HugePageAllocator<T>> CLFQueue;
         std::atomic<size_t> nextWriteIndex;  // Index where the next element will be written to
         std::atomic<size_t> nextReadIndex;   // Index where the next element to be read can be found
         std::atomic<size_t> numElements;
@@ -36,6 +42,8 @@ namespace BeaconTech::Common
     public:
         ConcurrentLockFreeQueue();
 
+        explicit ConcurrentLockFreeQueue(const std::string& name);
+
         ConcurrentLockFreeQueue(ConcurrentLockFreeQueue<T>&& source) noexcept;
 
         ConcurrentLockFreeQueue<T>& operator=(ConcurrentLockFreeQueue<T>&& source) noexcept;
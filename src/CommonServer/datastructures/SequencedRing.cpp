@@ -0,0 +1,153 @@
+//
+// A single producer, multiple consumer sequenced ring buffer modelled on the LMAX Disruptor.
+//
+// The producer claims the next sequence, writes the event in place and publishes the sequence. Each
+// consumer tracks its own sequence and reads events in place, so every consumer sees every event and
+// the event is only ever copied once (into the ring by the producer).
+//
+// Created by Michael Lewis on 1/11/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_SEQUENCEDRING_CPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_SEQUENCEDRING_CPP
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <stdexcept>
+
+#include "SequencedRing.hpp"
+#include "../concurrency/IdleStrategy.hpp"
+
+namespace BeaconTech::Common
+{
+    // The capacity is rounded up to a power of two so a sequence maps to a slot with a mask.
+    // The name identifies the ring in the memory report
+    template<typename T>
+    SequencedRing<T>::SequencedRing(const std::string& name, std::size_t capacity)
+        : ring(std::bit_ceil(std::max<std::size_t>(capacity, 2)), HugePageAllocator<T>{name}),
+          mask{static_cast<std::int64_t>(ring.size()) - 1},
+          nextSequence{Sequence::INITIAL}, cachedMinimumSequence{Sequence::INITIAL}
+    {
+
+    }
+
+    // Registers a consumer that is gated on the producer and on the consumers it depends on.
+    // Consumers must be added before the first event is published
+    template<typename T>
+    std::size_t SequencedRing<T>::addConsumer(const std::vector<std::size_t>& dependsOn)
+    {
+        for (std::size_t dependency : dependsOn)
+        {
+            if (dependency >= consumers.size()) throw std::invalid_argument("SequencedRing dependency does not exist");
+        }
+
+        consumers.emplace_back(std::make_unique<Sequence>());
+        dependencies.emplace_back(dependsOn);
+
+        return consumers.size() - 1;
+    }
+
+    // Claims the next sequence for the producer. Spins while the ring is full, i.e. while the slowest
+    // consumer has not yet released the slot from the previous lap
+    template<typename T>
+    std::int64_t SequencedRing<T>::claim() noexcept
+    {
+        const std::int64_t sequence = ++nextSequence;
+        const std::int64_t wrapPoint = sequence - static_cast<std::int64_t>(ring.size());
+
+        // The cached minimum avoids reading every consumer sequence on each claim
+        while (wrapPoint > cachedMinimumSequence) [[unlikely]]
+        {
+            cachedMinimumSequence = minimumSequence();
+            if (wrapPoint > cachedMinimumSequence) cpuRelax();
+        }
+
+        return sequence;
+    }
+
+    template<typename T>
+    T& SequencedRing<T>::get(std::int64_t sequence) noexcept
+    {
+        return ring[sequence & mask];
+    }
+
+    template<typename T>
+    const T& SequencedRing<T>::get(std::int64_t sequence) const noexcept
+    {
+        return ring[sequence & mask];
+    }
+
+    // Makes the event at the sequence (and every event before it) visible to consumers. The store is
+    // sequentially consistent so that it is ordered before the producer checks whether a parked consumer
+    // needs waking (see ParkingIdleStrategy)
+    template<typename T>
+    void SequencedRing<T>::publish(std::int64_t sequence) noexcept
+    {
+        cursor.value.store(sequence);
+    }
+
+    // Returns the highest sequence the consumer may read, which is bounded by the producer and by every
+    // consumer it depends on
+    template<typename T>
+    std::int64_t SequencedRing<T>::available(std::size_t consumer) const noexcept
+    {
+        std::int64_t sequence = cursor.value.load(std::memory_order_acquire);
+        for (std::size_t dependency : dependencies[consumer])
+        {
+            sequence = std::min(sequence, consumers[dependency]->value.load(std::memory_order_acquire));
+        }
+
+        return sequence;
+    }
+
+    // Releases every slot up to and including the sequence back to the producer and downstream consumers.
+    // Sequentially consistent for the same reason as publish
+    template<typename T>
+    void SequencedRing<T>::release(std::size_t consumer, std::int64_t sequence) noexcept
+    {
+        consumers[consumer]->value.store(sequence);
+    }
+
+    template<typename T>
+    std::int64_t SequencedRing<T>::getCursor() const noexcept
+    {
+        return cursor.value.load(std::memory_order_acquire);
+    }
+
+    template<typename T>
+    std::int64_t SequencedRing<T>::getSequence(std::size_t consumer) const noexcept
+    {
+        return consumers[consumer]->value.load(std::memory_order_acquire);
+    }
+
+    // The sequence released by the slowest consumer. When there are no consumers, the ring never fills
+    template<typename T>
+    std::int64_t SequencedRing<T>::minimumSequence() const noexcept
+    {
+        if (consumers.empty()) return std::numeric_limits<std::int64_t>::max();
+
+        std::int64_t sequence = std::numeric_limits<std::int64_t>::max();
+        for (const auto& consumer : consumers)
+        {
+            sequence = std::min(sequence, consumer->value.load(std::memory_order_acquire));
+        }
+
+        return sequence;
+    }
+
+    template<typename T>
+    std::size_t SequencedRing<T>::capacity() const noexcept
+    {
+        return ring.size();
+    }
+
+    template<typename T>
+    std::size_t SequencedRing<T>::numConsumers() const noexcept
+    {
+        return consumers.size();
+    }
+} // BeaconTech::Common
+
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_SEQUENCEDRING_CPP
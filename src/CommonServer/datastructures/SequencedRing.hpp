@@ -0,0 +1,106 @@
+//
+// A single producer, multiple consumer sequenced ring buffer modelled on the LMAX Disruptor.
+//
+// The producer claims the next sequence, writes the event in place and publishes the sequence. Each
+// consumer tracks its own sequence and reads events in place, so every consumer sees every event and
+// the event is only ever copied once (into the ring by the producer). A consumer may be gated on other
+// consumers (e.g. a logging listener that must only see an event after the strategy has processed it),
+// in which case it never reads past the slowest of its dependencies.
+//
+// The producer never overwrites a slot until every consumer has released it. Slots are reused rather
+// than destroyed, so events that own memory keep their capacity from one lap to the next. The slots are
+// allocated up front from pre-faulted (and where possible huge page) memory (see MemoryProvider.hpp).
+//
+// NOTE - Ctors and assignment operators have been deleted to ensure these functions aren't
+// unintentionally used by clients.
+//
+// Created by Michael Lewis on 1/11/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_SEQUENCEDRING_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_SEQUENCEDRING_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../memory/HugePageAllocator.hpp"
+
+namespace BeaconTech::Common
+{
+    // A sequence on its own cache line so producers and consumers never false share
+    struct alignas(64) Sequence
+    {
+        static constexpr std::int64_t INITIAL = -1;
+
+        std::atomic<std::int64_t> value{INITIAL};
+    };
+
+    template<typename T>
+    class SequencedRing final
+    {
+    private:
+        std::vector<T, HugePageAllocator<T>> ring;
+        std::int64_t mask;
+
+        Sequence cursor;                                      // Last sequence published by the producer
+        std::vector<std::unique_ptr<Sequence>> consumers;     // Last sequence released by each consumer
+        std::vector<std::vector<std::size_t>> dependencies;   // Consumers that gate each consumer
+
+        // Producer only state
+        alignas(64) std::int64_t nextSequence;
+        std::int64_t cachedMinimumSequence;
+
+    public:
+        SequencedRing(const std::string& name, std::size_t capacity);
+
+        ~SequencedRing() = default;
+
+        std::size_t addConsumer(const std::vector<std::size_t>& dependsOn = {});
+
+        std::int64_t claim() noexcept;
+
+        T& get(std::int64_t sequence) noexcept;
+
+        const T& get(std::int64_t sequence) const noexcept;
+
+        void publish(std::int64_t sequence) noexcept;
+
+        std::int64_t available(std::size_t consumer) const noexcept;
+
+        void release(std::size_t consumer, std::int64_t sequence) noexcept;
+
+        std::int64_t getCursor() const noexcept;
+
+        std::int64_t getSequence(std::size_t consumer) const noexcept;
+
+        std::int64_t minimumSequence() const noexcept;
+
+        std::size_t capacity() const noexcept;
+
+        std::size_t numConsumers() const noexcept;
+
+        // Deleted default ctors and assignment operators
+        SequencedRing() = delete;
+
+        SequencedRing(const SequencedRing& other) = delete;
+
+        SequencedRing(SequencedRing&& other) = delete;
+
+        SequencedRing& operator=(const SequencedRing& other) = delete;
+
+        SequencedRing& operator=(SequencedRing&& other) = delete;
+    };
+
+} // BeaconTech::Common
+
+
+//********** Start Template Definitions **********
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_SEQUENCEDRING_CPP
+#include "SequencedRing.cpp"
+#endif
+//********** End Template Definitions **********
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_SEQUENCEDRING_HPP
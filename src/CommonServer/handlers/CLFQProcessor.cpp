@@ -2,7 +2,11 @@
 // The processor acts as an adapter for CLFQ Producer and Consumer threads.
 // The processor creates a consumer thread and provides it with a CLFQ. The
 // Producer generates and enqueues data while the consumer checks the buffer
-// and consumes the data if it exists.
+// and consumes the data if it exists. When the buffer is empty, the consumer
+// defers to its idle strategy (see IdleStrategy.hpp).
+//
+// Every job is stamped when it is enqueued so the consumer can measure how long it waited and how deep
+// the queue got (see QueueTelemetry.hpp).
 //
 // Created by Michael Lewis on 10/21/23.
 //
@@ -11,72 +15,111 @@
 #define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_CLFQPROCESSOR_CPP
 
 #include <iostream>
+#include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "CLFQProcessor.hpp"
 
 namespace BeaconTech::Common
 {
-    template<typename T>
-    CLFQProcessor<T>::CLFQProcessor() : shouldTerminate{false}, CLFQueue{}
+    template<typename T, typename I>
+    CLFQProcessor<T, I>::CLFQProcessor() : CLFQProcessor{"engine"}
+    {
+
+    }
+
+    // The name identifies the role of the consumer thread and scopes its configs (e.g. engine-0.idleStrategy, engine-0.cpus)
+    template<typename T, typename I>
+    CLFQProcessor<T, I>::CLFQProcessor(const std::string& name) : CLFQProcessor{name, QueueTelemetryReporter{}}
+    {
+
+    }
+
+    // The telemetry reporter is invoked periodically on the consumer thread with the queue telemetry
+    template<typename T, typename I>
+    CLFQProcessor<T, I>::CLFQProcessor(const std::string& name, QueueTelemetryReporter telemetryReporter)
+        : name{name}, shouldTerminate{false}, CLFQueue{name}, idleStrategy{name},
+          telemetry{name, std::move(telemetryReporter)}
     {
         start();
     }
 
-    // Creates a consumer thread, gives it the function to be run, and starts the event loop
-    template<typename T>
-    void CLFQProcessor<T>::start()
+    // Creates a consumer thread for the role, gives it the function to be run, and starts the event loop
+    template<typename T, typename I>
+    void CLFQProcessor<T, I>::start()
     {
-        threadPool.emplace_back(&CLFQProcessor::threadLoop, this);
+        threadPool.emplace_back(ThreadFactory::createThread(name, &CLFQProcessor::threadLoop, this));
     }
 
-    // Pushes work into the queue that will be processed by engine threads
-    template<typename T>
-    void CLFQProcessor<T>::enqueue(const std::function<void ()>& job)
+    // Pushes work into the queue that will be processed by engine threads.
+    // Wakes the consumer if its idle strategy has parked it
+    template<typename T, typename I>
+    void CLFQProcessor<T, I>::enqueue(const std::function<void ()>& job)
     {
-        *(CLFQueue.getNextToWriteTo()) = job;
+        auto slot = CLFQueue.getNextToWriteTo();
+        slot->job = job;
+        slot->enqueueNanos = telemetry.isEnabled() ? QueueTelemetry::now() : 0;
         CLFQueue.updateWriteIndex();
+        idleStrategy.wake();
     }
 
     // Event loop to process entities enqueued by the trading system
-    template<typename T>
-    void CLFQProcessor<T>::threadLoop()
+    template<typename T, typename I>
+    void CLFQProcessor<T, I>::threadLoop()
     {
-        while (true)
+        const auto hasWork = [this]() { return CLFQueue.getNextToRead() != nullptr || shouldTerminate; };
+
+        // Terminate the event loop
+        while (!shouldTerminate)
         {
-            try
+            // Gets a pointer to the next element to be consumed or a nullPtr
+            const auto slot = CLFQueue.getNextToRead();
+            if (slot != nullptr)
             {
-                // Terminate the event loop
-                if (shouldTerminate) break;
+                if (telemetry.isEnabled()) telemetry.recordDequeue(slot->enqueueNanos, CLFQueue.size());
 
-                // Gets a pointer to the next element to be consumed or a nullPtr
-                const auto job = CLFQueue.getNextToRead();
-                if (job != nullptr)
+                try
+                {
+                    TraceSpan span{"CLFQProcessor::job"};
+                    slot->job();  // Process the job
+                }
+                catch (const std::exception& e)
                 {
-                    CLFQueue.updateNextToRead();  // Update the read index to point to the next element to be consumed
-                    job->operator()();  // Process the job
+                    std::cerr << e.what() << std::endl;
                 }
+
+                // Only release the slot to the producer once the job has finished with it
+                CLFQueue.updateNextToRead();
+                idleStrategy.reset();
             }
-            catch (const std::exception& e)
+            else
             {
-                std::cerr << e.what() << std::endl;
+                idleStrategy.idle(hasWork);
+                if (telemetry.isEnabled()) telemetry.pollIdle();
             }
+
+            if (telemetry.isEnabled()) telemetry.poll();
         }
+
+        if (telemetry.isEnabled()) telemetry.report();
     }
 
     // Determines if the worker still has jobs to perform
-    template<typename T>
-    bool CLFQProcessor<T>::busy()
+    template<typename T, typename I>
+    bool CLFQProcessor<T, I>::busy()
     {
         return CLFQueue.size() > 0;
     }
 
     // Blocks the current thread (usually the main thread) until the thread finish working
-    template<typename T>
-    void CLFQProcessor<T>::stop()
+    template<typename T, typename I>
+    void CLFQProcessor<T, I>::stop()
     {
         shouldTerminate = true;
+        idleStrategy.wake();
+
         for (std::thread& thread : threadPool)
         {
             if (thread.joinable()) thread.join();
@@ -87,4 +130,4 @@ namespace BeaconTech::Common
 } // BeaconTech::Common
 
 
-#endif
\ No newline at end of file
+#endif
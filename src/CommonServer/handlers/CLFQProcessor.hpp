@@ -2,7 +2,11 @@
 // The processor acts as an adapter for CLFQ Producer and Consumer threads.
 // The processor creates a consumer thread and provides it with a CLFQ. The
 // Producer generates and enqueues data while the consumer checks the buffer
-// and consumes the data if it exists.
+// and consumes the data if it exists. When the buffer is empty, the consumer
+// defers to its idle strategy (see IdleStrategy.hpp).
+//
+// Every job is stamped when it is enqueued so the consumer can measure how long it waited and how deep
+// the queue got (see QueueTelemetry.hpp).
 //
 // Created by Michael Lewis on 10/21/23.
 //
@@ -11,22 +15,42 @@
 #define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_CLFQPROCESSOR_HPP
 
 #include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
 #include <thread>
 #include <vector>
 
+#include "../concepts/BTConcepts.hpp"
+#include "../concurrency/IdleStrategy.hpp"
+#include "../concurrency/ThreadFactory.hpp"
 #include "../datastructures/ConcurrentLockFreeQueue.hpp"
+#include "../telemetry/QueueTelemetry.hpp"
+#include "../telemetry/TraceRecorder.hpp"
 
 namespace BeaconTech::Common
 {
 
+    // A queue slot holds the job and the time it was enqueued
     template<typename T>
+    struct TimedJob
+    {
+        T job;
+        std::int64_t enqueueNanos;
+    };
+
+    template<typename T, typename I = ConfiguredIdleStrategy>
     class CLFQProcessor
     {
+        static_assert(Common::IdleStrategy<I>, "CLFQProcessor requires a valid IdleStrategy");
+
     private:
-        bool shouldTerminate;
-        ConcurrentLockFreeQueue<T> CLFQueue;
+        std::string name;
+        std::atomic<bool> shouldTerminate;
+        ConcurrentLockFreeQueue<TimedJob<T>> CLFQueue;
+        I idleStrategy;
+        QueueTelemetry telemetry;
         std::vector<std::thread> threadPool;
 
         void threadLoop();
@@ -34,6 +58,10 @@ namespace BeaconTech::Common
     public:
         CLFQProcessor();
 
+        explicit CLFQProcessor(const std::string& name);
+
+        CLFQProcessor(const std::string& name, QueueTelemetryReporter telemetryReporter);
+
         virtual ~CLFQProcessor() = default;
 
         void start();
@@ -13,11 +13,13 @@
 #include <thread>
 
 #include "ConcurrentQueueProcessor.hpp"
+#include "../concurrency/ThreadFactory.hpp"
 
 namespace BeaconTech::Common
 {
     // Initializes a thread pool and starts the event loop
-    ConcurrentQueueProcessor::ConcurrentQueueProcessor(const unsigned int &threadId) : shouldTerminate{false}
+    ConcurrentQueueProcessor::ConcurrentQueueProcessor(const unsigned int &threadId)
+        : role{"queue-" + std::to_string(threadId)}, shouldTerminate{false}
     {
         start();
     }
@@ -31,7 +33,7 @@ namespace BeaconTech::Common
     // Creates the queue and starts the event loop
     void ConcurrentQueueProcessor::start()
     {
-        threadPool.emplace_back(&ConcurrentQueueProcessor::threadLoop, this);
+        threadPool.emplace_back(ThreadFactory::createThread(role, &ConcurrentQueueProcessor::threadLoop, this));
     }
 
     // Pushes work into the queue that will be processed by engine threads
@@ -15,6 +15,8 @@
 #include <condition_variable>
 #include <mutex>
 #include <queue>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace BeaconTech::Common
@@ -23,6 +25,7 @@ namespace BeaconTech::Common
     class ConcurrentQueueProcessor final
     {
     private:
+        std::string role;
         bool shouldTerminate;
         std::mutex mutex;
         std::condition_variable conditionVariable;
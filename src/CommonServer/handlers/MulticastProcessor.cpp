@@ -0,0 +1,194 @@
+//
+// The processor multicasts a single event stream to several listeners through a SequencedRing.
+// The producer writes each event into the ring once and every listener reads it in place on its own
+// consumer thread, so adding a listener never adds a copy.
+//
+// Created by Michael Lewis on 1/11/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_MULTICASTPROCESSOR_CPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_MULTICASTPROCESSOR_CPP
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "MulticastProcessor.hpp"
+#include "../utils/ConfigManager.hpp"
+
+namespace BeaconTech::Common
+{
+    template<typename E, typename I>
+    MulticastProcessor<E, I>::MulticastProcessor(const std::string& name)
+        : MulticastProcessor{name, QueueTelemetryReporter{}}
+    {
+
+    }
+
+    // The name identifies the role of the listener threads and scopes their configs (e.g. engine-0.ringSize).
+    // The telemetry reporter is invoked periodically on the thread of listener 0
+    template<typename E, typename I>
+    MulticastProcessor<E, I>::MulticastProcessor(const std::string& name, QueueTelemetryReporter telemetryReporter)
+        : name{name}, shouldTerminate{false},
+          ring{name, ConfigManager::roleIntConfigValueDefaultIfNull(name, "ringSize", 4096)},
+          telemetry{name, std::move(telemetryReporter)}
+    {
+
+    }
+
+    template<typename E, typename I>
+    MulticastProcessor<E, I>::~MulticastProcessor()
+    {
+        stop();
+    }
+
+    template<typename E, typename I>
+    std::string MulticastProcessor<E, I>::listenerRole(std::size_t listener) const
+    {
+        return listener == 0 ? name : name + "-listener-" + std::to_string(listener);
+    }
+
+    // Registers a listener that receives every event once the listeners it depends on have processed it.
+    // Listeners must be added before the processor is started
+    template<typename E, typename I>
+    std::size_t MulticastProcessor<E, I>::addListener(EventHandler handler, const std::vector<std::size_t>& dependsOn)
+    {
+        if (!threadPool.empty()) throw std::logic_error("Listeners must be added before " + name + " is started");
+
+        const std::size_t listener = ring.addConsumer(dependsOn);
+        handlers.emplace_back(std::move(handler));
+        idleStrategies.emplace_back(std::make_unique<I>(listenerRole(listener)));
+        dependents.emplace_back();
+
+        for (std::size_t dependency : dependsOn) dependents[dependency].push_back(listener);
+
+        return listener;
+    }
+
+    // Creates a consumer thread for each listener and starts the event loops
+    template<typename E, typename I>
+    void MulticastProcessor<E, I>::start()
+    {
+        for (std::size_t listener = 0; listener < handlers.size(); ++listener)
+        {
+            threadPool.emplace_back(ThreadFactory::createThread(listenerRole(listener),
+                                                                &MulticastProcessor::threadLoop, this, listener));
+        }
+    }
+
+    // Writes the event directly into the ring slot and wakes any listener that has parked
+    template<typename E, typename I>
+    template<typename Writer>
+    std::int64_t MulticastProcessor<E, I>::publish(Writer&& writer)
+    {
+        const std::int64_t sequence = ring.claim();
+        auto& slot = ring.get(sequence);
+
+        writer(slot.event);
+        slot.publishNanos = telemetry.isEnabled() ? QueueTelemetry::now() : 0;
+        ring.publish(sequence);
+
+        for (auto& idleStrategy : idleStrategies) idleStrategy->wake();
+
+        return sequence;
+    }
+
+    // Event loop of a single listener. Reads every available event in place, then releases the whole batch
+    // so that the producer and downstream listeners can make progress
+    template<typename E, typename I>
+    void MulticastProcessor<E, I>::threadLoop(std::size_t listener)
+    {
+        I& idleStrategy = *idleStrategies[listener];
+        const EventHandler& handler = handlers[listener];
+        const bool recordTelemetry = listener == 0 && telemetry.isEnabled();
+
+        std::int64_t next = ring.getSequence(listener) + 1;
+        const auto hasWork = [this, listener, &next]() { return ring.available(listener) >= next || shouldTerminate; };
+
+        // Terminate the event loop
+        while (!shouldTerminate)
+        {
+            const std::int64_t available = ring.available(listener);
+            if (available >= next)
+            {
+                for (; next <= available; ++next)
+                {
+                    const auto& slot = ring.get(next);
+                    if (recordTelemetry) telemetry.recordDequeue(slot.publishNanos, ring.getCursor() - next + 1);
+
+                    try
+                    {
+                        TraceSpan span{"MulticastProcessor::onEvent"};
+                        handler(slot.event, next);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        std::cerr << e.what() << std::endl;
+                    }
+                }
+
+                ring.release(listener, available);
+                for (std::size_t dependent : dependents[listener]) idleStrategies[dependent]->wake();
+                idleStrategy.reset();
+            }
+            else
+            {
+                idleStrategy.idle(hasWork);
+                if (recordTelemetry) telemetry.pollIdle();
+            }
+
+            if (recordTelemetry) telemetry.poll();
+        }
+
+        if (recordTelemetry) telemetry.report();
+    }
+
+    // The last sequence published by the producer
+    template<typename E, typename I>
+    std::int64_t MulticastProcessor<E, I>::getCursor() const noexcept
+    {
+        return ring.getCursor();
+    }
+
+    // The last sequence the listener has finished processing
+    template<typename E, typename I>
+    std::int64_t MulticastProcessor<E, I>::getSequence(std::size_t listener) const noexcept
+    {
+        return ring.getSequence(listener);
+    }
+
+    // The last sequence every listener has finished processing
+    template<typename E, typename I>
+    std::int64_t MulticastProcessor<E, I>::minimumSequence() const noexcept
+    {
+        return ring.minimumSequence();
+    }
+
+    // Determines if any listener still has events to process
+    template<typename E, typename I>
+    bool MulticastProcessor<E, I>::busy() const noexcept
+    {
+        return !handlers.empty() && ring.minimumSequence() < ring.getCursor();
+    }
+
+    // Blocks the current thread (usually the main thread) until the listener threads finish working
+    template<typename E, typename I>
+    void MulticastProcessor<E, I>::stop()
+    {
+        shouldTerminate = true;
+        for (auto& idleStrategy : idleStrategies) idleStrategy->wake();
+
+        for (std::thread& thread : threadPool)
+        {
+            if (thread.joinable()) thread.join();
+        }
+
+        threadPool.clear();
+    }
+} // BeaconTech::Common
+
+
+#endif
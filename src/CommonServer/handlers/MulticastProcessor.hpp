@@ -0,0 +1,110 @@
+//
+// The processor multicasts a single event stream to several listeners through a SequencedRing.
+// The producer writes each event into the ring once and every listener reads it in place on its own
+// consumer thread, so adding a listener never adds a copy. Listeners can be gated on other listeners
+// (e.g. a logging listener only sees an event after the strategy listener has processed it).
+// When a listener has nothing to read, it defers to its idle strategy (see IdleStrategy.hpp).
+//
+// Listener 0 runs on a thread with the role of the processor (e.g. engine-0) and records queue
+// telemetry (see QueueTelemetry.hpp). Listener N > 0 runs on a thread with the role <name>-listener-N.
+//
+// Created by Michael Lewis on 1/11/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_MULTICASTPROCESSOR_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_MULTICASTPROCESSOR_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../concepts/BTConcepts.hpp"
+#include "../concurrency/IdleStrategy.hpp"
+#include "../concurrency/ThreadFactory.hpp"
+#include "../datastructures/SequencedRing.hpp"
+#include "../telemetry/QueueTelemetry.hpp"
+#include "../telemetry/TraceRecorder.hpp"
+
+namespace BeaconTech::Common
+{
+    // A ring slot holds the event and the time it was published
+    template<typename E>
+    struct TimedEvent
+    {
+        E event;
+        std::int64_t publishNanos;
+    };
+
+    template<typename E, typename I = ConfiguredIdleStrategy>
+    class MulticastProcessor
+    {
+        static_assert(Common::IdleStrategy<I>, "MulticastProcessor requires a valid IdleStrategy");
+
+    public:
+        using EventHandler = std::function<void (const E& event, std::int64_t sequence)>;
+
+    private:
+        std::string name;
+        std::atomic<bool> shouldTerminate;
+        SequencedRing<TimedEvent<E>> ring;
+        QueueTelemetry telemetry;
+
+        // Indexed by listener
+        std::vector<EventHandler> handlers;
+        std::vector<std::unique_ptr<I>> idleStrategies;
+        std::vector<std::vector<std::size_t>> dependents;  // Listeners gated on each listener
+        std::vector<std::thread> threadPool;
+
+        std::string listenerRole(std::size_t listener) const;
+
+        void threadLoop(std::size_t listener);
+
+    public:
+        explicit MulticastProcessor(const std::string& name);
+
+        MulticastProcessor(const std::string& name, QueueTelemetryReporter telemetryReporter);
+
+        virtual ~MulticastProcessor();
+
+        std::size_t addListener(EventHandler handler, const std::vector<std::size_t>& dependsOn = {});
+
+        void start();
+
+        // Claims the next slot, lets the writer fill the event in place and publishes it. Returns the sequence
+        template<typename Writer>
+        std::int64_t publish(Writer&& writer);
+
+        std::int64_t getCursor() const noexcept;
+
+        std::int64_t getSequence(std::size_t listener) const noexcept;
+
+        std::int64_t minimumSequence() const noexcept;
+
+        void stop();
+
+        bool busy() const noexcept;
+
+        // Deleted default ctors and assignment operators
+        MulticastProcessor() = delete;
+
+        MulticastProcessor(const MulticastProcessor& other) = delete;
+
+        MulticastProcessor(MulticastProcessor&& other) = delete;
+
+        MulticastProcessor& operator=(const MulticastProcessor& other) = delete;
+
+        MulticastProcessor& operator=(MulticastProcessor&& other) = delete;
+    };
+
+} // BeaconTech::Common
+
+//********** Start Template Definitions **********
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_MULTICASTPROCESSOR_CPP
+#include "MulticastProcessor.cpp"
+#endif
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_MULTICASTPROCESSOR_HPP
@@ -0,0 +1,56 @@
+//
+// The shared memory channels between the Strategies and RiskManager processes. Both processes resolve
+// the channel names from the same configs so they attach to the same rings:
+//
+//   "orderRequestRing": "/beacontech-order-requests"          (Strategies -> RiskManager)
+//   "executionReportRing": "/beacontech-execution-reports"    (RiskManager -> Strategies)
+//   "ipcRingSize": "4096"
+//
+// Created by Michael Lewis on 1/13/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_IPCCHANNELS_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_IPCCHANNELS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "../utils/ConfigManager.hpp"
+
+namespace BeaconTech::Common
+{
+
+    class IpcChannels
+    {
+    public:
+        static std::string orderRequestRing()
+        {
+            return ConfigManager::config().orderRequestRing;
+        }
+
+        static std::string executionReportRing()
+        {
+            return ConfigManager::config().executionReportRing;
+        }
+
+        static std::uint32_t ringSize()
+        {
+            return ConfigManager::config().ipcRingSize;
+        }
+
+        // The steady clock is CLOCK_MONOTONIC, which is shared by every process on the host, so
+        // timestamps taken in one process can be compared in the other
+        static inline std::int64_t now() noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        // Deleted default ctors and assignment operators
+        IpcChannels() = delete;
+    };
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_IPCCHANNELS_HPP
@@ -0,0 +1,201 @@
+//
+// A bounded multi-producer, single-consumer ring buffer that lives in POSIX shared memory (/dev/shm) so
+// that separate processes (e.g. Strategies and RiskManager) can exchange fixed size messages without a
+// syscall on the critical path.
+//
+// Created by Michael Lewis on 1/13/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_SHAREDMEMORYRING_CPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_SHAREDMEMORYRING_CPP
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SharedMemoryRing.hpp"
+
+namespace BeaconTech::Common
+{
+    // Attaches to the named ring, creating it if it does not exist. The capacity is rounded up to a power
+    // of two and must match the capacity of an existing ring
+    template<typename T>
+    SharedMemoryRing<T>::SharedMemoryRing(const std::string& name, std::size_t capacity)
+        : name{name}, fd{-1}, mappedBytes{0}, mapping{nullptr}, header{nullptr}, slots{nullptr}, mask{0}
+    {
+        const std::uint64_t slotCount = std::bit_ceil(std::max<std::size_t>(capacity, 2));
+        const std::size_t headerBytes = (sizeof(Header) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+        mappedBytes = headerBytes + slotCount * sizeof(Slot);
+
+        fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0660);
+        if (fd < 0) throw std::runtime_error("Unable to open shared memory " + name + " - " + std::strerror(errno));
+
+        // A new segment is zero filled by ftruncate, which leaves the header UNINITIALIZED
+        struct stat stats{};
+        if (fstat(fd, &stats) != 0 || (stats.st_size == 0 && ftruncate(fd, static_cast<off_t>(mappedBytes)) != 0))
+        {
+            close(fd);
+            throw std::runtime_error("Unable to size shared memory " + name + " - " + std::strerror(errno));
+        }
+
+        if (stats.st_size != 0 && static_cast<std::size_t>(stats.st_size) != mappedBytes)
+        {
+            close(fd);
+            throw std::runtime_error("Shared memory " + name + " has a different layout. Unlink it and restart");
+        }
+
+        int flags = MAP_SHARED;
+#if defined(MAP_POPULATE)
+        flags |= MAP_POPULATE;  // Pre-fault the ring so the first messages don't page fault
+#endif
+        mapping = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, flags, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            close(fd);
+            throw std::runtime_error("Unable to map shared memory " + name + " - " + std::strerror(errno));
+        }
+
+        header = static_cast<Header*>(mapping);
+        slots = reinterpret_cast<Slot*>(static_cast<char*>(mapping) + headerBytes);
+        mask = slotCount - 1;
+
+        std::uint32_t expected = UNINITIALIZED;
+        if (header->state.compare_exchange_strong(expected, INITIALIZING)) initialize(slotCount);
+        else awaitReady(slotCount);
+    }
+
+    // Unmaps the ring. The segment itself outlives the process so the other side is unaffected
+    template<typename T>
+    SharedMemoryRing<T>::~SharedMemoryRing()
+    {
+        if (mapping != nullptr) munmap(mapping, mappedBytes);
+        if (fd >= 0) close(fd);
+    }
+
+    // Slot i starts with sequence i, which means it is free for the producer that claims sequence i
+    template<typename T>
+    void SharedMemoryRing<T>::initialize(std::uint64_t capacity) noexcept
+    {
+        for (std::uint64_t i = 0; i < capacity; ++i) slots[i].sequence.store(i, std::memory_order_relaxed);
+
+        header->magic = MAGIC;
+        header->capacity = capacity;
+        header->slotSize = sizeof(Slot);
+        header->writeSequence.store(0, std::memory_order_relaxed);
+        header->readSequence.store(0, std::memory_order_relaxed);
+        header->state.store(READY, std::memory_order_release);
+    }
+
+    // Waits for the side that created the ring to finish initializing it and validates the layout
+    template<typename T>
+    void SharedMemoryRing<T>::awaitReady(std::uint64_t capacity) const
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+        while (header->state.load(std::memory_order_acquire) != READY)
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                throw std::runtime_error("Shared memory " + name + " was never initialized. Unlink it and restart");
+            }
+
+            std::this_thread::yield();
+        }
+
+        if (header->magic != MAGIC || header->capacity != capacity || header->slotSize != sizeof(Slot))
+        {
+            throw std::runtime_error("Shared memory " + name + " has a different layout. Unlink it and restart");
+        }
+    }
+
+    // Claims the next sequence and copies the message into its slot. Returns false if the ring is full
+    template<typename T>
+    bool SharedMemoryRing<T>::tryPublish(const T& message) noexcept
+    {
+        std::uint64_t position = header->writeSequence.load(std::memory_order_relaxed);
+        Slot* slot;
+
+        while (true)
+        {
+            slot = &slots[position & mask];
+            const auto difference = static_cast<std::int64_t>(slot->sequence.load(std::memory_order_acquire) - position);
+
+            if (difference == 0)
+            {
+                // The slot is free for this sequence. Claim it unless another producer got there first
+                if (header->writeSequence.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            }
+            else if (difference < 0)
+            {
+                return false;  // The consumer has not yet released the slot from the previous lap
+            }
+            else
+            {
+                position = header->writeSequence.load(std::memory_order_relaxed);
+            }
+        }
+
+        std::memcpy(&slot->message, &message, sizeof(T));
+        slot->sequence.store(position + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Copies the next message out of the ring. Returns false if there is nothing to consume
+    template<typename T>
+    bool SharedMemoryRing<T>::tryConsume(T& message) noexcept
+    {
+        const std::uint64_t position = header->readSequence.load(std::memory_order_relaxed);
+        Slot& slot = slots[position & mask];
+
+        if (slot.sequence.load(std::memory_order_acquire) != position + 1) return false;
+
+        std::memcpy(&message, &slot.message, sizeof(T));
+
+        // Hand the slot to the producer that will claim it on the next lap
+        slot.sequence.store(position + mask + 1, std::memory_order_release);
+        header->readSequence.store(position + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Approximate number of messages waiting to be consumed
+    template<typename T>
+    std::size_t SharedMemoryRing<T>::size() const noexcept
+    {
+        const std::uint64_t write = header->writeSequence.load(std::memory_order_acquire);
+        const std::uint64_t read = header->readSequence.load(std::memory_order_acquire);
+
+        return write > read ? write - read : 0;
+    }
+
+    template<typename T>
+    std::size_t SharedMemoryRing<T>::capacity() const noexcept
+    {
+        return mask + 1;
+    }
+
+    template<typename T>
+    const std::string& SharedMemoryRing<T>::getName() const noexcept
+    {
+        return name;
+    }
+
+    // Removes the named ring from the system. Processes that are attached keep their mapping
+    template<typename T>
+    void SharedMemoryRing<T>::unlink(const std::string& name) noexcept
+    {
+        shm_unlink(name.c_str());
+    }
+} // namespace BeaconTech::Common
+
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_SHAREDMEMORYRING_CPP
@@ -0,0 +1,112 @@
+//
+// A bounded multi-producer, single-consumer ring buffer that lives in POSIX shared memory (/dev/shm) so
+// that separate processes (e.g. Strategies and RiskManager) can exchange fixed size messages without a
+// syscall on the critical path. Each slot carries a sequence number that tells producers and the consumer
+// whose turn it is to use the slot, so producers only contend on claiming a sequence.
+//
+// Both sides attach to the ring by name. Whoever attaches first creates and initializes the segment and
+// the other side maps the existing segment. The read and write positions live in the segment, not in
+// either process, so one side can restart and resume where it left off. The segment is only removed by
+// unlink, so a restarting consumer drains any messages that were published while it was down.
+//
+// Publishing never blocks: a full ring is reported to the producer so a trading thread can never be
+// stalled by a slow or absent consumer. Messages must be trivially copyable (see OrderRequest.hpp).
+//
+// NOTE - A producer that dies between claiming and publishing a slot leaves a hole that stops the consumer.
+// Unlink the ring after such a crash.
+//
+// Created by Michael Lewis on 1/13/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_SHAREDMEMORYRING_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_SHAREDMEMORYRING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace BeaconTech::Common
+{
+
+    template<typename T>
+    class SharedMemoryRing final
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "SharedMemoryRing messages must be trivially copyable");
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "SharedMemoryRing requires lock-free atomics");
+
+    private:
+        static constexpr std::uint64_t MAGIC = 0x4254'5348'4d52'0001;  // BTSHMR v1
+        static constexpr std::uint32_t UNINITIALIZED = 0;
+        static constexpr std::uint32_t INITIALIZING = 1;
+        static constexpr std::uint32_t READY = 2;
+
+        struct alignas(64) Slot
+        {
+            std::atomic<std::uint64_t> sequence;
+            T message;
+        };
+
+        // The positions are on their own cache lines so producers and the consumer never false share
+        struct Header
+        {
+            std::atomic<std::uint32_t> state;
+            std::uint64_t magic;
+            std::uint64_t capacity;
+            std::uint64_t slotSize;
+            alignas(64) std::atomic<std::uint64_t> writeSequence;  // Next sequence to be claimed by a producer
+            alignas(64) std::atomic<std::uint64_t> readSequence;   // Next sequence to be consumed
+        };
+
+        std::string name;
+        int fd;
+        std::size_t mappedBytes;
+        void* mapping;
+        Header* header;
+        Slot* slots;
+        std::uint64_t mask;
+
+        void initialize(std::uint64_t capacity) noexcept;
+
+        void awaitReady(std::uint64_t capacity) const;
+
+    public:
+        SharedMemoryRing(const std::string& name, std::size_t capacity);
+
+        ~SharedMemoryRing();
+
+        bool tryPublish(const T& message) noexcept;
+
+        bool tryConsume(T& message) noexcept;
+
+        std::size_t size() const noexcept;
+
+        std::size_t capacity() const noexcept;
+
+        const std::string& getName() const noexcept;
+
+        static void unlink(const std::string& name) noexcept;
+
+        // Deleted default ctors and assignment operators
+        SharedMemoryRing() = delete;
+
+        SharedMemoryRing(const SharedMemoryRing& other) = delete;
+
+        SharedMemoryRing(SharedMemoryRing&& other) = delete;
+
+        SharedMemoryRing& operator=(const SharedMemoryRing& other) = delete;
+
+        SharedMemoryRing& operator=(SharedMemoryRing&& other) = delete;
+    };
+
+} // namespace BeaconTech::Common
+
+
+//********** Start Template Definitions **********
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_SHAREDMEMORYRING_CPP
+#include "SharedMemoryRing.cpp"
+#endif
+//********** End Template Definitions **********
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_SHAREDMEMORYRING_HPP
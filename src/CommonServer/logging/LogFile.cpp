@@ -0,0 +1,227 @@
+//
+// A log file that is written through a large, page aligned user-space buffer with one write syscall
+// per batch, a configurable fsync policy and rotation by size and age.
+//
+// Created by Michael Lewis on 1/17/24.
+//
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <new>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "LogFile.hpp"
+#include "LogLevel.hpp"
+#include "LogRotator.hpp"
+#include "../utils/ConfigManager.hpp"
+
+namespace BeaconTech::Common
+{
+    LogFsyncPolicy logFsyncPolicyFromString(const std::string& name) noexcept
+    {
+        if (name == "ALWAYS") return LogFsyncPolicy::ALWAYS;
+        if (name == "INTERVAL") return LogFsyncPolicy::INTERVAL;
+        return LogFsyncPolicy::NEVER;
+    }
+
+    namespace
+    {
+        // The buffer is rounded up to whole pages so it can be handed to the kernel page by page
+        std::size_t bufferSize()
+        {
+            constexpr std::size_t PAGE_SIZE = 4096;
+            const std::size_t bytes = ConfigManager::config().logBufferSize;
+            return std::max<std::size_t>((bytes + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1), PAGE_SIZE);
+        }
+
+        std::uint64_t fileSize(int fd) noexcept
+        {
+            struct stat status{};
+            return fd >= 0 && fstat(fd, &status) == 0 ? static_cast<std::uint64_t>(status.st_size) : 0;
+        }
+
+        std::string metricTags(const std::string& fileName)
+        {
+            return "file=" + std::filesystem::path{fileName}.filename().string();
+        }
+    }
+
+    LogFile::LogFile(std::string fileName, LogRotator& rotator)
+        : fileName{std::move(fileName)},
+          fd{open(this->fileName.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644)}, rotator{rotator},
+          rotateBytes{static_cast<std::uint64_t>(ConfigManager::config().logRotateMegabytes)
+                      * 1024 * 1024},
+          rotateInterval{ConfigManager::config().logRotateMinutes}, standbyFd{-1},
+          segmentBytes{fileSize(fd)}, segmentStart{std::chrono::steady_clock::now()},
+          buffer{nullptr, &std::free}, capacity{bufferSize()}, size{0},
+          flushInterval{ConfigManager::config().logFlushMicros},
+          fsyncPolicy{logFsyncPolicyFromString(ConfigManager::config().logFsync)},
+          fsyncInterval{ConfigManager::config().logFsyncMillis},
+          lastFsyncTime{std::chrono::steady_clock::now()}, writes{MetricsRegistry::getInstance().counter("log.writes", metricTags(this->fileName))},
+          bytesWritten{MetricsRegistry::getInstance().counter("log.bytes", metricTags(this->fileName))},
+          fsyncs{MetricsRegistry::getInstance().counter("log.fsyncs", metricTags(this->fileName))}
+    {
+        if (fd < 0)
+        {
+            std::cerr << LogLevel::SEVERE.getDesc() << " : Unable to open log file " << this->fileName
+                      << " - " << std::strerror(errno) << std::endl;
+        }
+
+        buffer.reset(static_cast<char*>(std::aligned_alloc(BUFFER_ALIGNMENT, capacity)));
+        if (!buffer) throw std::bad_alloc{};
+
+        if (isRotationEnabled()) rotator.prepare(*this);
+    }
+
+    // The LogRotator must be stopped first so it cannot publish a standby segment to a destroyed file
+    LogFile::~LogFile()
+    {
+        writeBuffer();
+        fsyncIfDue(fsyncPolicy != LogFsyncPolicy::NEVER);
+        if (fd >= 0) close(fd);
+
+        // An unused standby segment is removed rather than left behind for the next session
+        const int standby = standbyFd.exchange(-1);
+        if (standby >= 0)
+        {
+            if (fileSize(standby) == 0) unlink(getStandbyName().c_str());
+            close(standby);
+        }
+    }
+
+    // Writes the whole buffer, retrying partial writes. Lines are discarded if the file is unusable so a
+    // full disk can never stall the flush worker
+    void LogFile::writeBuffer() noexcept
+    {
+        if (size == 0) return;
+
+        std::size_t offset = 0;
+        while (fd >= 0 && offset < size)
+        {
+            const ssize_t written = ::write(fd, buffer.get() + offset, size - offset);
+            if (written < 0)
+            {
+                if (errno == EINTR) continue;
+
+                std::cerr << LogLevel::SEVERE.getDesc() << " : Unable to write to log file " << fileName
+                          << " - " << std::strerror(errno) << std::endl;
+                break;
+            }
+
+            writes.add();
+            bytesWritten.add(static_cast<std::uint64_t>(written));
+            segmentBytes += static_cast<std::uint64_t>(written);
+            offset += static_cast<std::size_t>(written);
+        }
+
+        size = 0;
+        fsyncIfDue(fsyncPolicy == LogFsyncPolicy::ALWAYS);
+    }
+
+    void LogFile::fsyncIfDue(bool force) noexcept
+    {
+        if (fd < 0 || fsyncPolicy == LogFsyncPolicy::NEVER) return;
+
+        const auto now = std::chrono::steady_clock::now();
+        if (!force && now - lastFsyncTime < fsyncInterval) return;
+
+        if (fdatasync(fd) == 0) fsyncs.add();
+        lastFsyncTime = now;
+    }
+
+    // Writes the buffer once the oldest buffered line has waited for logFlushMicros
+    void LogFile::flushIfDue() noexcept
+    {
+        if (size == 0) return;
+        if (std::chrono::steady_clock::now() - firstBufferedTime < flushInterval) return;
+
+        writeBuffer();
+    }
+
+    void LogFile::flush() noexcept
+    {
+        writeBuffer();
+    }
+
+    // Switches to the standby segment once the current segment has reached logRotateMegabytes or is
+    // logRotateMinutes old. Only swaps file descriptors, the LogRotator does everything else
+    void LogFile::rotateIfDue() noexcept
+    {
+        if (!isRotationEnabled()) return;
+
+        const auto now = std::chrono::steady_clock::now();
+        const bool sizeDue = rotateBytes > 0 && segmentBytes + size >= rotateBytes;
+        const bool timeDue = rotateInterval.count() > 0 && now - segmentStart >= rotateInterval;
+        if (!sizeDue && !timeDue) [[likely]] return;
+
+        // Nothing to archive, so start a new interval in the same segment
+        if (segmentBytes == 0 && size == 0)
+        {
+            segmentStart = now;
+            return;
+        }
+
+        const int standby = standbyFd.exchange(-1, std::memory_order_acquire);
+        if (standby < 0) return;
+
+        writeBuffer();
+        const int closedFd = fd;
+        fd = standby;
+        segmentBytes = 0;
+        segmentStart = now;
+
+        rotator.rotated(*this, closedFd);
+    }
+
+    bool LogFile::isRotationEnabled() const noexcept
+    {
+        return rotateBytes > 0 || rotateInterval.count() > 0;
+    }
+
+    void LogFile::setStandby(int standby) noexcept
+    {
+        standbyFd.store(standby, std::memory_order_release);
+    }
+
+    std::string LogFile::getStandbyName() const
+    {
+        return fileName + ".next";
+    }
+
+    bool LogFile::hasBufferedData() const noexcept
+    {
+        return size > 0;
+    }
+
+    const std::string& LogFile::getFileName() const noexcept
+    {
+        return fileName;
+    }
+
+    LogFsyncPolicy LogFile::getFsyncPolicy() const noexcept
+    {
+        return fsyncPolicy;
+    }
+
+    std::uint64_t LogFile::getWrites() const noexcept
+    {
+        return writes.get();
+    }
+
+    std::uint64_t LogFile::getBytesWritten() const noexcept
+    {
+        return bytesWritten.get();
+    }
+
+    std::uint64_t LogFile::getFsyncs() const noexcept
+    {
+        return fsyncs.get();
+    }
+} // namespace BeaconTech::Common
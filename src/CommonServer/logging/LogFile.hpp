@@ -0,0 +1,182 @@
+//
+// A log file that is written through a large, page aligned user-space buffer. Formatted log lines are
+// appended to the buffer and the buffer is written with a single write syscall when it fills or when
+// the oldest buffered line is older than logFlushMicros, so a burst of log lines costs one syscall
+// rather than one per line. The file is only synced to disk as often as the fsync policy asks:
+//
+// 1) NEVER    - Leave write back to the OS. A crash of the host (not the process) can lose recent lines
+// 2) INTERVAL - fsync at most once every logFsyncMillis
+// 3) ALWAYS   - fsync after every write
+//
+// The file is rotated by size and age (see LogRotator.hpp). The flush worker only swaps in a standby
+// segment that the LogRotator opened ahead of time and hands the closed segment back to the rotator.
+//
+//   "logBufferSize": "1048576"    "logFlushMicros": "1000"
+//   "logFsync": "NEVER"           "logFsyncMillis": "1000"
+//
+// Created by Michael Lewis on 1/17/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGFILE_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGFILE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "../telemetry/MetricsRegistry.hpp"
+
+namespace BeaconTech::Common
+{
+
+    class LogRotator;
+
+    enum class LogFsyncPolicy : std::int8_t
+    {
+        NEVER = 0,
+        INTERVAL = 1,
+        ALWAYS = 2
+    };
+
+    LogFsyncPolicy logFsyncPolicyFromString(const std::string& name) noexcept;
+
+    class LogFile final
+    {
+    private:
+        static constexpr std::size_t BUFFER_ALIGNMENT = 4096;
+
+        // Leaves room for any number formatted by to_chars
+        static constexpr std::size_t MAX_NUMBER_LENGTH = 64;
+
+        const std::string fileName;
+        int fd;
+        LogRotator& rotator;
+
+        // Rotation properties. The standby segment is published by the LogRotator's thread
+        const std::uint64_t rotateBytes;
+        const std::chrono::minutes rotateInterval;
+        std::atomic<int> standbyFd;
+        std::uint64_t segmentBytes;
+        std::chrono::steady_clock::time_point segmentStart;
+
+        std::unique_ptr<char, decltype(&std::free)> buffer;
+        const std::size_t capacity;
+        std::size_t size;
+        std::chrono::steady_clock::time_point firstBufferedTime;    // When the oldest buffered line was added
+
+        const std::chrono::microseconds flushInterval;
+        const LogFsyncPolicy fsyncPolicy;
+        const std::chrono::milliseconds fsyncInterval;
+        std::chrono::steady_clock::time_point lastFsyncTime;
+
+        // Syscall statistics since the file was opened, published as log.writes, log.bytes and log.fsyncs
+        Counter& writes;
+        Counter& bytesWritten;
+        Counter& fsyncs;
+
+        void writeBuffer() noexcept;
+
+        void fsyncIfDue(bool force) noexcept;
+
+        inline void markBuffered() noexcept
+        {
+            if (size == 0) firstBufferedTime = std::chrono::steady_clock::now();
+        }
+
+    public:
+        LogFile(std::string fileName, LogRotator& rotator);
+
+        ~LogFile();
+
+        inline void append(std::string_view value) noexcept
+        {
+            while (!value.empty())
+            {
+                if (size == capacity) writeBuffer();
+
+                const std::size_t bytes = std::min(value.size(), capacity - size);
+                markBuffered();
+                std::memcpy(buffer.get() + size, value.data(), bytes);
+                size += bytes;
+                value.remove_prefix(bytes);
+            }
+        }
+
+        inline void append(char value) noexcept
+        {
+            if (size == capacity) writeBuffer();
+
+            markBuffered();
+            buffer.get()[size++] = value;
+        }
+
+        // Formats integers exactly and floating point numbers like std::ostream (6 significant digits)
+        template<typename T>
+        inline void appendNumber(T value) noexcept
+        {
+            if (capacity - size < MAX_NUMBER_LENGTH) writeBuffer();
+
+            markBuffered();
+            char* begin = buffer.get() + size;
+            std::to_chars_result result;
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                result = std::to_chars(begin, buffer.get() + capacity, value, std::chars_format::general, 6);
+            }
+            else
+            {
+                result = std::to_chars(begin, buffer.get() + capacity, value);
+            }
+
+            size += static_cast<std::size_t>(result.ptr - begin);
+        }
+
+        void flushIfDue() noexcept;
+
+        void flush() noexcept;
+
+        void rotateIfDue() noexcept;
+
+        bool isRotationEnabled() const noexcept;
+
+        // Called by the LogRotator once the standby segment is open
+        void setStandby(int standby) noexcept;
+
+        std::string getStandbyName() const;
+
+        bool hasBufferedData() const noexcept;
+
+        const std::string& getFileName() const noexcept;
+
+        LogFsyncPolicy getFsyncPolicy() const noexcept;
+
+        std::uint64_t getWrites() const noexcept;
+
+        std::uint64_t getBytesWritten() const noexcept;
+
+        std::uint64_t getFsyncs() const noexcept;
+
+        // Deleted default ctors and assignment operators
+        LogFile() = delete;
+
+        LogFile(const LogFile& other) = delete;
+
+        LogFile(LogFile&& other) = delete;
+
+        LogFile& operator=(const LogFile& other) = delete;
+
+        LogFile& operator=(LogFile&& other) = delete;
+    };
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGFILE_HPP
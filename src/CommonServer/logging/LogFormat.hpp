@@ -0,0 +1,70 @@
+//
+// Compile time checked log formats. A log format must be a string literal, so the log record only
+// needs to carry a pointer to it, and the number of % placeholders must match the number of arguments
+// passed to the log call. A mismatch fails to compile:
+//
+//   logger.logInfo(CLASS, "func", "bid=% ask=%", bid);   // error: call to non-constexpr function
+//
+// %% is an escaped % and is not a placeholder. Messages that are only known at runtime (e.g. e.what())
+// are logged as an argument: logger.logSevere(CLASS, "func", "%", e.what())
+//
+// Created by Michael Lewis on 1/15/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGFORMAT_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGFORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace BeaconTech::Common
+{
+    // A string literal that is referenced rather than copied into a log record (e.g. a function name)
+    struct LogLiteral
+    {
+        const char* data;
+        std::uint32_t size;
+
+        template<std::size_t N>
+        consteval LogLiteral(const char (&literal)[N]) : data{literal}, size{N - 1} {}
+    };
+
+    template<typename... Args>
+    struct BasicLogFormat
+    {
+        const char* data;
+        std::uint32_t size;
+
+        template<std::size_t N>
+        consteval BasicLogFormat(const char (&format)[N]) : data{format}, size{N - 1}
+        {
+            if (placeholders(format, N - 1) != sizeof...(Args)) argumentCountDoesNotMatchFormat();
+        }
+
+    private:
+        static consteval std::size_t placeholders(const char* format, std::size_t size)
+        {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                if (format[i] != '%') continue;
+
+                if (i + 1 < size && format[i + 1] == '%') ++i;
+                else ++count;
+            }
+
+            return count;
+        }
+
+        // Deliberately not constexpr so that a mismatch is reported as a compile error
+        static void argumentCountDoesNotMatchFormat() {}
+    };
+
+    // The arguments are deduced from the log call rather than from the format
+    template<typename... Args>
+    using LogFormat = BasicLogFormat<std::type_identity_t<Args>...>;
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGFORMAT_HPP
@@ -3,14 +3,26 @@
 // The system should eventually be upgraded to use a low-latency custom-built or 3rd party
 // logging library
 //
+// Levels below BEACONTECH_LOG_MIN_LEVEL are compiled out of the build entirely (set with the CMake
+// option BEACONTECH_LOG_LEVEL). Levels that are compiled in are filtered at runtime by each Logger's
+// threshold (see Logger.hpp).
+//
 // Created by Michael Lewis on 10/6/23.
 //
 
 #ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGLEVEL_HPP
 #define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGLEVEL_HPP
 
+#include <cstdint>
+#include <string>
+
 #include "../datastructures/AbstractCodes.hpp"
 
+// 0 = DEBUG, 1 = INFO, 2 = WARN, 3 = ERROR
+#ifndef BEACONTECH_LOG_MIN_LEVEL
+#define BEACONTECH_LOG_MIN_LEVEL 0
+#endif
+
 namespace BeaconTech::Common
 {
     class LogLevel : public Common::AbstractCodes
@@ -19,18 +31,43 @@ namespace BeaconTech::Common
         LogLevel(int32_t id, std::string desc) : Common::AbstractCodes(id, std::move(desc)) {}
 
     public:
+        // Level ids that can be used in constant expressions
+        static constexpr std::int32_t DEBUG_ID = 0;
+        static constexpr std::int32_t INFO_ID = 1;
+        static constexpr std::int32_t WARN_ID = 2;
+        static constexpr std::int32_t SEVERE_ID = 3;
+
         LogLevel() = default;
 
+        // Determines if log calls of the level are compiled into the build
+        static constexpr bool isCompiledIn(std::int32_t id) noexcept
+        {
+            return id >= BEACONTECH_LOG_MIN_LEVEL;
+        }
+
+        static const LogLevel& fromString(const std::string& desc) noexcept;
+
         // Enum declarations
+        static const LogLevel DEBUG;
         static const LogLevel INFO;
         static const LogLevel WARN;
         static const LogLevel SEVERE;
     };
 
     // Enum definitions
-    inline const LogLevel LogLevel::INFO = LogLevel{1, "INFO"};
-    inline const LogLevel LogLevel::WARN = LogLevel{2, "WARN"};
-    inline const LogLevel LogLevel::SEVERE = LogLevel{3, "ERROR"};
+    inline const LogLevel LogLevel::DEBUG = LogLevel{DEBUG_ID, "DEBUG"};
+    inline const LogLevel LogLevel::INFO = LogLevel{INFO_ID, "INFO"};
+    inline const LogLevel LogLevel::WARN = LogLevel{WARN_ID, "WARN"};
+    inline const LogLevel LogLevel::SEVERE = LogLevel{SEVERE_ID, "ERROR"};
+
+    // Unknown descriptions map to INFO
+    inline const LogLevel& LogLevel::fromString(const std::string& desc) noexcept
+    {
+        if (desc == DEBUG.getDesc()) return DEBUG;
+        if (desc == WARN.getDesc()) return WARN;
+        if (desc == SEVERE.getDesc()) return SEVERE;
+        return INFO;
+    }
 
 } // namespace BeaconTech::Common
 
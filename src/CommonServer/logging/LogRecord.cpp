@@ -0,0 +1,141 @@
+//
+// The binary format of a log record. The calling thread copies the raw arguments of a log call into a
+// single variable length record and the flush thread decodes the record and formats the log line, so
+// none of the formatting happens on the performance critical thread.
+//
+// Created by Michael Lewis on 1/14/24.
+//
+
+#include <string>
+
+#include "LogRecord.hpp"
+#include "../utils/Clock.hpp"
+
+namespace BeaconTech::Common
+{
+    namespace
+    {
+        template<typename T>
+        T read(const std::byte*& in) noexcept
+        {
+            T value;
+            std::memcpy(&value, in, sizeof(T));
+            in += sizeof(T);
+            return value;
+        }
+
+        std::string_view readString(const std::byte*& in, std::size_t length) noexcept
+        {
+            std::string_view string{reinterpret_cast<const char*>(in), length};
+            in += length;
+            return string;
+        }
+
+        // getDesc() returns a copy, so the descriptions are copied once rather than for every record
+        const std::string& logLevelDesc(std::int32_t logLevel)
+        {
+            static const std::string SEVERE = LogLevel::SEVERE.getDesc();
+            static const std::string WARN = LogLevel::WARN.getDesc();
+            static const std::string INFO = LogLevel::INFO.getDesc();
+            static const std::string DEBUG = LogLevel::DEBUG.getDesc();
+
+            if (logLevel == static_cast<std::int32_t>(LogLevel::SEVERE)) return SEVERE;
+            if (logLevel == static_cast<std::int32_t>(LogLevel::WARN)) return WARN;
+            if (logLevel == static_cast<std::int32_t>(LogLevel::DEBUG)) return DEBUG;
+            return INFO;
+        }
+
+        void writeTimestamp(LogFile& file, std::int64_t epochNanos)
+        {
+            char timestamp[Clock::LOCAL_DATE_TIME_LENGTH];
+            Clock::formatLocalDateAndTime(epochNanos, timestamp);
+            file.append(std::string_view{timestamp, sizeof(timestamp)});
+        }
+
+        // Decodes the next argument and writes it to the file
+        void writeArg(LogFile& file, const std::byte*& in)
+        {
+            switch (static_cast<LogType>(read<std::int8_t>(in)))
+            {
+                case LogType::CHAR:
+                    file.append(read<char>(in));
+                    break;
+                case LogType::INTEGER:
+                    file.appendNumber(read<int>(in));
+                    break;
+                case LogType::LONG_INTEGER:
+                    file.appendNumber(read<long>(in));
+                    break;
+                case LogType::LONG_LONG_INTEGER:
+                    file.appendNumber(read<long long>(in));
+                    break;
+                case LogType::UNSIGNED_INTEGER:
+                    file.appendNumber(read<unsigned>(in));
+                    break;
+                case LogType::UNSIGNED_LONG_INTEGER:
+                    file.appendNumber(read<unsigned long>(in));
+                    break;
+                case LogType::UNSIGNED_LONG_LONG_INTEGER:
+                    file.appendNumber(read<unsigned long long>(in));
+                    break;
+                case LogType::FLOAT:
+                    file.appendNumber(read<float>(in));
+                    break;
+                case LogType::DOUBLE:
+                    file.appendNumber(read<double>(in));
+                    break;
+                case LogType::STRING:
+                    file.append(readString(in, read<std::uint32_t>(in)));
+                    break;
+            }
+        }
+    }
+
+    // Formats the record as a log line, substituting each % in the format with the next argument.
+    // %% is written as %
+    void LogRecord::write(LogFile& file, std::span<const std::byte> record, std::uint32_t engineId)
+    {
+        const std::byte* in = record.data();
+        const std::byte* end = record.data() + record.size();
+
+        const auto header = read<LogRecordHeader>(in);
+        const std::string_view className = readString(in, header.classNameLength);
+        const std::string_view funcName{header.funcName, header.funcNameLength};
+        const std::string_view format{header.format, header.formatLength};
+
+        writeTimestamp(file, Clock::tscToEpochNanos(header.tsc));
+        file.append(' ');
+        file.append(logLevelDesc(header.logLevel));
+        file.append("  ");
+        file.append(className);
+        file.append(' ');
+        file.append(funcName);
+        file.append(" [CLFQ-");
+        file.appendNumber(engineId);
+        file.append("]: ");
+
+        // Copy the literal text between placeholders in one piece
+        std::size_t literalStart = 0;
+
+        for (std::size_t i = 0; i < format.size(); ++i)
+        {
+            if (format[i] != '%') continue;
+
+            file.append(format.substr(literalStart, i - literalStart));
+            if (i + 1 < format.size() && format[i + 1] == '%')
+            {
+                file.append('%');
+                ++i;
+            }
+            else if (in < end)
+            {
+                writeArg(file, in);
+            }
+
+            literalStart = i + 1;
+        }
+
+        file.append(format.substr(literalStart));
+        file.append('\n');
+    }
+} // namespace BeaconTech::Common
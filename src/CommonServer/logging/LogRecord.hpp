@@ -0,0 +1,191 @@
+//
+// The binary format of a log record. The calling thread copies the raw arguments of a log call into a
+// single variable length record and the flush thread decodes the record and formats the log line, so
+// none of the formatting happens on the performance critical thread.
+//
+// A record is laid out as:
+//
+//   LogRecordHeader | className | arg 1 | ... | arg N
+//
+// The format and function name are string literals (see LogFormat.hpp), so the header only carries
+// pointers to them, and the timestamp is a raw TSC reading that is converted on the flush thread.
+// Each argument is a LogType tag followed by the raw value, or for strings the tag, a 4 byte length
+// and the characters. Nothing in the record is aligned so every field is read and written with memcpy.
+//
+// Created by Michael Lewis on 1/14/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGRECORD_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGRECORD_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "LogFile.hpp"
+#include "LogFormat.hpp"
+#include "LogLevel.hpp"
+#include "LogType.hpp"
+
+namespace BeaconTech::Common
+{
+
+    struct LogRecordHeader
+    {
+        std::uint64_t tsc;              // Raw TSC reading (see Clock::readTsc)
+        const char* format;             // String literal
+        const char* funcName;           // String literal
+        std::uint32_t formatLength;
+        std::uint32_t funcNameLength;
+        std::int32_t logLevel;
+        std::uint16_t classNameLength;
+    };
+
+    class LogRecord
+    {
+    private:
+        template<typename T>
+        inline static constexpr bool UNSUPPORTED_TYPE = false;
+
+        // Maps an argument type to the tag it is encoded with. Integers are widened to the nearest type
+        // in LogType, which matches the overloads the values were previously promoted to
+        template<typename T>
+        static constexpr LogType logType() noexcept
+        {
+            using U = std::remove_cvref_t<T>;
+
+            if constexpr (std::is_same_v<U, char>) return LogType::CHAR;
+            else if constexpr (std::is_convertible_v<const U&, std::string_view>) return LogType::STRING;
+            else if constexpr (std::is_same_v<U, float>) return LogType::FLOAT;
+            else if constexpr (std::is_floating_point_v<U>) return LogType::DOUBLE;
+            else if constexpr (std::is_same_v<U, long>) return LogType::LONG_INTEGER;
+            else if constexpr (std::is_same_v<U, long long>) return LogType::LONG_LONG_INTEGER;
+            else if constexpr (std::is_same_v<U, unsigned long>) return LogType::UNSIGNED_LONG_INTEGER;
+            else if constexpr (std::is_same_v<U, unsigned long long>) return LogType::UNSIGNED_LONG_LONG_INTEGER;
+            else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) return LogType::INTEGER;
+            else if constexpr (std::is_integral_v<U>) return LogType::UNSIGNED_INTEGER;
+            else static_assert(UNSUPPORTED_TYPE<T>, "Unsupported log argument type");
+        }
+
+        static constexpr std::size_t valueSize(LogType logType) noexcept
+        {
+            switch (logType)
+            {
+                case LogType::CHAR: return sizeof(char);
+                case LogType::INTEGER: return sizeof(int);
+                case LogType::LONG_INTEGER: return sizeof(long);
+                case LogType::LONG_LONG_INTEGER: return sizeof(long long);
+                case LogType::UNSIGNED_INTEGER: return sizeof(unsigned);
+                case LogType::UNSIGNED_LONG_INTEGER: return sizeof(unsigned long);
+                case LogType::UNSIGNED_LONG_LONG_INTEGER: return sizeof(unsigned long long);
+                case LogType::FLOAT: return sizeof(float);
+                case LogType::DOUBLE: return sizeof(double);
+                case LogType::STRING: return sizeof(std::uint32_t);
+            }
+
+            return 0;
+        }
+
+        template<typename T>
+        static std::size_t argSize(const T& value) noexcept
+        {
+            if constexpr (logType<T>() == LogType::STRING)
+            {
+                return 1 + sizeof(std::uint32_t) + std::string_view{value}.size();
+            }
+            else
+            {
+                constexpr std::size_t size = 1 + valueSize(logType<T>());
+                return size;
+            }
+        }
+
+        static std::byte* copy(std::byte* out, const void* value, std::size_t bytes) noexcept
+        {
+            std::memcpy(out, value, bytes);
+            return out + bytes;
+        }
+
+        template<typename T>
+        static std::byte* encodeArg(std::byte* out, const T& value) noexcept
+        {
+            constexpr LogType type = logType<T>();
+            *out++ = static_cast<std::byte>(type);
+
+            if constexpr (type == LogType::STRING)
+            {
+                const std::string_view string{value};
+                const auto length = static_cast<std::uint32_t>(string.size());
+                out = copy(out, &length, sizeof(length));
+                return copy(out, string.data(), length);
+            }
+            else if constexpr (type == LogType::CHAR) return copy(out, &value, sizeof(char));
+            else if constexpr (type == LogType::FLOAT) return copy(out, &value, sizeof(float));
+            else if constexpr (type == LogType::DOUBLE)
+            {
+                const auto widened = static_cast<double>(value);
+                return copy(out, &widened, sizeof(widened));
+            }
+            else if constexpr (type == LogType::INTEGER)
+            {
+                const auto widened = static_cast<int>(value);
+                return copy(out, &widened, sizeof(widened));
+            }
+            else if constexpr (type == LogType::UNSIGNED_INTEGER)
+            {
+                const auto widened = static_cast<unsigned>(value);
+                return copy(out, &widened, sizeof(widened));
+            }
+            else return copy(out, &value, sizeof(value));
+        }
+
+        static std::uint16_t nameLength(std::string_view name) noexcept
+        {
+            return static_cast<std::uint16_t>(std::min<std::size_t>(name.size(),
+                                                                    std::numeric_limits<std::uint16_t>::max()));
+        }
+
+    public:
+        // The number of bytes needed to encode the log call
+        template<typename... Args>
+        static std::size_t encodedSize(std::string_view className, const Args&... args) noexcept
+        {
+            return sizeof(LogRecordHeader) + nameLength(className) + (0 + ... + argSize(args));
+        }
+
+        // Encodes the log call into a record of encodedSize() bytes
+        template<typename... Args>
+        static void encode(std::byte* record, const LogLevel& logLevel, std::uint64_t tsc,
+                           std::string_view className, LogLiteral funcName, LogFormat<Args...> format,
+                           const Args&... args) noexcept
+        {
+            const LogRecordHeader header{tsc, format.data, funcName.data, format.size, funcName.size,
+                                         static_cast<std::int32_t>(logLevel), nameLength(className)};
+
+            std::byte* out = copy(record, &header, sizeof(header));
+            out = copy(out, className.data(), header.classNameLength);
+            ((out = encodeArg(out, args)), ...);
+        }
+
+        // The TSC reading of an encoded record
+        static std::uint64_t tsc(std::span<const std::byte> record) noexcept
+        {
+            std::uint64_t tsc;
+            std::memcpy(&tsc, record.data() + offsetof(LogRecordHeader, tsc), sizeof(tsc));
+            return tsc;
+        }
+
+        static void write(LogFile& file, std::span<const std::byte> record, std::uint32_t engineId);
+
+        // Deleted default ctors and assignment operators
+        LogRecord() = delete;
+    };
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGRECORD_HPP
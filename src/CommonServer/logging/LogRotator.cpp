@@ -0,0 +1,274 @@
+//
+// Rotates log files by size and/or age. The flush workers only swap file descriptors; the renames,
+// compression and retention of closed segments happen on a low priority background thread.
+//
+// Created by Michael Lewis on 1/18/24.
+//
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <zstd.h>
+
+#include "LogRotator.hpp"
+#include "LogFile.hpp"
+#include "LogLevel.hpp"
+#include "../concurrency/ThreadFactory.hpp"
+#include "../utils/ConfigManager.hpp"
+
+namespace BeaconTech::Common
+{
+    namespace
+    {
+        // <yyyymmdd_HHMMSS>_<app>.log, the same naming the clean up script used for its archives
+        std::string archiveName(std::chrono::system_clock::time_point rotationTime, const std::string& baseName)
+        {
+            const std::time_t time = std::chrono::system_clock::to_time_t(rotationTime);
+            std::tm tm{};
+            localtime_r(&time, &tm);
+
+            char timestamp[32];
+            std::strftime(timestamp, sizeof(timestamp), "%Y%m%d_%H%M%S", &tm);
+            return std::string{timestamp} + "_" + baseName;
+        }
+
+        // Runs the thread at the lowest nice level. Not SCHED_IDLE, which could starve the thread
+        // forever on a host whose cores are all busy spinning
+        void lowerThreadPriority()
+        {
+#ifdef __linux__
+            setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), 19);
+#endif
+        }
+    }
+
+    LogRotator::LogRotator()
+        : compressLevel{static_cast<int>(ConfigManager::config().logCompressLevel)},
+          archiveBytes{static_cast<std::uintmax_t>(ConfigManager::config().logArchiveMegabytes)
+                       * 1024 * 1024},
+          running{true}
+    {
+        thread = ThreadFactory::createThread("log-compressor", [this]() { run(); });
+    }
+
+    LogRotator::~LogRotator()
+    {
+        stop();
+    }
+
+    void LogRotator::prepare(LogFile& file)
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        rotations.push_back(LogRotation{&file, -1, std::chrono::system_clock::now()});
+        condition.notify_one();
+    }
+
+    void LogRotator::rotated(LogFile& file, int closedFd)
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        rotations.push_back(LogRotation{&file, closedFd, std::chrono::system_clock::now()});
+        condition.notify_one();
+    }
+
+    // Finishes every queued rotation, including the compression, before the thread exits
+    void LogRotator::stop()
+    {
+        {
+            const std::lock_guard<std::mutex> lock{mutex};
+            running = false;
+        }
+
+        condition.notify_one();
+        if (thread.joinable()) thread.join();
+    }
+
+    // Standby segments are opened for every queued rotation before any segment is compressed, so a
+    // long compression never holds up the next rotation of another file
+    void LogRotator::run()
+    {
+        lowerThreadPriority();
+
+        while (true)
+        {
+            std::deque<LogRotation> batch;
+            {
+                std::unique_lock<std::mutex> lock{mutex};
+                condition.wait(lock, [this]() { return !rotations.empty() || !running; });
+                if (rotations.empty()) return;
+
+                batch.swap(rotations);
+            }
+
+            std::vector<std::pair<std::filesystem::path, std::string>> archived;
+            for (const LogRotation& rotation : batch)
+            {
+                if (rotation.closedFd >= 0)
+                {
+                    auto path = archive(rotation);
+
+                    // The standby segment is still in use under its standby name, so rotation stops
+                    if (path.empty()) continue;
+
+                    archived.emplace_back(path, std::filesystem::path{rotation.file->getFileName()}.filename());
+                }
+
+                openStandby(*rotation.file);
+            }
+
+            for (const auto& [path, baseName] : archived)
+            {
+                compress(path);
+                if (archiveBytes > 0) enforceRetention(path.parent_path(), baseName);
+            }
+        }
+    }
+
+    void LogRotator::openStandby(LogFile& file)
+    {
+        const std::string standbyName = file.getStandbyName();
+        const int standby = open(standbyName.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (standby < 0)
+        {
+            std::cerr << LogLevel::SEVERE.getDesc() << " : Unable to open log segment " << standbyName
+                      << " - " << std::strerror(errno) << std::endl;
+            return;
+        }
+
+        file.setStandby(standby);
+    }
+
+    // Moves the closed segment into the ARCHIVE directory and the standby segment, which the flush worker
+    // is already writing to, into its place. Returns the archived path, or an empty path on failure
+    std::filesystem::path LogRotator::archive(const LogRotation& rotation)
+    {
+        LogFile& file = *rotation.file;
+        if (file.getFsyncPolicy() != LogFsyncPolicy::NEVER) fdatasync(rotation.closedFd);
+        close(rotation.closedFd);
+
+        const std::filesystem::path fileName{file.getFileName()};
+        const std::filesystem::path archiveDir = fileName.parent_path() / "ARCHIVE";
+
+        std::error_code error;
+        std::filesystem::create_directories(archiveDir, error);
+
+        const std::string name = archiveName(rotation.rotationTime, fileName.filename().string());
+        std::filesystem::path path = archiveDir / name;
+        for (int i = 1; std::filesystem::exists(path) || std::filesystem::exists(path.string() + ".zst"); ++i)
+        {
+            path = archiveDir / (name + "." + std::to_string(i));
+        }
+
+        std::filesystem::rename(fileName, path, error);
+        if (!error) std::filesystem::rename(file.getStandbyName(), fileName, error);
+        if (error)
+        {
+            std::cerr << LogLevel::SEVERE.getDesc() << " : Unable to archive log segment " << fileName
+                      << " - " << error.message() << std::endl;
+            return {};
+        }
+
+        return path;
+    }
+
+    // Compresses the archived segment to <path>.zst and removes the uncompressed segment. The segment
+    // is kept as is if it cannot be compressed
+    void LogRotator::compress(const std::filesystem::path& path)
+    {
+        const std::string compressedPath = path.string() + ".zst";
+        std::ifstream in{path, std::ios::binary};
+        std::ofstream out{compressedPath, std::ios::binary | std::ios::trunc};
+        if (!in.is_open() || !out.is_open())
+        {
+            std::cerr << LogLevel::WARN.getDesc() << " : Unable to compress log segment " << path << std::endl;
+            return;
+        }
+
+        std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> context{ZSTD_createCCtx(), &ZSTD_freeCCtx};
+        ZSTD_CCtx_setParameter(context.get(), ZSTD_c_compressionLevel, compressLevel);
+
+        std::vector<char> input(ZSTD_CStreamInSize());
+        std::vector<char> output(ZSTD_CStreamOutSize());
+        bool failed = false;
+
+        while (!failed)
+        {
+            in.read(input.data(), static_cast<std::streamsize>(input.size()));
+            const auto bytesRead = static_cast<std::size_t>(in.gcount());
+            const bool lastChunk = bytesRead < input.size();
+            const ZSTD_EndDirective mode = lastChunk ? ZSTD_e_end : ZSTD_e_continue;
+
+            ZSTD_inBuffer inBuffer{input.data(), bytesRead, 0};
+            bool finished = false;
+            while (!finished)
+            {
+                ZSTD_outBuffer outBuffer{output.data(), output.size(), 0};
+                const std::size_t remaining = ZSTD_compressStream2(context.get(), &outBuffer, &inBuffer, mode);
+                if (ZSTD_isError(remaining))
+                {
+                    std::cerr << LogLevel::WARN.getDesc() << " : Unable to compress log segment " << path
+                              << " - " << ZSTD_getErrorName(remaining) << std::endl;
+                    failed = true;
+                    break;
+                }
+
+                out.write(output.data(), static_cast<std::streamsize>(outBuffer.pos));
+                finished = lastChunk ? remaining == 0 : inBuffer.pos == inBuffer.size;
+            }
+
+            if (lastChunk) break;
+        }
+
+        out.close();
+        std::error_code error;
+        if (failed || !out)
+        {
+            std::filesystem::remove(compressedPath, error);
+            return;
+        }
+
+        std::filesystem::remove(path, error);
+    }
+
+    // Deletes the oldest archives of the application until its archives fit in logArchiveMegabytes. The
+    // archive names start with the rotation time, so name order is age order
+    void LogRotator::enforceRetention(const std::filesystem::path& archiveDir, const std::string& baseName)
+    {
+        constexpr std::size_t TIMESTAMP_LENGTH = 16;    // yyyymmdd_HHMMSS_
+
+        std::vector<std::pair<std::string, std::uintmax_t>> archives;
+        std::uintmax_t totalBytes = 0;
+
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator{archiveDir, error})
+        {
+            const std::string name = entry.path().filename().string();
+            // Matches <timestamp>_<app>.log followed by nothing, .zst or a .N suffix
+            const std::size_t end = TIMESTAMP_LENGTH + baseName.size();
+            if (!entry.is_regular_file() || name.size() < end || name.compare(TIMESTAMP_LENGTH, baseName.size(), baseName) != 0
+                || (name.size() > end && name[end] != '.')) continue;
+
+            const std::uintmax_t bytes = entry.file_size(error);
+            archives.emplace_back(name, bytes);
+            totalBytes += bytes;
+        }
+
+        std::sort(archives.begin(), archives.end());
+        for (const auto& [name, bytes] : archives)
+        {
+            if (totalBytes <= archiveBytes) break;
+
+            std::filesystem::remove(archiveDir / name, error);
+            totalBytes -= bytes;
+        }
+    }
+} // namespace BeaconTech::Common
@@ -0,0 +1,94 @@
+//
+// Rotates log files by size and/or age without the flush workers touching the file system. Each LogFile
+// keeps a standby segment (<app>.log.next) that this class opens ahead of time, so a rotation on the
+// flush worker is only a swap of file descriptors. The renames, compression and clean up of the closed
+// segment happen on a single low priority background thread (role log-compressor):
+//
+// 1) <app>.log is renamed to ARCHIVE/<yyyymmdd_HHMMSS>_<app>.log and <app>.log.next to <app>.log
+// 2) A new standby segment is opened
+// 3) The archived segment is compressed with zstd to ARCHIVE/<yyyymmdd_HHMMSS>_<app>.log.zst
+// 4) The oldest archives of the application are deleted while they exceed logArchiveMegabytes
+//
+// If the standby segment is not ready when a rotation is due, the worker keeps writing to the current
+// segment and rotates on a later pass.
+//
+//   "logRotateMegabytes": "256"    (0 disables size based rotation)
+//   "logRotateMinutes": "1440"     (0 disables time based rotation)
+//   "logCompressLevel": "3"
+//   "logArchiveMegabytes": "4096"  (0 keeps every archive)
+//
+// Created by Michael Lewis on 1/18/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGROTATOR_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGROTATOR_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace BeaconTech::Common
+{
+
+    class LogFile;
+
+    struct LogRotation
+    {
+        LogFile* file;
+        int closedFd;       // The segment that was replaced, or -1 if only a standby segment is needed
+        std::chrono::system_clock::time_point rotationTime;
+    };
+
+    class LogRotator final
+    {
+    private:
+        const int compressLevel;
+        const std::uintmax_t archiveBytes;
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<LogRotation> rotations;
+        bool running;
+        std::thread thread;
+
+        void run();
+
+        void openStandby(LogFile& file);
+
+        std::filesystem::path archive(const LogRotation& rotation);
+
+        void compress(const std::filesystem::path& path);
+
+        void enforceRetention(const std::filesystem::path& archiveDir, const std::string& baseName);
+
+    public:
+        LogRotator();
+
+        ~LogRotator();
+
+        // Called by a LogFile to request a standby segment
+        void prepare(LogFile& file);
+
+        // Called by a flush worker after it has switched the file to its standby segment
+        void rotated(LogFile& file, int closedFd);
+
+        void stop();
+
+        // Deleted default ctors and assignment operators
+        LogRotator(const LogRotator& other) = delete;
+
+        LogRotator(LogRotator&& other) = delete;
+
+        LogRotator& operator=(const LogRotator& other) = delete;
+
+        LogRotator& operator=(LogRotator&& other) = delete;
+    };
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGROTATOR_HPP
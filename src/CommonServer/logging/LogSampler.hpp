@@ -0,0 +1,137 @@
+//
+// Samplers that thin out log calls made on every tick, e.g. a line per BBO. Each sampler decides
+// whether a call is logged:
+//
+// 1) EveryNSampler    - Every Nth call (the Nth, 2Nth, ...)
+// 2) RateLimitSampler - At most K calls per second on average for each key (e.g. an instrumentId)
+// 3) ChangeSampler    - The first call after the value of a key changes
+//
+// The samplers are not thread safe. The LOG_EVERY_N, LOG_RATE_LIMITED and LOG_ON_CHANGE macros give
+// every call site its own thread local sampler, so each thread keeps its own counters without sharing
+// a cache line with the other engines, and the arguments are only evaluated for calls that are logged:
+//
+//   LOG_RATE_LIMITED(logger, INFO, 10, instrumentId, CLASS, "onBook", "instrumentId=% bid=%", instrumentId, bid);
+//
+// Created by Michael Lewis on 1/19/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGSAMPLER_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGSAMPLER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+
+#include "Logger.hpp"
+
+namespace BeaconTech::Common
+{
+
+    class EveryNSampler
+    {
+    private:
+        std::uint64_t n;
+        std::uint64_t count;
+
+    public:
+        explicit EveryNSampler(std::uint64_t n) : n{std::max<std::uint64_t>(n, 1)}, count{0} {}
+
+        inline bool sample() noexcept
+        {
+            if (++count < n) [[likely]] return false;
+
+            count = 0;
+            return true;
+        }
+    };
+
+    class RateLimitSampler
+    {
+    private:
+        struct Bucket
+        {
+            std::chrono::steady_clock::time_point lastRefill;
+            double tokens;
+        };
+
+        double maxPerSecond;
+        std::unordered_map<std::uint64_t, Bucket> buckets;     // key -> token bucket
+
+    public:
+        explicit RateLimitSampler(std::uint32_t maxPerSecond) : maxPerSecond{static_cast<double>(maxPerSecond)} {}
+
+        // A token bucket per key that holds up to K tokens and refills at K tokens per second. A call is
+        // logged when it can take a token, so a key logs K calls per second at most on average, and no
+        // more than K + K * T calls in any T seconds (a full bucket, then the refill). The clock is read on
+        // every call
+        inline bool sample(std::uint64_t key = 0)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            auto [it, inserted] = buckets.try_emplace(key, Bucket{now, maxPerSecond});
+
+            Bucket& bucket = it->second;
+            if (!inserted)
+            {
+                const std::chrono::duration<double> elapsed = now - bucket.lastRefill;
+                bucket.tokens = std::min(bucket.tokens + elapsed.count() * maxPerSecond, maxPerSecond);
+                bucket.lastRefill = now;
+            }
+
+            if (bucket.tokens < 1.0) return false;
+
+            bucket.tokens -= 1.0;
+            return true;
+        }
+    };
+
+    template<typename Value>
+    class ChangeSampler
+    {
+    private:
+        std::unordered_map<std::uint64_t, Value> values;   // key -> last logged value
+
+    public:
+        ChangeSampler() = default;
+
+        inline bool sample(std::uint64_t key, const Value& value)
+        {
+            auto [it, inserted] = values.try_emplace(key, value);
+            if (inserted) return true;
+            if (it->second == value) [[likely]] return false;
+
+            it->second = value;
+            return true;
+        }
+    };
+
+} // namespace BeaconTech::Common
+
+// level is one of DEBUG, INFO, WARN or SEVERE. Disabled levels skip the sampler as well as the log call
+#define BEACONTECH_LOG_SAMPLED(logger, level, samplerType, samplerArgs, sampleCall, className, funcName, ...) \
+    do                                                                                                  \
+    {                                                                                                   \
+        if constexpr (BeaconTech::Common::LogLevel::isCompiledIn(BeaconTech::Common::LogLevel::level##_ID)) \
+        {                                                                                               \
+            if ((logger).isEnabled(BeaconTech::Common::LogLevel::level##_ID))                           \
+            {                                                                                           \
+                thread_local samplerType logSampler samplerArgs;                                        \
+                if (logSampler.sampleCall) LOG_##level(logger, className, funcName, __VA_ARGS__);      \
+            }                                                                                           \
+        }                                                                                               \
+    } while (false)
+
+#define LOG_EVERY_N(logger, level, n, className, funcName, ...) \
+    BEACONTECH_LOG_SAMPLED(logger, level, BeaconTech::Common::EveryNSampler, (n), sample(), className, funcName, __VA_ARGS__)
+
+#define LOG_RATE_LIMITED(logger, level, maxPerSecond, key, className, funcName, ...)                    \
+    BEACONTECH_LOG_SAMPLED(logger, level, BeaconTech::Common::RateLimitSampler, (maxPerSecond), sample(key), \
+                           className, funcName, __VA_ARGS__)
+
+#define LOG_ON_CHANGE(logger, level, key, value, className, funcName, ...)                                \
+    BEACONTECH_LOG_SAMPLED(logger, level,                                                                 \
+                           BeaconTech::Common::ChangeSampler<std::remove_cvref_t<decltype(value)>>, {},   \
+                           sample(key, value), className, funcName, __VA_ARGS__)
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGSAMPLER_HPP
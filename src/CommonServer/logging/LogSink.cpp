@@ -0,0 +1,206 @@
+//
+// A log file and the Loggers that write to it. The sink is only ever written by one flush worker,
+// which merges the lanes of every Logger into one timestamp ordered file and batches the lines into
+// as few write syscalls as the flush policy allows.
+//
+// Created by Michael Lewis on 1/16/24.
+//
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <span>
+#include <utility>
+
+#include "LogSink.hpp"
+#include "LogLevel.hpp"
+#include "LogRecord.hpp"
+#include "../utils/Clock.hpp"
+#include "../utils/ConfigManager.hpp"
+
+namespace BeaconTech::Common
+{
+    namespace
+    {
+        // The directory must exist before the LogFile member opens the file
+        std::string createLogFileName(const std::string& directory, const std::string& appName)
+        {
+            std::filesystem::create_directories(directory);
+            return directory + appName + ".log";
+        }
+    }
+
+    LogSink::LogSink(std::string directory, const std::string& appName, LogRotator& rotator)
+        : directory{std::move(directory)}, fileName{createLogFileName(this->directory, appName)},
+          file{fileName, rotator},
+          hasPendingSources{false},
+          records{MetricsRegistry::getInstance().counter("log.records", "file=" + appName + ".log")},
+          droppedRecords{MetricsRegistry::getInstance().counter("log.droppedRecords", "file=" + appName + ".log")},
+          statsInterval{ConfigManager::config().logStatsSeconds},
+          lastStatsTime{std::chrono::steady_clock::now()}, lastStatsWrites{0}, lastStatsBytes{0}
+    {
+
+    }
+
+    // The LogFile writes whatever is still buffered when it is destroyed
+    LogSink::~LogSink() = default;
+
+    // Called from any thread when a Logger is created
+    void LogSink::addSource(std::shared_ptr<LogSource> source)
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        pendingSources.push_back(std::move(source));
+        hasPendingSources.store(true, std::memory_order_release);
+    }
+
+    void LogSink::adoptPendingSources()
+    {
+        if (!hasPendingSources.load(std::memory_order_acquire)) [[likely]] return;
+
+        const std::lock_guard<std::mutex> lock{mutex};
+        sources.insert(sources.end(), pendingSources.begin(), pendingSources.end());
+        pendingSources.clear();
+        hasPendingSources.store(false, std::memory_order_relaxed);
+    }
+
+    // Writes up to MAX_RECORDS_PER_PASS records, always taking the oldest record at the head of the lanes
+    // next. The lanes are scanned once per pass and kept in a heap, so only the lane that was written is
+    // read again. Records are ordered by their converted time rather than the raw reading, because records
+    // taken before the clock source was selected are system clock readings. Returns true if anything was
+    // written
+    bool LogSink::writeRecords()
+    {
+        adoptPendingSources();
+
+        const auto newerThan = [](const LaneHead& lhs, const LaneHead& rhs) { return lhs.epochNanos > rhs.epochNanos; };
+
+        heads.clear();
+        for (const auto& source : sources)
+        {
+            const std::size_t count = source->readableLanes();
+            for (std::size_t lane = 0; lane < count; ++lane)
+            {
+                ByteRing* ring = source->getLane(lane);
+                auto record = ring->read();
+                if (record.empty()) continue;
+
+                heads.push_back(LaneHead{Clock::tscToEpochNanos(LogRecord::tsc(record)), ring, source.get(), record});
+            }
+        }
+        std::make_heap(heads.begin(), heads.end(), newerThan);
+
+        std::size_t written = 0;
+        while (!heads.empty() && written < MAX_RECORDS_PER_PASS)
+        {
+            std::pop_heap(heads.begin(), heads.end(), newerThan);
+            LaneHead& oldest = heads.back();
+
+            try
+            {
+                LogRecord::write(file, oldest.record, oldest.source->getEngineId());
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << LogLevel::SEVERE.getDesc() << " : Unable to write log record to "
+                          << fileName << " - " << e.what() << std::endl;
+            }
+
+            oldest.ring->release();
+            records.add();
+            ++written;
+
+            oldest.record = oldest.ring->read();
+            if (oldest.record.empty())
+            {
+                heads.pop_back();
+                continue;
+            }
+
+            oldest.epochNanos = Clock::tscToEpochNanos(LogRecord::tsc(oldest.record));
+            std::push_heap(heads.begin(), heads.end(), newerThan);
+        }
+
+        for (const auto& source : sources) reportDroppedRecords(*source);
+        removeClosedSources();
+        reportStatsIfDue();
+
+        return written > 0;
+    }
+
+    // Writes a line for the records that were dropped because a lane was full
+    void LogSink::reportDroppedRecords(LogSource& source)
+    {
+        const std::uint64_t dropped = source.takeDroppedRecords();
+        if (dropped == 0) [[likely]] return;
+
+        droppedRecords.add(dropped);
+        file.append(Clock::getLocalDateAndTime());
+        file.append(" " + LogLevel::WARN.getDesc() + "  LogSink writeRecords [CLFQ-");
+        file.appendNumber(source.getEngineId());
+        file.append("]: Dropped ");
+        file.appendNumber(dropped);
+        file.append(" log records because a log lane was full\n");
+    }
+
+    // Writes a line with the write syscall rate and the average bytes per syscall since the last report
+    void LogSink::reportStatsIfDue()
+    {
+        if (statsInterval.count() == 0) return;
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastStatsTime < statsInterval) [[likely]] return;
+
+        const double seconds = std::chrono::duration<double>(now - lastStatsTime).count();
+        const std::uint64_t writes = file.getWrites() - lastStatsWrites;
+        const std::uint64_t bytes = file.getBytesWritten() - lastStatsBytes;
+
+        file.append(Clock::getLocalDateAndTime());
+        file.append(" " + LogLevel::INFO.getDesc() + "  LogSink reportStats [");
+        file.append(std::filesystem::path(fileName).filename().string());
+        file.append("]: Writes/sec=");
+        file.appendNumber(static_cast<double>(writes) / seconds);
+        file.append(" Bytes/write=");
+        file.appendNumber(writes == 0 ? 0.0 : static_cast<double>(bytes) / static_cast<double>(writes));
+        file.append(" Fsyncs=");
+        file.appendNumber(file.getFsyncs());
+        file.append('\n');
+
+        lastStatsTime = now;
+        lastStatsWrites = file.getWrites();
+        lastStatsBytes = file.getBytesWritten();
+    }
+
+    // Writes the buffered lines once the oldest has waited logFlushMicros and rotates the file when due
+    void LogSink::flushIfDue()
+    {
+        file.flushIfDue();
+        file.rotateIfDue();
+    }
+
+    void LogSink::flush()
+    {
+        file.flush();
+    }
+
+    // Releases the lanes of destroyed Loggers once every record they published has been written.
+    // The Logger publishes its last record before it closes the source, so a closed source without
+    // records can never receive another record
+    void LogSink::removeClosedSources()
+    {
+        std::erase_if(sources, [](const auto& source) { return source->isClosed() && !source->hasRecords(); });
+    }
+
+    bool LogSink::hasRecords() const noexcept
+    {
+        if (hasPendingSources.load(std::memory_order_acquire)) return true;
+
+        return std::any_of(sources.cbegin(), sources.cend(), [](const auto& source) {
+            return source->hasRecords() || source->isClosed();
+        });
+    }
+
+    const std::string& LogSink::getFileName() const noexcept
+    {
+        return fileName;
+    }
+} // namespace BeaconTech::Common
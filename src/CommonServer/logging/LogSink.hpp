@@ -0,0 +1,120 @@
+//
+// A log file and the Loggers that write to it. Every Logger of an application (e.g. the StrategyServer
+// and each StrategyEngine of STRATEGIES) writes to the same sink, and the sink is only ever written by
+// one flush worker, so the file has a single writer and the lanes of every Logger can be merged into
+// one timestamp ordered file.
+//
+// Records that are published late (e.g. a producer is descheduled between taking the timestamp and
+// publishing) can appear after records with later timestamps from other lanes, but the records of
+// each lane are always written in order.
+//
+// Each call to writeRecords writes at most MAX_RECORDS_PER_PASS records and returns, so a sink that is
+// logged to without pause never keeps its flush worker from the other sinks it owns or from flushing,
+// rotating and reporting on time.
+//
+// Formatted lines are batched in the LogFile's buffer, which is written when it fills or when its oldest
+// line is logFlushMicros old. Every logStatsSeconds (0 disables) the sink logs how many write syscalls
+// it made and how many bytes each one carried on average.
+//
+//   "logStatsSeconds": "60"
+//
+// Created by Michael Lewis on 1/16/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGSINK_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGSINK_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "LogFile.hpp"
+#include "LogRotator.hpp"
+#include "LogSource.hpp"
+#include "../telemetry/MetricsRegistry.hpp"
+
+namespace BeaconTech::Common
+{
+
+    class LogSink final
+    {
+    private:
+        static constexpr std::size_t MAX_RECORDS_PER_PASS = 4096;
+
+        // The record at the head of a lane
+        struct LaneHead
+        {
+            std::int64_t epochNanos;
+            ByteRing* ring;
+            const LogSource* source;
+            std::span<const std::byte> record;
+        };
+
+        const std::string directory;
+        const std::string fileName;
+        LogFile file;
+
+        // Sources are added by the threads that create Loggers and adopted by the flush worker
+        std::mutex mutex;
+        std::vector<std::shared_ptr<LogSource>> pendingSources;
+        std::atomic<bool> hasPendingSources;
+
+        // Flush worker only state
+        std::vector<std::shared_ptr<LogSource>> sources;
+        std::vector<LaneHead> heads;    // Min heap on epochNanos, reused by every pass
+
+        // Published as log.records and log.droppedRecords
+        Counter& records;
+        Counter& droppedRecords;
+
+        // Write syscall statistics
+        const std::chrono::seconds statsInterval;
+        std::chrono::steady_clock::time_point lastStatsTime;
+        std::uint64_t lastStatsWrites;
+        std::uint64_t lastStatsBytes;
+
+        void adoptPendingSources();
+
+        void reportDroppedRecords(LogSource& source);
+
+        void removeClosedSources();
+
+        void reportStatsIfDue();
+
+    public:
+        LogSink(std::string directory, const std::string& appName, LogRotator& rotator);
+
+        ~LogSink();
+
+        void addSource(std::shared_ptr<LogSource> source);
+
+        bool writeRecords();
+
+        void flushIfDue();
+
+        void flush();
+
+        bool hasRecords() const noexcept;
+
+        const std::string& getFileName() const noexcept;
+
+        // Deleted default ctors and assignment operators
+        LogSink() = delete;
+
+        LogSink(const LogSink& other) = delete;
+
+        LogSink(LogSink&& other) = delete;
+
+        LogSink& operator=(const LogSink& other) = delete;
+
+        LogSink& operator=(LogSink&& other) = delete;
+    };
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGSINK_HPP
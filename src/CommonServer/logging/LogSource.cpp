@@ -0,0 +1,99 @@
+//
+// The lanes of one Logger. Every thread that logs through the Logger is given its own single producer
+// lane, so logging never takes a lock or writes to a cache line another producer writes to.
+//
+// Created by Michael Lewis on 1/16/24.
+//
+
+#include <algorithm>
+#include <utility>
+
+#include "LogSource.hpp"
+
+namespace BeaconTech::Common
+{
+    LogSource::LogSource(std::string name, std::uint32_t engineId, std::size_t laneSize, std::size_t maxLanes,
+                         ConfiguredIdleStrategy& idleStrategy)
+        : name{std::move(name)}, engineId{engineId}, laneSize{laneSize}, lanes(std::max<std::size_t>(maxLanes, 1)),
+          numLanes{0}, overflowLane{}, droppedRecords{0}, closed{false}, idleStrategy{idleStrategy}
+    {
+
+    }
+
+    // Gives the calling thread its own lane. Only called the first time a thread logs to the source
+    ByteRing* LogSource::registerLane()
+    {
+        const std::lock_guard<std::mutex> lock{registrationMutex};
+
+        const std::size_t lane = numLanes.load(std::memory_order_relaxed);
+        if (lane == lanes.size()) return overflowLane.get();
+
+        lanes[lane] = std::make_unique<ByteRing>("logger-" + name + "-lane-" + std::to_string(lane), laneSize);
+
+        // The overflow lane is created before the last lane is published so that it never changes
+        // once the flush worker can see it
+        if (lane + 1 == lanes.size())
+        {
+            overflowLane = std::make_unique<ByteRing>("logger-" + name + "-lane-overflow", laneSize);
+        }
+
+        numLanes.store(lane + 1, std::memory_order_release);
+        return lanes[lane].get();
+    }
+
+    bool LogSource::isOverflowLane(const ByteRing* lane) const noexcept
+    {
+        return lane == overflowLane.get();
+    }
+
+    std::mutex& LogSource::getOverflowMutex() noexcept
+    {
+        return overflowMutex;
+    }
+
+    // The number of lanes the flush worker can read, including the overflow lane once it exists
+    std::size_t LogSource::readableLanes() const noexcept
+    {
+        const std::size_t count = numLanes.load(std::memory_order_acquire);
+        return count == lanes.size() ? count + 1 : count;
+    }
+
+    // Returns the lane at an index below readableLanes(). The last lane is the overflow lane
+    ByteRing* LogSource::getLane(std::size_t lane) const noexcept
+    {
+        return lane < lanes.size() ? lanes[lane].get() : overflowLane.get();
+    }
+
+    bool LogSource::hasRecords() const noexcept
+    {
+        const std::size_t count = readableLanes();
+        for (std::size_t lane = 0; lane < count; ++lane)
+        {
+            if (getLane(lane)->size()) return true;
+        }
+
+        return false;
+    }
+
+    std::uint64_t LogSource::takeDroppedRecords() noexcept
+    {
+        return droppedRecords.exchange(0, std::memory_order_relaxed);
+    }
+
+    // Marks the source for removal once the flush worker has drained it
+    void LogSource::close() noexcept
+    {
+        closed.store(true, std::memory_order_release);
+        idleStrategy.wake();
+    }
+
+    bool LogSource::isClosed() const noexcept
+    {
+        return closed.load(std::memory_order_acquire);
+    }
+
+    std::uint32_t LogSource::getEngineId() const noexcept
+    {
+        return engineId;
+    }
+} // namespace BeaconTech::Common
@@ -0,0 +1,98 @@
+//
+// The lanes of one Logger. Every thread that logs through the Logger is given its own single producer
+// lane, so logging never takes a lock or writes to a cache line another producer writes to. Lanes are
+// allocated when a thread first logs and are never removed while the source is alive, so the flush
+// worker only needs the lane count to find them.
+//
+// Once maxLanes threads have registered, any further threads share one overflow lane under a mutex.
+//
+// Created by Michael Lewis on 1/16/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGSOURCE_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGSOURCE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../concurrency/IdleStrategy.hpp"
+#include "../datastructures/ByteRing.hpp"
+
+namespace BeaconTech::Common
+{
+
+    class LogSource final
+    {
+    private:
+        const std::string name;     // Identifies the lanes in the memory report (e.g. STRATEGIES-0)
+        const std::uint32_t engineId;
+        const std::size_t laneSize;
+
+        std::vector<std::unique_ptr<ByteRing>> lanes;
+        std::atomic<std::size_t> numLanes;
+        std::unique_ptr<ByteRing> overflowLane;     // Created with the last lane
+        std::mutex registrationMutex;
+        std::mutex overflowMutex;
+
+        std::atomic<std::uint64_t> droppedRecords;
+        std::atomic<bool> closed;
+
+        // The idle strategy of the flush worker that drains this source
+        ConfiguredIdleStrategy& idleStrategy;
+
+    public:
+        LogSource(std::string name, std::uint32_t engineId, std::size_t laneSize, std::size_t maxLanes,
+                  ConfiguredIdleStrategy& idleStrategy);
+
+        ~LogSource() = default;
+
+        ByteRing* registerLane();
+
+        bool isOverflowLane(const ByteRing* lane) const noexcept;
+
+        std::mutex& getOverflowMutex() noexcept;
+
+        std::size_t readableLanes() const noexcept;
+
+        ByteRing* getLane(std::size_t lane) const noexcept;
+
+        bool hasRecords() const noexcept;
+
+        inline void recordDropped() noexcept
+        {
+            droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::uint64_t takeDroppedRecords() noexcept;
+
+        inline void wake() noexcept
+        {
+            idleStrategy.wake();
+        }
+
+        void close() noexcept;
+
+        bool isClosed() const noexcept;
+
+        std::uint32_t getEngineId() const noexcept;
+
+        // Deleted default ctors and assignment operators
+        LogSource() = delete;
+
+        LogSource(const LogSource& other) = delete;
+
+        LogSource(LogSource&& other) = delete;
+
+        LogSource& operator=(const LogSource& other) = delete;
+
+        LogSource& operator=(LogSource&& other) = delete;
+    };
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGSOURCE_HPP
@@ -1,6 +1,6 @@
 //
 // A simple structure that holds the different types that will be logged by the system.
-// LogType is a discriminant for the LogElement to create a type-safe union.
+// LogType tags each argument of a binary log record so the flush thread can decode it.
 // This is used in favor of std::variant for performance reasons.
 //
 // Created by Michael Lewis on 12/18/23.
@@ -24,7 +24,8 @@ namespace BeaconTech::Common
         UNSIGNED_LONG_INTEGER = 5,
         UNSIGNED_LONG_LONG_INTEGER = 6,
         FLOAT = 7,
-        DOUBLE = 8
+        DOUBLE = 8,
+        STRING = 9
     };
 
 } // namespace BeaconTech::Common
@@ -1,8 +1,30 @@
 //
-// A high-performance logging utility that formats and writes to disk using a dedicated thread.
-// The system can enqueue log elements into a lock-free queue from the performance critical
-// thread and allow those elements to be formatted and written to disk on a dedicated,
-// non-performance critical thread.
+// A high-performance logging utility that formats and writes to disk using dedicated threads.
+// The performance critical thread only captures a TSC timestamp, a pointer to the compile time checked
+// format (see LogFormat.hpp) and the raw arguments of each log call into a single binary record in a
+// lock-free byte ring (see LogRecord.hpp). Timestamp rendering, substitution and formatting all happen
+// on a non-performance critical flush worker.
+//
+// A Logger is a lightweight handle. Its lanes (see LogSource.hpp) are registered with the
+// LoggerManager, which owns the flush workers and the log files, so creating a Logger per engine does
+// not add a thread or an open file per engine. Files are written to <filePath>/logs/<appName>.log, or
+// under logDirectory when it is configured, and are rotated in the background (see LogRotator.hpp).
+//
+// A logger is shared by several threads (e.g. the engine, feature engine and market maker of a
+// strategy), so every producing thread writes to its own single producer lane. A thread is given a
+// lane the first time it logs and finds it again through a thread local cache.
+//
+// Records are dropped rather than blocking the caller when a lane is full. The flush worker logs
+// how many records were dropped once the lane has room again.
+//
+// Log calls are filtered twice:
+// 1) At compile time, levels below BEACONTECH_LOG_MIN_LEVEL are discarded (see LogLevel.hpp)
+// 2) At runtime, levels below the logger's threshold are discarded. The threshold starts at the
+//    logLevel config value (DEBUG, INFO, WARN or ERROR, default INFO) and can be changed with setLevel()
+//
+// The LOG_* macros apply both filters before the arguments are evaluated, so they are the form to use
+// on the hot path, e.g. LOG_DEBUG(logger, CLASS, "onBook", "instrumentId=%", book.getInstrumentId()).
+// The logX methods apply the same filters, but only after the caller has evaluated the arguments.
 //
 // Created by Michael Lewis on 12/18/23.
 //
@@ -11,144 +33,156 @@
 #define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGGER_HPP
 
 #include <atomic>
-#include <sstream>
-#include <fstream>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <string>
-#include <thread>
+#include <string_view>
+#include <vector>
 
-#include "../datastructures/ConcurrentLockFreeQueue.hpp"
+#include "../datastructures/ByteRing.hpp"
+#include "../logging/LogFormat.hpp"
 #include "../logging/LogLevel.hpp"
-#include "../logging/LogElement.hpp"
+#include "../logging/LogRecord.hpp"
+#include "../logging/LogSource.hpp"
 #include "../utils/Clock.hpp"
 
 namespace BeaconTech::Common
 {
 
+    // The lane a thread writes to for one logger
+    struct LogLane
+    {
+        std::uint64_t loggerId{0};
+        ByteRing* ring{nullptr};
+        bool shared{false};     // The overflow lane, which is shared by threads beyond logLanes
+    };
+
     class Logger final
     {
     private:
-        // Log file info
-        const std::string directory;
-        const std::string fileName;
-        std::ofstream file;
-
-        // A lock-free queue that holds elements from the performance critical thread
-        // The elements are formatted and written to disk by a non-performance critical thread
-        mutable Common::ConcurrentLockFreeQueue<Common::LogElement> clfq;
-        std::atomic<bool> running;
-        uint32_t engineId;
-
-        // A logging thread that offloads IO from the critical path
-        std::thread loggerThread;
-        mutable std::mutex mutex;
-
-        void log(const char* s) const noexcept;
-
-        void createAndLogMsg(const std::string& className, const std::string& funcName, const char* s, const LogLevel& logLevel) const noexcept;
-
-        // Overloaded functions to write different log entry types to the lock free queue.
-        // Creates a LogElement of the correct type and writes it to the lock free queue.
-        void pushValue(const LogElement& logElement) const noexcept;
-
-        void pushValue(char value) const noexcept;
+        inline static std::atomic<std::uint64_t> nextLoggerId{1};
 
-        void pushValue(const char* value) const noexcept;
+        const std::uint64_t id;     // Unique for the life of the process, unlike the logger's address
+        std::shared_ptr<LogSource> source;
+        std::atomic<std::int32_t> threshold;    // The lowest level that is written
 
-        void pushValue(const std::string& value) const noexcept;
+        // Returns the calling thread's lane, registering one the first time the thread logs
+        const LogLane& lane() const
+        {
+            thread_local LogLane cached{};
+            if (cached.loggerId == id) [[likely]] return cached;
 
-        void pushValue(int value) const noexcept;
+            // A thread may log to several loggers, so remember every lane it has been given
+            thread_local std::vector<LogLane> registered{};
+            for (const LogLane& lane : registered)
+            {
+                if (lane.loggerId == id)
+                {
+                    cached = lane;
+                    return cached;
+                }
+            }
 
-        void pushValue(long value) const noexcept;
+            ByteRing* ring = source->registerLane();
+            cached = registered.emplace_back(LogLane{id, ring, source->isOverflowLane(ring)});
+            return cached;
+        }
 
-        void pushValue(long long value) const noexcept;
+        // Copies the log call into a single record and publishes it to the calling thread's lane
+        template<typename... Args>
+        void log(const LogLevel& logLevel, std::string_view className, LogLiteral funcName,
+                 LogFormat<Args...> format, const Args&... args) const noexcept
+        {
+            const std::size_t bytes = LogRecord::encodedSize(className, args...);
 
-        void pushValue(unsigned value) const noexcept;
+            try
+            {
+                const LogLane& laneRef = lane();
+                std::unique_lock<std::mutex> overflowLock{source->getOverflowMutex(), std::defer_lock};
+                if (laneRef.shared) [[unlikely]] overflowLock.lock();
 
-        void pushValue(unsigned long value) const noexcept;
+                // Taken after the lane is found so that registering a lane does not delay the record
+                // behind records with later timestamps
+                const std::uint64_t tsc = Clock::readTsc();
 
-        void pushValue(unsigned long long value) const noexcept;
+                std::byte* record = laneRef.ring->claim(bytes);
+                if (record == nullptr) [[unlikely]]
+                {
+                    source->recordDropped();
+                    return;
+                }
 
-        void pushValue(float value) const noexcept;
+                LogRecord::encode(record, logLevel, tsc, className, funcName, format, args...);
+                laneRef.ring->publish();
+            }
+            catch (const std::exception&)
+            {
+                // Registering a lane allocates, which can fail. The record is dropped rather than thrown
+                source->recordDropped();
+                return;
+            }
 
-        void pushValue(double value) const noexcept;
+            source->wake();
+        }
 
     public:
         explicit Logger(const std::string& filePath, const std::string& appName, uint32_t engineId);
 
         virtual ~Logger();
 
-        void flushQueue() noexcept;
-
-        // Overloaded functions that handles log elements with no substituted arguments
-        void logInfo(const std::string& className, const std::string& funcName, const char* s) const noexcept;
+        // Determines if a log call of the level would be written. A relaxed load, since a level change
+        // only needs to be seen eventually
+        inline bool isEnabled(std::int32_t levelId) const noexcept
+        {
+            return LogLevel::isCompiledIn(levelId) && levelId >= threshold.load(std::memory_order_relaxed);
+        }
 
-        void logWarn(const std::string& className, const std::string& funcName, const char* s) const noexcept;
+        // Changes the runtime threshold. Safe to call while other threads are logging
+        void setLevel(const LogLevel& logLevel) noexcept;
 
-        void logSevere(const std::string& className, const std::string& funcName, const char* s) const noexcept;
+        // Logs a debug message to disk. Each % in the format is substituted with the next argument
+        template<typename... Args>
+        void logDebug(const std::string& className, LogLiteral funcName,
+                      LogFormat<Args...> format, const Args&... args) const noexcept
+        {
+            if constexpr (LogLevel::isCompiledIn(LogLevel::DEBUG_ID))
+            {
+                if (isEnabled(LogLevel::DEBUG_ID)) log(LogLevel::DEBUG, className, funcName, format, args...);
+            }
+        }
 
-        // Overloaded functions that allows clients to specify the log level and the content to log
         // Logs an info message to disk
-        template<typename T, typename... Args>
-        void logInfo(const std::string& className, const std::string& funcName,
-                             const char* s, const T& value, Args... args) const noexcept
+        template<typename... Args>
+        void logInfo(const std::string& className, LogLiteral funcName,
+                     LogFormat<Args...> format, const Args&... args) const noexcept
         {
-            std::string dateAndTime = BeaconTech::Common::Clock::getLocalDateAndTime();
-            std::stringstream ss;
-            ss << std::this_thread::get_id();
-            std::string msg = dateAndTime + " " + LogLevel::INFO.getDesc() + "  " + className + " " + funcName
-                    + " [CLFQ-" + ss.str() + "]: " + s;
-
-            log(msg.c_str(), value, args...);
+            if constexpr (LogLevel::isCompiledIn(LogLevel::INFO_ID))
+            {
+                if (isEnabled(LogLevel::INFO_ID)) log(LogLevel::INFO, className, funcName, format, args...);
+            }
         }
 
         // Logs a warning message to disk
-        template<typename T, typename... Args>
-        void logWarn(const std::string &className, const std::string &funcName,
-                             const char *s, const T &value, Args ...args) const noexcept
+        template<typename... Args>
+        void logWarn(const std::string& className, LogLiteral funcName,
+                     LogFormat<Args...> format, const Args&... args) const noexcept
         {
-            std::string dateAndTime = BeaconTech::Common::Clock::getLocalDateAndTime();
-            std::string msg = dateAndTime + " " + LogLevel::WARN.getDesc() + "  " + className + " " + funcName + ": " + s;
-
-            log(msg.c_str(), value, args...);
+            if constexpr (LogLevel::isCompiledIn(LogLevel::WARN_ID))
+            {
+                if (isEnabled(LogLevel::WARN_ID)) log(LogLevel::WARN, className, funcName, format, args...);
+            }
         }
 
         // Logs an error message to disk
-        template<typename T, typename...Args>
-        void logSevere(const std::string &className, const std::string &funcName,
-                               const char *s, const T &value, Args ...args) const noexcept
-        {
-            std::string dateAndTime = BeaconTech::Common::Clock::getLocalDateAndTime();
-            std::string msg = dateAndTime + " " + LogLevel::SEVERE.getDesc() + "  " + className + " " + funcName + ": " + s;
-            log(msg.c_str(), value, args...);
-        }
-
-        // Formats the log string by substituting the % character with the values to be logged
-        // and pushes those characters into the CLFQ
-        template<typename T, typename... Args>
-        void log(const char* s, const T& value, Args... args) const noexcept
+        template<typename... Args>
+        void logSevere(const std::string& className, LogLiteral funcName,
+                       LogFormat<Args...> format, const Args&... args) const noexcept
         {
-            while (*s)
+            if constexpr (LogLevel::isCompiledIn(LogLevel::SEVERE_ID))
             {
-                if (*s == '%')
-                {
-                    // Allow %% -> % escape character
-                    if (*(s + 1) == '%') [[unlikely]]
-                    {
-                        ++s;
-                    }
-                    else
-                    {
-                        pushValue(value);
-                        log(s + 1, args...);
-                        return;
-                    }
-                }
-
-                pushValue(*s++);
+                if (isEnabled(LogLevel::SEVERE_ID)) log(LogLevel::SEVERE, className, funcName, format, args...);
             }
-
-            pushValue("\n");
         }
 
         // Deleted default ctors and assignment operators
@@ -165,4 +199,27 @@ namespace BeaconTech::Common
 
 } // BeaconTech::Common
 
+// Filters the log call before its arguments are evaluated. Calls below BEACONTECH_LOG_MIN_LEVEL are
+// discarded at compile time, although the format is still checked against the arguments
+#define BEACONTECH_LOG(logger, levelId, method, className, funcName, ...)                          \
+    do                                                                                              \
+    {                                                                                               \
+        if constexpr (BeaconTech::Common::LogLevel::isCompiledIn(levelId))                          \
+        {                                                                                           \
+            if ((logger).isEnabled(levelId)) [[unlikely]] (logger).method(className, funcName, __VA_ARGS__); \
+        }                                                                                           \
+    } while (false)
+
+#define LOG_DEBUG(logger, className, funcName, ...) \
+    BEACONTECH_LOG(logger, BeaconTech::Common::LogLevel::DEBUG_ID, logDebug, className, funcName, __VA_ARGS__)
+
+#define LOG_INFO(logger, className, funcName, ...) \
+    BEACONTECH_LOG(logger, BeaconTech::Common::LogLevel::INFO_ID, logInfo, className, funcName, __VA_ARGS__)
+
+#define LOG_WARN(logger, className, funcName, ...) \
+    BEACONTECH_LOG(logger, BeaconTech::Common::LogLevel::WARN_ID, logWarn, className, funcName, __VA_ARGS__)
+
+#define LOG_SEVERE(logger, className, funcName, ...) \
+    BEACONTECH_LOG(logger, BeaconTech::Common::LogLevel::SEVERE_ID, logSevere, className, funcName, __VA_ARGS__)
+
 #endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGGER_HPP
@@ -0,0 +1,161 @@
+//
+// Owns the threads and files behind every Logger in the process. Each log file is written by exactly
+// one flush worker from a small, configurable pool.
+//
+// Created by Michael Lewis on 12/20/23.
+//
+
+#include <algorithm>
+
+#include "LoggerManager.hpp"
+#include "../concurrency/ThreadFactory.hpp"
+#include "../telemetry/MetricsRegistry.hpp"
+#include "../telemetry/TraceRecorder.hpp"
+#include "../utils/Clock.hpp"
+#include "../utils/ConfigManager.hpp"
+
+namespace BeaconTech::Common
+{
+    LoggerManager::LoggerManager()
+        : laneSize{ConfigManager::config().logRingSize},
+          maxLanes{ConfigManager::config().logLanes}, running{true}
+    {
+        // Selects the clock source if the configs are already loaded. Records written before then carry
+        // system clock readings, which Clock::tscToEpochNanos still converts once the TSC is selected
+        Clock::calibrateTsc();
+
+        // The sinks register their counters with the registry, so it must outlive them
+        MetricsRegistry::getInstance();
+
+        const std::uint32_t numWorkers = std::max(ConfigManager::config().logFlushThreads, 1U);
+        for (std::uint32_t i = 0; i < numWorkers; ++i)
+        {
+            auto& worker = workers.emplace_back(std::make_unique<LogFlushWorker>("logger-" + std::to_string(i)));
+            worker->thread = ThreadFactory::createThread(worker->role, [this, &worker = *worker]() { flush(worker); });
+        }
+    }
+
+    LoggerManager::~LoggerManager()
+    {
+        shutdown();
+    }
+
+    // Drains every sink, stops the workers and closes the log files. Loggers that are destroyed earlier
+    // only close their source, so this is where the last records of the process are written. Called by
+    // the destructor, or earlier by a process that must quiesce the workers (e.g. before dumping the
+    // trace rings they write to) or remove its log files. Records logged afterwards are never written
+    void LoggerManager::shutdown()
+    {
+        if (!running.exchange(false)) return;
+
+        for (auto& worker : workers)
+        {
+            worker->idleStrategy.wake();
+            if (worker->thread.joinable()) worker->thread.join();
+        }
+
+        // The rotator publishes standby segments to the files, so it stops before the sinks are destroyed
+        rotator.stop();
+
+        const std::lock_guard<std::mutex> lock{mutex};
+        sinkWorkers.clear();
+        sinks.clear();
+    }
+
+    // Constructed by the first Logger, so it is destroyed after every Logger with static storage
+    LoggerManager& LoggerManager::getInstance()
+    {
+        static LoggerManager instance{};
+        return instance;
+    }
+
+    // Creates the lanes for a new Logger and attaches them to the sink of the application's log file.
+    // New sinks are spread across the workers round-robin
+    std::shared_ptr<LogSource> LoggerManager::registerLogger(const std::string& directory, const std::string& appName,
+                                                             std::uint32_t engineId)
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+
+        // Loggers created after shutdown get lanes that are never drained rather than a new log file
+        if (!running) [[unlikely]]
+        {
+            return std::make_shared<LogSource>(appName + "-" + std::to_string(engineId), engineId, laneSize,
+                                               maxLanes, workers.front()->idleStrategy);
+        }
+
+        const std::string fileName = directory + appName + ".log";
+
+        auto it = sinks.find(fileName);
+        if (it == sinks.end())
+        {
+            it = sinks.emplace(fileName, std::make_unique<LogSink>(directory, appName, rotator)).first;
+
+            LogFlushWorker* worker = workers[(sinks.size() - 1) % workers.size()].get();
+            sinkWorkers.emplace(fileName, worker);
+
+            const std::lock_guard<std::mutex> workerLock{worker->mutex};
+            worker->pendingSinks.push_back(it->second.get());
+            worker->hasPendingSinks.store(true, std::memory_order_release);
+        }
+
+        LogFlushWorker* worker = sinkWorkers.at(fileName);
+        auto source = std::make_shared<LogSource>(appName + "-" + std::to_string(engineId), engineId, laneSize,
+                                                  maxLanes, worker->idleStrategy);
+        it->second->addSource(source);
+        worker->idleStrategy.wake();
+
+        return source;
+    }
+
+    // Writes the records of the worker's sinks until the manager is destroyed and every sink is drained
+    void LoggerManager::flush(LogFlushWorker& worker)
+    {
+        const auto hasWork = [this, &worker]() {
+            return !running || worker.hasPendingSinks.load(std::memory_order_acquire)
+                   || std::any_of(worker.sinks.cbegin(), worker.sinks.cend(),
+                                  [](const LogSink* sink) { return sink->hasRecords(); });
+        };
+
+        while (true)
+        {
+            // Read before draining, so the last pass starts after the stop and sees every sink and record
+            // published before it
+            const bool stopping = !running;
+
+            if (worker.hasPendingSinks.load(std::memory_order_acquire))
+            {
+                const std::lock_guard<std::mutex> lock{worker.mutex};
+                worker.sinks.insert(worker.sinks.end(), worker.pendingSinks.begin(), worker.pendingSinks.end());
+                worker.pendingSinks.clear();
+                worker.hasPendingSinks.store(false, std::memory_order_relaxed);
+            }
+
+            // Keeps the TSC conversion of every record written below in step with the system clock
+            Clock::recalibrateTscIfDue();
+
+            // Passes that find nothing to write are not traced
+            TraceSpan span{"LoggerManager::flush"};
+            bool written = false;
+            for (LogSink* sink : worker.sinks) written |= sink->writeRecords();
+
+            // Lines stay buffered until the buffer fills or they are logFlushMicros old. The idle strategy
+            // parks for a bounded time, so a quiet sink is still flushed shortly after it becomes due
+            for (LogSink* sink : worker.sinks) sink->flushIfDue();
+            if (!written) span.cancel();
+
+            if (written)
+            {
+                worker.idleStrategy.reset();
+                continue;
+            }
+
+            if (stopping)
+            {
+                for (LogSink* sink : worker.sinks) sink->flush();
+                return;
+            }
+
+            worker.idleStrategy.idle(hasWork);
+        }
+    }
+} // namespace BeaconTech::Common
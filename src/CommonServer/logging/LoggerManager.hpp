@@ -1,45 +1,95 @@
 //
+// Owns the threads and files behind every Logger in the process. A Logger is a lightweight handle
+// that registers its lanes (a LogSource) with the manager. The manager keeps one sink per log file,
+// keyed by application name, and a small pool of flush workers. Each sink is assigned to exactly one
+// worker, so every file has a single writer and the records of each engine stay in order, while the
+// number of flush threads no longer grows with the number of engines.
+//
+// The flush workers run under the thread roles logger-0 ... logger-N (see ThreadFactory.hpp). Log
+// files are rotated and compressed by a LogRotator on the log-compressor thread (see LogRotator.hpp).
+//
+//   "logFlushThreads": "1"
+//   "logRingSize": "2097152"    (bytes per lane)
+//   "logLanes": "16"            (lanes per Logger before threads share an overflow lane)
+//
 // Created by Michael Lewis on 12/20/23.
 //
 
 #ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGGERMANAGER_HPP
 #define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGGERMANAGER_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
-#include "CommonServer/logging/Logger.hpp"
+#include "LogRotator.hpp"
+#include "LogSink.hpp"
+#include "LogSource.hpp"
+#include "../concurrency/IdleStrategy.hpp"
 
 namespace BeaconTech::Common
 {
 
-    class LoggerManager
+    struct LogFlushWorker
     {
-//    private:
-//        static std::unordered_map<std::string, std::unordered_map<std::string, BeaconTech::Common::Logger*>> LOGGERS;
-//
-//    public:
-//
-//        static Logger* getLogger(const std::string& className, const std::string& funcName)
-//        {
-//            auto innerMap = LOGGERS.find(className);
-//
-//            if (innerMap != LOGGERS.cend())
-//            {
-//                auto it = innerMap->second.find(funcName);
-//                if (it != innerMap->second.cend())
-//                {
-//                    return it->second;
-//                }
-//            }
-//
-//            BeaconTech::Common::Logger* logger = new Logger{className + ".log"};
-//            LOGGERS.emplace(className, std::unordered_map<std::string, Logger*>());
-//            LOGGERS.at(className).emplace(funcName, logger);
-//
-//            return logger;
-//        }
-//    };
-}
+        const std::string role;
+        ConfiguredIdleStrategy idleStrategy;
+
+        // Sinks are assigned by the manager and adopted by the worker thread
+        std::mutex mutex;
+        std::vector<LogSink*> pendingSinks;
+        std::atomic<bool> hasPendingSinks{false};
+
+        // Worker thread only state
+        std::vector<LogSink*> sinks;
+        std::thread thread;
+
+        explicit LogFlushWorker(const std::string& role) : role{role}, idleStrategy{role} {}
+    };
+
+    class LoggerManager final
+    {
+    private:
+        const std::size_t laneSize;
+        const std::size_t maxLanes;
+
+        LogRotator rotator;
+
+        std::mutex mutex;
+        std::unordered_map<std::string, std::unique_ptr<LogSink>> sinks;  // fileName -> sink
+        std::unordered_map<std::string, LogFlushWorker*> sinkWorkers;     // fileName -> worker
+        std::vector<std::unique_ptr<LogFlushWorker>> workers;
+        std::atomic<bool> running;
+
+        LoggerManager();
+
+        void flush(LogFlushWorker& worker);
+
+    public:
+        ~LoggerManager();
+
+        static LoggerManager& getInstance();
+
+        std::shared_ptr<LogSource> registerLogger(const std::string& directory, const std::string& appName,
+                                                  std::uint32_t engineId);
+
+        void shutdown();
+
+        // Deleted default ctors and assignment operators
+        LoggerManager(const LoggerManager& other) = delete;
+
+        LoggerManager(LoggerManager&& other) = delete;
+
+        LoggerManager& operator=(const LoggerManager& other) = delete;
+
+        LoggerManager& operator=(LoggerManager&& other) = delete;
+    };
+
+} // namespace BeaconTech::Common
 
 #endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LOGGERMANAGER_HPP
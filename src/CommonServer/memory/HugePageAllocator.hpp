@@ -0,0 +1,62 @@
+//
+// A standard allocator that backs containers (e.g. the slots of a ring buffer) with memory from the
+// MemoryProvider. The name identifies the owner of the allocation in the startup memory report.
+//
+// Containers using the allocator should allocate once up front. Every allocation is rounded up to a
+// whole 2MB page, so the allocator is not suitable for containers that grow incrementally.
+//
+// Created by Michael Lewis on 1/12/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_HUGEPAGEALLOCATOR_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_HUGEPAGEALLOCATOR_HPP
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "MemoryProvider.hpp"
+
+namespace BeaconTech::Common
+{
+
+    template<typename T>
+    class HugePageAllocator
+    {
+    private:
+        std::string name;
+
+        template<typename U>
+        friend class HugePageAllocator;
+
+    public:
+        using value_type = T;
+        using is_always_equal = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+
+        HugePageAllocator() : name{"unnamed"} {}
+
+        explicit HugePageAllocator(std::string name) : name{std::move(name)} {}
+
+        template<typename U>
+        HugePageAllocator(const HugePageAllocator<U>& other) : name{other.name} {}
+
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(MemoryProvider::allocate(name, n * sizeof(T)));
+        }
+
+        void deallocate(T* address, std::size_t n) noexcept
+        {
+            MemoryProvider::release(address, n * sizeof(T));
+        }
+
+        // Memory from any instance can be released by any other instance
+        template<typename U>
+        bool operator==(const HugePageAllocator<U>&) const noexcept { return true; }
+    };
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_HUGEPAGEALLOCATOR_HPP
@@ -0,0 +1,222 @@
+//
+// Provides pre-faulted backing memory for the rings on the critical path. Allocations are made from
+// 2MB huge pages when possible so a ring is covered by a handful of TLB entries, and every page is
+// faulted in up front so the trading threads never take a page fault on first touch.
+//
+// Created by Michael Lewis on 1/12/24.
+//
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "MemoryProvider.hpp"
+#include "../logging/LogLevel.hpp"
+#include "../utils/ConfigManager.hpp"
+
+namespace BeaconTech::Common
+{
+    std::string memoryPageTypeToString(MemoryPageType pageType) noexcept
+    {
+        switch (pageType)
+        {
+            case MemoryPageType::HUGETLB:
+                return "HUGETLB";
+            case MemoryPageType::TRANSPARENT:
+                return "TRANSPARENT";
+            default:
+                return "STANDARD";
+        }
+    }
+
+    // Mappings must be a whole number of pages
+    std::size_t MemoryProvider::mappedSize(std::size_t bytes, std::size_t pageSize) noexcept
+    {
+        const std::size_t size = std::max<std::size_t>(bytes, 1);
+        return (size + pageSize - 1) / pageSize * pageSize;
+    }
+
+    void* MemoryProvider::mapHugeTlb(std::size_t mappedBytes) noexcept
+    {
+#if defined(__linux__) && defined(MAP_HUGETLB)
+        void* address = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+        return address == MAP_FAILED ? nullptr : address;
+#else
+        (void) mappedBytes;
+        return nullptr;
+#endif
+    }
+
+    // Maps a 2MB aligned region (the kernel only backs aligned 2MB ranges with transparent huge pages)
+    // and asks for it to be backed by huge pages
+    void* MemoryProvider::mapTransparent(std::size_t mappedBytes) noexcept
+    {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        void* mapping = mmap(nullptr, mappedBytes + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED) return nullptr;
+
+        // Trim the unaligned head and the excess tail
+        auto start = reinterpret_cast<std::uintptr_t>(mapping);
+        auto aligned = (start + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+        if (aligned > start) munmap(mapping, aligned - start);
+
+        auto end = start + mappedBytes + HUGE_PAGE_SIZE;
+        if (end > aligned + mappedBytes) munmap(reinterpret_cast<void*>(aligned + mappedBytes), end - aligned - mappedBytes);
+
+        void* address = reinterpret_cast<void*>(aligned);
+        if (madvise(address, mappedBytes, MADV_HUGEPAGE) != 0)
+        {
+            munmap(address, mappedBytes);
+            return nullptr;
+        }
+
+        return address;
+#else
+        (void) mappedBytes;
+        return nullptr;
+#endif
+    }
+
+    void* MemoryProvider::mapStandard(std::size_t mappedBytes) noexcept
+    {
+#if defined(__linux__)
+        void* address = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return address == MAP_FAILED ? nullptr : address;
+#else
+        return std::aligned_alloc(PAGE_SIZE, mappedBytes);
+#endif
+    }
+
+    // Touches every page so it is faulted in now rather than on the critical path
+    void MemoryProvider::prefault(void* address, std::size_t mappedBytes) noexcept
+    {
+        auto bytes = static_cast<volatile char*>(address);
+        for (std::size_t offset = 0; offset < mappedBytes; offset += PAGE_SIZE) bytes[offset] = 0;
+    }
+
+    // Reads how much of the mapping that starts at the address is backed by transparent huge pages
+    std::size_t MemoryProvider::anonHugePageBytes(void* address) noexcept
+    {
+#if defined(__linux__)
+        try
+        {
+            std::ifstream smaps{"/proc/self/smaps"};
+            std::string line;
+            bool inRegion = false;
+            const auto target = reinterpret_cast<std::uintptr_t>(address);
+
+            while (std::getline(smaps, line))
+            {
+                auto dash = line.find('-');
+                auto space = line.find(' ');
+                if (dash != std::string::npos && space != std::string::npos && dash < space
+                    && std::isxdigit(static_cast<unsigned char>(line.front())))
+                {
+                    const auto start = std::stoull(line.substr(0, dash), nullptr, 16);
+                    const auto end = std::stoull(line.substr(dash + 1, space - dash - 1), nullptr, 16);
+                    inRegion = start <= target && target < end;
+                }
+                else if (inRegion && line.rfind("AnonHugePages:", 0) == 0)
+                {
+                    std::stringstream ss{line.substr(line.find(':') + 1)};
+                    std::size_t kiloBytes = 0;
+                    ss >> kiloBytes;
+                    return kiloBytes * 1024;
+                }
+            }
+        }
+        catch (const std::exception&)
+        {
+            // The report is best effort
+        }
+#else
+        (void) address;
+#endif
+        return 0;
+    }
+
+    // Allocates pre-faulted memory for the named owner, preferring huge pages. Throws std::bad_alloc
+    // if no memory could be mapped at all
+    void* MemoryProvider::allocate(const std::string& name, std::size_t bytes)
+    {
+        const bool hugePages = ConfigManager::config().hugePages;
+        const bool lockMemory = ConfigManager::config().lockMemory;
+        std::size_t mappedBytes = mappedSize(bytes, HUGE_PAGE_SIZE);
+
+        MemoryPageType pageType = MemoryPageType::STANDARD;
+        void* address = nullptr;
+
+        if (hugePages && (address = mapHugeTlb(mappedBytes)) != nullptr) pageType = MemoryPageType::HUGETLB;
+        else if (hugePages && (address = mapTransparent(mappedBytes)) != nullptr) pageType = MemoryPageType::TRANSPARENT;
+        else address = mapStandard(mappedBytes = mappedSize(bytes, PAGE_SIZE));
+
+        if (address == nullptr) throw std::bad_alloc{};
+
+        if (pageType != MemoryPageType::HUGETLB) prefault(address, mappedBytes);
+
+        bool locked = false;
+#if defined(__linux__)
+        if (lockMemory)
+        {
+            locked = mlock(address, mappedBytes) == 0;
+            if (!locked)
+            {
+                std::cerr << LogLevel::WARN.getDesc() << " : Unable to lock memory for " << name
+                          << " - " << std::strerror(errno) << std::endl;
+            }
+        }
+#endif
+
+        const std::size_t hugePageBytes = pageType == MemoryPageType::HUGETLB ? mappedBytes
+                : pageType == MemoryPageType::TRANSPARENT ? anonHugePageBytes(address) : 0;
+
+        std::lock_guard<std::mutex> lock{mutex};
+        regions.push_back(MemoryRegion{name, address, bytes, mappedBytes, pageType, hugePageBytes, locked});
+
+        return address;
+    }
+
+    // Returns the memory to the OS. The size must match the size passed to allocate
+    void MemoryProvider::release(void* address, std::size_t bytes) noexcept
+    {
+        if (address == nullptr) return;
+
+        std::size_t mappedBytes = mappedSize(bytes, HUGE_PAGE_SIZE);
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            auto region = std::find_if(regions.begin(), regions.end(),
+                                       [address](const MemoryRegion& region) { return region.address == address; });
+            if (region != regions.end())
+            {
+                mappedBytes = region->mappedBytes;
+                regions.erase(region);
+            }
+        }
+
+#if defined(__linux__)
+        munmap(address, mappedBytes);
+#else
+        std::free(address);
+#endif
+    }
+
+    // A snapshot of every live allocation
+    std::vector<MemoryRegion> MemoryProvider::report()
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return regions;
+    }
+} // namespace BeaconTech::Common
@@ -0,0 +1,85 @@
+//
+// Provides pre-faulted backing memory for the rings on the critical path. Allocations are made from
+// 2MB huge pages when possible so a ring is covered by a handful of TLB entries, and every page is
+// faulted in up front so the trading threads never take a page fault on first touch. Each allocation
+// falls back in the following order:
+//
+// 1) HUGETLB     - Explicit huge pages reserved by the OS (vm.nr_hugepages)
+// 2) TRANSPARENT - Transparent huge pages requested with madvise on a 2MB aligned mapping
+// 3) STANDARD    - Regular 4K pages
+//
+// Memory can also be locked (mlock) so it is never swapped out. Every live allocation is recorded so
+// the application can report which allocations got huge pages at startup.
+//
+//   "hugePages": "true"      "lockMemory": "false"
+//
+// Created by Michael Lewis on 1/12/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_MEMORYPROVIDER_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_MEMORYPROVIDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace BeaconTech::Common
+{
+
+    enum class MemoryPageType : std::int8_t
+    {
+        HUGETLB = 0,
+        TRANSPARENT = 1,
+        STANDARD = 2
+    };
+
+    std::string memoryPageTypeToString(MemoryPageType pageType) noexcept;
+
+    struct MemoryRegion
+    {
+        std::string name;
+        void* address;
+        std::size_t bytes;          // Requested size
+        std::size_t mappedBytes;    // Size rounded up to whole pages
+        MemoryPageType pageType;
+        std::size_t hugePageBytes;  // Bytes actually backed by huge pages when the region was allocated
+        bool locked;
+    };
+
+    class MemoryProvider
+    {
+    private:
+        static constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+        static constexpr std::size_t PAGE_SIZE = 4096;
+
+        inline static std::mutex mutex{};
+        inline static std::vector<MemoryRegion> regions{};
+
+        static void* mapHugeTlb(std::size_t mappedBytes) noexcept;
+
+        static void* mapTransparent(std::size_t mappedBytes) noexcept;
+
+        static void* mapStandard(std::size_t mappedBytes) noexcept;
+
+        static void prefault(void* address, std::size_t mappedBytes) noexcept;
+
+        static std::size_t anonHugePageBytes(void* address) noexcept;
+
+        static std::size_t mappedSize(std::size_t bytes, std::size_t pageSize) noexcept;
+
+    public:
+        static void* allocate(const std::string& name, std::size_t bytes);
+
+        static void release(void* address, std::size_t bytes) noexcept;
+
+        static std::vector<MemoryRegion> report();
+
+        // Deleted default ctors and assignment operators
+        MemoryProvider() = delete;
+    };
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_MEMORYPROVIDER_HPP
@@ -0,0 +1,90 @@
+//
+// A fixed size log-linear latency histogram. Values below 16ns are counted exactly and every power of
+// two above that is split into 16 linear sub-buckets, which bounds the relative error of any reported
+// percentile to 1/16 (6.25%) while covering 0ns to ~1 hour in 640 buckets.
+//
+// Created by Michael Lewis on 1/10/24.
+//
+
+#include <algorithm>
+#include <cmath>
+
+#include "LatencyHistogram.hpp"
+
+namespace BeaconTech::Common
+{
+    LatencyHistogram::LatencyHistogram() : buckets{}, count{0}, total{0}, maxValue{0}
+    {
+
+    }
+
+    // Returns the largest value that maps to the bucket
+    std::uint64_t LatencyHistogram::bucketUpperBound(std::size_t index) noexcept
+    {
+        if (index < SUB_BUCKETS) return index;
+
+        const std::uint64_t shift = index / SUB_BUCKETS - 1;
+        const std::uint64_t mantissa = index % SUB_BUCKETS + SUB_BUCKETS;
+
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    std::uint64_t LatencyHistogram::getCount() const noexcept
+    {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t LatencyHistogram::getMax() const noexcept
+    {
+        return maxValue.load(std::memory_order_relaxed);
+    }
+
+    double LatencyHistogram::getMean() const noexcept
+    {
+        const std::uint64_t n = getCount();
+        return n == 0 ? 0.0 : static_cast<double>(total.load(std::memory_order_relaxed)) / static_cast<double>(n);
+    }
+
+    // Returns the upper bound of the bucket that contains the percentile (e.g. 99.9), capped by the max
+    // recorded value. Readers racing the writer may see a count that is slightly ahead of the buckets,
+    // which is harmless for reporting.
+    std::uint64_t LatencyHistogram::percentile(double percentile) const noexcept
+    {
+        const std::uint64_t n = getCount();
+        if (n == 0) return 0;
+
+        const auto target = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(percentile / 100.0 * n)));
+        std::uint64_t seen = 0;
+
+        for (std::size_t index = 0; index < NUM_BUCKETS; ++index)
+        {
+            seen += buckets[index].load(std::memory_order_relaxed);
+            if (seen >= target) return std::min(bucketUpperBound(index), getMax());
+        }
+
+        return getMax();
+    }
+
+    // Adds the values recorded by another histogram (e.g. of another thread). Must be called by the writer
+    void LatencyHistogram::merge(const LatencyHistogram& other) noexcept
+    {
+        for (std::size_t index = 0; index < NUM_BUCKETS; ++index)
+        {
+            increment(buckets[index], other.buckets[index].load(std::memory_order_relaxed));
+        }
+
+        increment(count, other.getCount());
+        increment(total, other.total.load(std::memory_order_relaxed));
+        if (other.getMax() > getMax()) maxValue.store(other.getMax(), std::memory_order_relaxed);
+    }
+
+    // Clears the histogram. Must be called by the writer
+    void LatencyHistogram::reset() noexcept
+    {
+        for (auto& bucket : buckets) bucket.store(0, std::memory_order_relaxed);
+
+        count.store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+        maxValue.store(0, std::memory_order_relaxed);
+    }
+} // namespace BeaconTech::Common
@@ -0,0 +1,91 @@
+//
+// A fixed size log-linear latency histogram. Values below 16ns are counted exactly and every power of
+// two above that is split into 16 linear sub-buckets, which bounds the relative error of any reported
+// percentile to 1/16 (6.25%) while covering 0ns to ~1 hour in 624 buckets.
+//
+// The histogram has a single writer (the thread that measures the latency) and any number of readers.
+// Recording is a relaxed load and store on the bucket, so it is lock-free and never contends with readers.
+//
+// Created by Michael Lewis on 1/10/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LATENCYHISTOGRAM_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LATENCYHISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+namespace BeaconTech::Common
+{
+
+    class LatencyHistogram final
+    {
+    private:
+        static constexpr std::uint32_t SUB_BUCKET_BITS = 4;
+        static constexpr std::uint64_t SUB_BUCKETS = 1ULL << SUB_BUCKET_BITS;
+        static constexpr std::uint32_t MAX_VALUE_BITS = 42;
+        static constexpr std::size_t NUM_BUCKETS = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+        std::array<std::atomic<std::uint64_t>, NUM_BUCKETS> buckets;
+        std::atomic<std::uint64_t> count;
+        std::atomic<std::uint64_t> total;
+        std::atomic<std::uint64_t> maxValue;
+
+        // Increments a counter that only has a single writer without a locked instruction
+        static inline void increment(std::atomic<std::uint64_t>& counter, std::uint64_t value) noexcept
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        static inline std::size_t bucketIndex(std::uint64_t value) noexcept
+        {
+            if (value < SUB_BUCKETS) return value;
+
+            const std::uint32_t shift = std::bit_width(value) - 1 - SUB_BUCKET_BITS;
+            const std::size_t index = (shift + 1) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+
+            return index < NUM_BUCKETS ? index : NUM_BUCKETS - 1;
+        }
+
+        static std::uint64_t bucketUpperBound(std::size_t index) noexcept;
+
+    public:
+        LatencyHistogram();
+
+        ~LatencyHistogram() = default;
+
+        inline void record(std::uint64_t nanos) noexcept
+        {
+            increment(buckets[bucketIndex(nanos)], 1);
+            increment(count, 1);
+            increment(total, nanos);
+            if (nanos > maxValue.load(std::memory_order_relaxed)) maxValue.store(nanos, std::memory_order_relaxed);
+        }
+
+        std::uint64_t getCount() const noexcept;
+
+        std::uint64_t getMax() const noexcept;
+
+        double getMean() const noexcept;
+
+        void merge(const LatencyHistogram& other) noexcept;
+
+        std::uint64_t percentile(double percentile) const noexcept;
+
+        void reset() noexcept;
+
+        // Deleted default ctors and assignment operators
+        LatencyHistogram(const LatencyHistogram& other) = delete;
+
+        LatencyHistogram(LatencyHistogram&& other) = delete;
+
+        LatencyHistogram& operator=(const LatencyHistogram& other) = delete;
+
+        LatencyHistogram& operator=(LatencyHistogram&& other) = delete;
+    };
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_LATENCYHISTOGRAM_HPP
@@ -0,0 +1,255 @@
+//
+// A process wide registry of named metrics. Writers update their own cache line padded cells and a
+// reporter thread periodically exports a snapshot of every metric in the InfluxDB line protocol.
+//
+// Created by Michael Lewis on 1/24/24.
+//
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "MetricsRegistry.hpp"
+#include "../concurrency/ThreadFactory.hpp"
+#include "../logging/LogLevel.hpp"
+#include "../utils/Clock.hpp"
+#include "../utils/ConfigManager.hpp"
+
+namespace BeaconTech::Common
+{
+    namespace
+    {
+        constexpr std::string_view SOCKET_PREFIX = "unix:";
+
+        template<typename T>
+        void appendNumber(std::string& line, T value)
+        {
+            char digits[32];
+            const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            line.append(digits, result.ptr);
+        }
+
+        // <name>[,<tags>] and the space before the fields
+        void appendKey(std::string& line, const MetricSeries& series)
+        {
+            line += series.name;
+            if (!series.tags.empty())
+            {
+                line += ',';
+                line += series.tags;
+            }
+
+            line += ' ';
+        }
+
+        void appendTimestamp(std::string& line, std::int64_t nanos)
+        {
+            line += ' ';
+            appendNumber(line, nanos);
+            line += '\n';
+        }
+    }
+
+    MetricsRegistry::MetricsRegistry()
+        : output{ConfigManager::config().metricsOutput},
+          interval{ConfigManager::config().metricsIntervalSeconds},
+          mergedHistogram{std::make_unique<LatencyHistogram>()}, running{true}, fd{-1}
+    {
+        if (output.empty() || interval.count() == 0) return;
+
+        thread = ThreadFactory::createThread("metrics-reporter", [this]() { run(); });
+    }
+
+    // Exports a final snapshot so that the last interval is not lost
+    MetricsRegistry::~MetricsRegistry()
+    {
+        {
+            const std::lock_guard<std::mutex> lock{mutex};
+            running = false;
+        }
+
+        condition.notify_one();
+        if (thread.joinable()) thread.join();
+
+        if (fd >= 0) close(fd);
+    }
+
+    // Constructed by the LoggerManager before any sink, so it is destroyed after every writer with static storage
+    MetricsRegistry& MetricsRegistry::getInstance()
+    {
+        static MetricsRegistry instance{};
+        return instance;
+    }
+
+    MetricSeries& MetricsRegistry::findSeries(const std::string& name, const std::string& tags)
+    {
+        const std::string key = tags.empty() ? name : name + "," + tags;
+        auto it = series.find(key);
+        if (it == series.end()) it = series.emplace(key, MetricSeries{name, tags, {}, {}, {}}).first;
+
+        return it->second;
+    }
+
+    // Registers a new cell for the calling thread. Register once (e.g. in a ctor) and keep the reference
+    Counter& MetricsRegistry::counter(const std::string& name, const std::string& tags)
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        return *findSeries(name, tags).counters.emplace_back(std::make_unique<Counter>());
+    }
+
+    Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& tags)
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        return *findSeries(name, tags).gauges.emplace_back(std::make_unique<Gauge>());
+    }
+
+    LatencyHistogram& MetricsRegistry::histogram(const std::string& name, const std::string& tags)
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        return *findSeries(name, tags).histograms.emplace_back(std::make_unique<LatencyHistogram>());
+    }
+
+    // Formats every metric in the line protocol. Cells are read while their writers keep writing, so a
+    // snapshot is not an atomic cut across metrics, but every value in it was current during the snapshot
+    std::string MetricsRegistry::snapshot()
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        const std::int64_t now = Clock::nowNanos();
+        std::string lines;
+
+        for (const auto& [key, metric] : series)
+        {
+            if (!metric.counters.empty())
+            {
+                std::uint64_t total = 0;
+                for (const auto& cell : metric.counters) total += cell->get();
+
+                appendKey(lines, metric);
+                lines += "value=";
+                appendNumber(lines, total);
+                lines += 'i';
+                appendTimestamp(lines, now);
+            }
+
+            if (!metric.gauges.empty())
+            {
+                double total = 0.0;
+                for (const auto& cell : metric.gauges) total += cell->get();
+
+                appendKey(lines, metric);
+                lines += "value=";
+                appendNumber(lines, total);
+                appendTimestamp(lines, now);
+            }
+
+            if (!metric.histograms.empty())
+            {
+                LatencyHistogram& merged = *mergedHistogram;
+                merged.reset();
+                for (const auto& cell : metric.histograms) merged.merge(*cell);
+
+                appendKey(lines, metric);
+                lines += "count=";
+                appendNumber(lines, merged.getCount());
+                lines += "i,mean=";
+                appendNumber(lines, merged.getMean());
+                lines += ",p50=";
+                appendNumber(lines, merged.percentile(50.0));
+                lines += "i,p99=";
+                appendNumber(lines, merged.percentile(99.0));
+                lines += "i,p999=";
+                appendNumber(lines, merged.percentile(99.9));
+                lines += "i,max=";
+                appendNumber(lines, merged.getMax());
+                lines += 'i';
+                appendTimestamp(lines, now);
+            }
+        }
+
+        return lines;
+    }
+
+    void MetricsRegistry::run()
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        while (running)
+        {
+            condition.wait_for(lock, interval, [this]() { return !running; });
+
+            lock.unlock();
+            exportSnapshot();
+            lock.lock();
+        }
+    }
+
+    // Opens the file in append mode or connects to the socket. A socket that is not listening yet is
+    // retried on the next export
+    bool MetricsRegistry::openOutput()
+    {
+        if (fd >= 0) return true;
+
+        if (!output.starts_with(SOCKET_PREFIX))
+        {
+            fd = open(output.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+            if (fd < 0)
+            {
+                std::cerr << LogLevel::WARN.getDesc() << " : Unable to open metrics file " << output
+                          << " - " << std::strerror(errno) << std::endl;
+            }
+
+            return fd >= 0;
+        }
+
+        const std::string path = output.substr(SOCKET_PREFIX.size());
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            std::cerr << LogLevel::WARN.getDesc() << " : Metrics socket path is too long " << path << std::endl;
+            return false;
+        }
+
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+
+        return fd >= 0;
+    }
+
+    // Writes the snapshot, retrying partial writes. The output is reopened on the next export after a failure
+    void MetricsRegistry::exportSnapshot()
+    {
+        const std::string lines = snapshot();
+        if (lines.empty() || !openOutput()) return;
+
+        // MSG_NOSIGNAL keeps a closed socket from raising SIGPIPE
+        const bool toSocket = output.starts_with(SOCKET_PREFIX);
+        std::size_t offset = 0;
+        while (offset < lines.size())
+        {
+            const char* data = lines.data() + offset;
+            const std::size_t remaining = lines.size() - offset;
+            const ssize_t written = toSocket ? send(fd, data, remaining, MSG_NOSIGNAL) : write(fd, data, remaining);
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0)
+            {
+                close(fd);
+                fd = -1;
+                return;
+            }
+
+            offset += static_cast<std::size_t>(written);
+        }
+    }
+} // namespace BeaconTech::Common
@@ -0,0 +1,134 @@
+//
+// A process wide registry of named metrics that every subsystem publishes through. There are three kinds
+// of metric:
+//
+// 1) Counter          - A total that only goes up (e.g. messages processed)
+// 2) Gauge            - The latest value of something (e.g. a queue depth)
+// 3) LatencyHistogram - A distribution of nanosecond latencies (see LatencyHistogram.hpp)
+//
+// A metric is a name plus optional tags (e.g. "role=engine-0"). Every registration returns a new cell
+// with a single writer, so each thread registers its own cell and updates it with a relaxed load and
+// store rather than a locked instruction. Cells are padded to a cache line so that threads never share
+// one. The registry owns the cells, so they outlive the components that write to them.
+//
+// A reporter thread (role metrics-reporter) snapshots every metric each metricsIntervalSeconds and writes
+// it in the InfluxDB line protocol to metricsOutput, either a file or, prefixed with unix:, a Unix domain
+// stream socket. The cells of a metric with the same name and tags are summed (histograms are merged).
+// Counters and histograms are cumulative since the process started:
+//
+//   queue.jobs,role=engine-0 value=1024i 1705968000000000000
+//   queue.sojourn,role=engine-0 count=1024i,mean=212.5,p50=191i,p99=735i,p999=1535i,max=2210i 1705968000000000000
+//
+//   "metricsOutput": ""    (e.g. /var/log/beacontech/metrics.lp or unix:/run/telegraf.sock; empty disables)
+//   "metricsIntervalSeconds": "10"
+//
+// Created by Michael Lewis on 1/24/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_METRICSREGISTRY_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_METRICSREGISTRY_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LatencyHistogram.hpp"
+
+namespace BeaconTech::Common
+{
+
+    class alignas(64) Counter final
+    {
+    private:
+        std::atomic<std::uint64_t> value{0};
+
+    public:
+        // Must only be called by the writer of the cell
+        inline void add(std::uint64_t amount = 1) noexcept
+        {
+            value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        inline std::uint64_t get() const noexcept { return value.load(std::memory_order_relaxed); }
+    };
+
+    class alignas(64) Gauge final
+    {
+    private:
+        std::atomic<double> value{0.0};
+
+    public:
+        inline void set(double newValue) noexcept { value.store(newValue, std::memory_order_relaxed); }
+
+        inline double get() const noexcept { return value.load(std::memory_order_relaxed); }
+    };
+
+    // The cells of a metric that share a name and tags
+    struct MetricSeries
+    {
+        std::string name;
+        std::string tags;
+        std::vector<std::unique_ptr<Counter>> counters;
+        std::vector<std::unique_ptr<Gauge>> gauges;
+        std::vector<std::unique_ptr<LatencyHistogram>> histograms;
+    };
+
+    class MetricsRegistry final
+    {
+    private:
+        const std::string output;
+        const std::chrono::seconds interval;
+
+        std::mutex mutex;
+        std::map<std::string, MetricSeries> series;     // name,tags -> series
+        std::unique_ptr<LatencyHistogram> mergedHistogram;
+
+        // Reporter thread state
+        std::condition_variable condition;
+        bool running;
+        int fd;
+        std::thread thread;
+
+        MetricsRegistry();
+
+        MetricSeries& findSeries(const std::string& name, const std::string& tags);
+
+        void run();
+
+        void exportSnapshot();
+
+        bool openOutput();
+
+    public:
+        ~MetricsRegistry();
+
+        static MetricsRegistry& getInstance();
+
+        Counter& counter(const std::string& name, const std::string& tags = "");
+
+        Gauge& gauge(const std::string& name, const std::string& tags = "");
+
+        LatencyHistogram& histogram(const std::string& name, const std::string& tags = "");
+
+        std::string snapshot();
+
+        // Deleted default ctors and assignment operators
+        MetricsRegistry(const MetricsRegistry& other) = delete;
+
+        MetricsRegistry(MetricsRegistry&& other) = delete;
+
+        MetricsRegistry& operator=(const MetricsRegistry& other) = delete;
+
+        MetricsRegistry& operator=(MetricsRegistry&& other) = delete;
+    };
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_METRICSREGISTRY_HPP
@@ -0,0 +1,75 @@
+//
+// Queue telemetry for the processors. The producer stamps every job with the time it was enqueued
+// and the consumer records the sojourn time (enqueue to dequeue) into a latency histogram and tracks the
+// deepest the queue has been. The consumer periodically hands the telemetry to a reporter (usually a
+// Logger) and starts a new window.
+//
+// Created by Michael Lewis on 1/10/24.
+//
+
+#include <exception>
+#include <iostream>
+#include <utility>
+
+#include "QueueTelemetry.hpp"
+#include "../logging/LogLevel.hpp"
+#include "../utils/ConfigManager.hpp"
+
+namespace BeaconTech::Common
+{
+    QueueTelemetry::QueueTelemetry(const std::string& role, QueueTelemetryReporter reporter)
+        : role{role},
+          enabled{ConfigManager::roleIntConfigValueDefaultIfNull(role, "queueTelemetrySeconds", 10) > 0},
+          reportInterval{ConfigManager::roleIntConfigValueDefaultIfNull(role, "queueTelemetrySeconds", 10)},
+          reporter{std::move(reporter)}, sojourn{}, maxDepth{0},
+          windowStart{std::chrono::steady_clock::now()}, pollsSinceClockCheck{0}, idlePolls{0},
+          jobs{MetricsRegistry::getInstance().counter("queue.jobs", "role=" + role)},
+          queueDepth{MetricsRegistry::getInstance().gauge("queue.depth", "role=" + role)},
+          totalSojourn{MetricsRegistry::getInstance().histogram("queue.sojourn", "role=" + role)}
+    {
+
+    }
+
+    // Hands the current window to the reporter and starts a new window. Empty windows are not reported
+    // so that idle queues stay quiet. Must be called by the consumer
+    void QueueTelemetry::report() noexcept
+    {
+        if (reporter && sojourn.getCount() > 0)
+        {
+            try
+            {
+                reporter(*this);
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << LogLevel::WARN.getDesc() << " : Unable to report queue telemetry for "
+                          << role << " - " << e.what() << std::endl;
+            }
+        }
+
+        totalSojourn.merge(sojourn);
+        sojourn.reset();
+        maxDepth.store(0, std::memory_order_relaxed);
+        windowStart = std::chrono::steady_clock::now();
+    }
+
+    const std::string& QueueTelemetry::getRole() const noexcept
+    {
+        return role;
+    }
+
+    const LatencyHistogram& QueueTelemetry::getSojourn() const noexcept
+    {
+        return sojourn;
+    }
+
+    std::size_t QueueTelemetry::getMaxDepth() const noexcept
+    {
+        return maxDepth.load(std::memory_order_relaxed);
+    }
+
+    double QueueTelemetry::getWindowSeconds() const noexcept
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - windowStart).count();
+    }
+} // namespace BeaconTech::Common
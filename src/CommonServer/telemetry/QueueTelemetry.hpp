@@ -0,0 +1,139 @@
+//
+// Queue telemetry for the processors. The producer stamps every job with the time it was enqueued
+// and the consumer records the sojourn time (enqueue to dequeue) into a latency histogram and tracks the
+// deepest the queue has been. The consumer periodically hands the telemetry to a reporter (usually a
+// Logger) and starts a new window. The jobs, depth and sojourn times are also published to the
+// MetricsRegistry as queue.jobs, queue.depth and queue.sojourn (merged at the end of each window), tagged
+// with the role.
+//
+// Windows end on the clock rather than on work arriving. A consumer whose idle strategy has it yielding,
+// sleeping or parked checks the clock every time the idle strategy returns, so a quiet queue still ends
+// its window (and publishes the last sojourn times and a depth of 0) within idleMaxParkMicros or
+// idleMaxSleepMicros of the interval.
+//
+// Telemetry is configured per role and is enabled by default:
+//
+//   "queueTelemetrySeconds": "10"     "engine-0.queueTelemetrySeconds": "0"  (0 disables telemetry)
+//
+// Created by Michael Lewis on 1/10/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_QUEUETELEMETRY_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_QUEUETELEMETRY_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "LatencyHistogram.hpp"
+#include "MetricsRegistry.hpp"
+#include "../utils/Clock.hpp"
+
+namespace BeaconTech::Common
+{
+    // Forward Declarations
+    class QueueTelemetry;
+
+    using QueueTelemetryReporter = std::function<void (const QueueTelemetry& telemetry)>;
+
+    class QueueTelemetry final
+    {
+    private:
+        // Only look at the clock once every POLLS_PER_CLOCK_CHECK polls to keep the clock off the hot path
+        static constexpr std::uint32_t POLLS_PER_CLOCK_CHECK = 1024;
+
+        const std::string role;
+        const bool enabled;
+        const std::chrono::seconds reportInterval;
+        QueueTelemetryReporter reporter;
+
+        // Written by the consumer only
+        LatencyHistogram sojourn;
+        std::atomic<std::size_t> maxDepth;
+        std::chrono::steady_clock::time_point windowStart;
+        std::uint32_t pollsSinceClockCheck;
+        std::uint32_t idlePolls;        // Consecutive polls that found no work
+
+        // Cumulative metrics, written by the consumer only
+        Counter& jobs;
+        Gauge& queueDepth;
+        LatencyHistogram& totalSojourn;
+
+    public:
+        QueueTelemetry(const std::string& role, QueueTelemetryReporter reporter);
+
+        ~QueueTelemetry() = default;
+
+        // Timestamps are taken from the process wide Clock (the TSC where it is invariant), so they are cheap
+        // to take on every enqueue and comparable across threads
+        static inline std::int64_t now() noexcept
+        {
+            return Clock::nowNanos();
+        }
+
+        inline bool isEnabled() const noexcept { return enabled; }
+
+        // Called by the consumer for each job with the time the job was enqueued and the queue depth
+        inline void recordDequeue(std::int64_t enqueueNanos, std::size_t depth) noexcept
+        {
+            const std::int64_t sojournNanos = now() - enqueueNanos;
+            sojourn.record(sojournNanos > 0 ? static_cast<std::uint64_t>(sojournNanos) : 0);
+
+            if (depth > maxDepth.load(std::memory_order_relaxed)) maxDepth.store(depth, std::memory_order_relaxed);
+
+            jobs.add();
+            queueDepth.set(static_cast<double>(depth));
+            idlePolls = 0;
+        }
+
+        // Called by the consumer on every iteration of its event loop, busy or idle
+        inline void poll() noexcept
+        {
+            if (++pollsSinceClockCheck < POLLS_PER_CLOCK_CHECK) [[likely]] return;
+
+            pollsSinceClockCheck = 0;
+            if (std::chrono::steady_clock::now() - windowStart >= reportInterval) [[unlikely]] report();
+        }
+
+        // Called by the consumer each time its idle strategy returns, before poll. After POLLS_PER_CLOCK_CHECK
+        // empty polls the queue depth is published as 0, and as the idle strategy may now block for up to its
+        // longest wait on every poll, the clock is checked on each one. A spinning consumer only pays for the
+        // clock once its queue has been empty for that many polls
+        inline void pollIdle() noexcept
+        {
+            if (idlePolls < POLLS_PER_CLOCK_CHECK) [[likely]]
+            {
+                if (++idlePolls == POLLS_PER_CLOCK_CHECK) queueDepth.set(0.0);
+                return;
+            }
+
+            if (std::chrono::steady_clock::now() - windowStart >= reportInterval) [[unlikely]] report();
+        }
+
+        void report() noexcept;
+
+        const std::string& getRole() const noexcept;
+
+        const LatencyHistogram& getSojourn() const noexcept;
+
+        std::size_t getMaxDepth() const noexcept;
+
+        double getWindowSeconds() const noexcept;
+
+        // Deleted default ctors and assignment operators
+        QueueTelemetry() = delete;
+
+        QueueTelemetry(const QueueTelemetry& other) = delete;
+
+        QueueTelemetry(QueueTelemetry&& other) = delete;
+
+        QueueTelemetry& operator=(const QueueTelemetry& other) = delete;
+
+        QueueTelemetry& operator=(QueueTelemetry&& other) = delete;
+    };
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_QUEUETELEMETRY_HPP
@@ -0,0 +1,148 @@
+//
+// Tick-to-trade latency broken down by pipeline stage. Engines record the stamps of every book update
+// into their own histograms and periodically merge them into a shared collector that reports them.
+//
+// Created by Michael Lewis on 1/22/24.
+//
+
+#include <exception>
+#include <iostream>
+#include <utility>
+
+#include "StageLatency.hpp"
+#include "../logging/LogLevel.hpp"
+#include "../utils/ConfigManager.hpp"
+
+namespace BeaconTech::Common
+{
+    namespace
+    {
+        // Named after the stage each interval ends at
+        const std::array<std::string, StageLatencies::INTERVALS> INTERVAL_NAMES{
+            "tickToTrade", "book", "bbo", "publish", "queue", "features", "strategy"
+        };
+    }
+
+    // Converts the stamps to nanoseconds and records every interval. Updates with a missing stamp are
+    // skipped. The gateway and local clocks are not synchronized exactly, so negative intervals count as 0
+    void StageLatencies::record([[maybe_unused]] const StageStamps& stamps) noexcept
+    {
+#if BEACONTECH_LATENCY_TRACING
+        std::array<std::int64_t, PIPELINE_STAGES> nanos{};
+        nanos[0] = static_cast<std::int64_t>(stamps.receivedNanos);
+        if (nanos[0] == 0) return;
+
+        for (std::size_t stage = 1; stage < PIPELINE_STAGES; ++stage)
+        {
+            if (stamps.ticks[stage] == 0) return;
+            nanos[stage] = Clock::tscToEpochNanos(stamps.ticks[stage]);
+        }
+
+        const auto record = [this](std::size_t interval, std::int64_t elapsed) {
+            histograms[interval].record(elapsed > 0 ? static_cast<std::uint64_t>(elapsed) : 0);
+        };
+
+        record(0, nanos[PIPELINE_STAGES - 1] - nanos[0]);
+        for (std::size_t stage = 1; stage < PIPELINE_STAGES; ++stage)
+        {
+            record(stage, nanos[stage] - nanos[stage - 1]);
+        }
+#endif
+    }
+
+    // Must be called by the writer of this instance
+    void StageLatencies::merge(const StageLatencies& other) noexcept
+    {
+        for (std::size_t interval = 0; interval < INTERVALS; ++interval)
+        {
+            histograms[interval].merge(other.histograms[interval]);
+        }
+    }
+
+    void StageLatencies::reset() noexcept
+    {
+        for (auto& histogram : histograms) histogram.reset();
+    }
+
+    std::uint64_t StageLatencies::getCount() const noexcept
+    {
+        return histograms[0].getCount();
+    }
+
+    const LatencyHistogram& StageLatencies::getHistogram(std::size_t interval) const noexcept
+    {
+        return histograms[interval];
+    }
+
+    const std::string& StageLatencies::getIntervalName(std::size_t interval) noexcept
+    {
+        return INTERVAL_NAMES[interval];
+    }
+
+    StageLatencyCollector::StageLatencyCollector(StageLatencyReporter reporter)
+        : reportInterval{ConfigManager::config().latencyTraceSeconds},
+          enabled{LATENCY_TRACING && reportInterval.count() > 0},
+          reporter{std::move(reporter)}, merged{}, windowStart{std::chrono::steady_clock::now()}
+    {
+
+    }
+
+    // Merges the window of a recorder and reports once the collector's own window has elapsed. Recorders
+    // flush at the same interval, so each report covers roughly latencyTraceSeconds of every engine
+    void StageLatencyCollector::merge(const StageLatencies& window) noexcept
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        merged.merge(window);
+
+        if (std::chrono::steady_clock::now() - windowStart >= reportInterval) reportLocked();
+    }
+
+    // Reports whatever has been merged so far, e.g. at shutdown
+    void StageLatencyCollector::report() noexcept
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        reportLocked();
+    }
+
+    // Hands the merged window to the reporter and starts a new window. Empty windows are not reported
+    void StageLatencyCollector::reportLocked() noexcept
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (reporter && merged.getCount() > 0)
+        {
+            try
+            {
+                reporter(merged, std::chrono::duration<double>(now - windowStart).count());
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << LogLevel::WARN.getDesc() << " : Unable to report stage latencies - "
+                          << e.what() << std::endl;
+            }
+        }
+
+        merged.reset();
+        windowStart = now;
+    }
+
+    StageLatencyRecorder::StageLatencyRecorder(StageLatencyCollector& collector)
+        : collector{collector}, window{}, windowStart{std::chrono::steady_clock::now()}, recordsSinceClockCheck{0}
+    {
+
+    }
+
+    // Hands the last partial window to the collector
+    StageLatencyRecorder::~StageLatencyRecorder()
+    {
+        flush();
+    }
+
+    // Merges the window into the collector and starts a new window. Must be called by the owning thread
+    void StageLatencyRecorder::flush() noexcept
+    {
+        if (window.getCount() > 0) collector.merge(window);
+
+        window.reset();
+        windowStart = std::chrono::steady_clock::now();
+    }
+} // namespace BeaconTech::Common
@@ -0,0 +1,212 @@
+//
+// Tick-to-trade latency broken down by pipeline stage. Every book update carries a set of StageStamps
+// that each stage stamps as the update flows through the system:
+//
+// 1) RECEIVED          - Databento ts_recv (the time the gateway received the packet) for live feeds. Replays
+//                        use the local clock when the record is read, since ts_recv is from the original session
+// 2) BOOK_APPLIED      - OrderBook::apply has processed the last message of the packet
+// 3) BBO_BUILT         - OrderBook::getBbo has built the BBO
+// 4) PUBLISHED         - The update has been written to the engine's ring
+// 5) DEQUEUED          - The engine has read the update from its ring
+// 6) FEATURES_COMPUTED - FeatureEngine::onOrderBookUpdate has returned
+// 7) STRATEGY_DONE     - MarketMaker::onOrderBookUpdate has returned (e.g. an order request was sent)
+//
+// Stamps are raw Clock::readTsc readings and are only converted to nanoseconds by the engine that records
+// them. Each engine records into its own StageLatencyRecorder without synchronization and hands its
+// histograms to the shared StageLatencyCollector at the end of every window. The collector merges the
+// windows of every engine and reports p50/p99/p99.9/max per stage every latencyTraceSeconds.
+//
+// Stamping compiles out entirely unless BEACONTECH_LATENCY_TRACING is set (the CMake option of the same
+// name), in which case it can also be disabled at runtime:
+//
+//   "latencyTraceSeconds": "10"  (0 disables latency tracing)
+//
+// Created by Michael Lewis on 1/22/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_STAGELATENCY_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_STAGELATENCY_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+#include "LatencyHistogram.hpp"
+#include "../utils/Clock.hpp"
+
+#ifndef BEACONTECH_LATENCY_TRACING
+#define BEACONTECH_LATENCY_TRACING 0
+#endif
+
+namespace BeaconTech::Common
+{
+    // Forward Declarations
+    class StageLatencies;
+
+    enum class PipelineStage : std::uint8_t
+    {
+        RECEIVED = 0,
+        BOOK_APPLIED = 1,
+        BBO_BUILT = 2,
+        PUBLISHED = 3,
+        DEQUEUED = 4,
+        FEATURES_COMPUTED = 5,
+        STRATEGY_DONE = 6
+    };
+
+    inline constexpr std::size_t PIPELINE_STAGES = 7;
+
+    inline constexpr bool LATENCY_TRACING = BEACONTECH_LATENCY_TRACING != 0;
+
+    using StageLatencyReporter = std::function<void (const StageLatencies& latencies, double windowSeconds)>;
+
+    // The stamps of a single book update. Unstamped stages are 0. Empty when latency tracing is compiled out
+    struct StageStamps
+    {
+#if BEACONTECH_LATENCY_TRACING
+        std::uint64_t receivedNanos{0};                     // Nanoseconds since the UNIX epoch
+        std::array<std::uint64_t, PIPELINE_STAGES> ticks{}; // Clock::readTsc readings, indexed by stage
+#endif
+
+        inline void stampReceived([[maybe_unused]] std::int64_t epochNanos) noexcept
+        {
+#if BEACONTECH_LATENCY_TRACING
+            receivedNanos = static_cast<std::uint64_t>(epochNanos);
+#endif
+        }
+
+        inline void stamp([[maybe_unused]] PipelineStage stage) noexcept
+        {
+#if BEACONTECH_LATENCY_TRACING
+            ticks[static_cast<std::size_t>(stage)] = Clock::readTsc();
+#endif
+        }
+    };
+
+    // A histogram for each stage, measured from the previous stage, and one for the whole tick-to-trade
+    class StageLatencies final
+    {
+    public:
+        // Interval 0 is tick-to-trade (RECEIVED to STRATEGY_DONE). Interval N is stage N - 1 to stage N
+        static constexpr std::size_t INTERVALS = PIPELINE_STAGES;
+
+    private:
+        std::array<LatencyHistogram, INTERVALS> histograms;
+
+    public:
+        StageLatencies() = default;
+
+        ~StageLatencies() = default;
+
+        void record(const StageStamps& stamps) noexcept;
+
+        void merge(const StageLatencies& other) noexcept;
+
+        void reset() noexcept;
+
+        std::uint64_t getCount() const noexcept;
+
+        const LatencyHistogram& getHistogram(std::size_t interval) const noexcept;
+
+        static const std::string& getIntervalName(std::size_t interval) noexcept;
+
+        // Deleted default ctors and assignment operators
+        StageLatencies(const StageLatencies& other) = delete;
+
+        StageLatencies(StageLatencies&& other) = delete;
+
+        StageLatencies& operator=(const StageLatencies& other) = delete;
+
+        StageLatencies& operator=(StageLatencies&& other) = delete;
+    };
+
+    // Merges the windows of every recorder and reports them. Shared by the engine threads
+    class StageLatencyCollector final
+    {
+    private:
+        const std::chrono::seconds reportInterval;
+        const bool enabled;
+        StageLatencyReporter reporter;
+
+        std::mutex mutex;
+        StageLatencies merged;
+        std::chrono::steady_clock::time_point windowStart;
+
+        void reportLocked() noexcept;
+
+    public:
+        explicit StageLatencyCollector(StageLatencyReporter reporter);
+
+        ~StageLatencyCollector() = default;
+
+        inline bool isEnabled() const noexcept { return enabled; }
+
+        inline std::chrono::seconds getReportInterval() const noexcept { return reportInterval; }
+
+        void merge(const StageLatencies& window) noexcept;
+
+        void report() noexcept;
+
+        // Deleted default ctors and assignment operators
+        StageLatencyCollector() = delete;
+
+        StageLatencyCollector(const StageLatencyCollector& other) = delete;
+
+        StageLatencyCollector(StageLatencyCollector&& other) = delete;
+
+        StageLatencyCollector& operator=(const StageLatencyCollector& other) = delete;
+
+        StageLatencyCollector& operator=(StageLatencyCollector&& other) = delete;
+    };
+
+    // Records the stamps of one engine. Only the thread that owns the recorder may use it
+    class StageLatencyRecorder final
+    {
+    private:
+        // Only look at the clock once every RECORDS_PER_CLOCK_CHECK records to keep the clock off the hot path
+        static constexpr std::uint32_t RECORDS_PER_CLOCK_CHECK = 1024;
+
+        StageLatencyCollector& collector;
+        StageLatencies window;
+        std::chrono::steady_clock::time_point windowStart;
+        std::uint32_t recordsSinceClockCheck;
+
+    public:
+        explicit StageLatencyRecorder(StageLatencyCollector& collector);
+
+        ~StageLatencyRecorder();
+
+        inline void record([[maybe_unused]] const StageStamps& stamps) noexcept
+        {
+            if constexpr (LATENCY_TRACING)
+            {
+                if (!collector.isEnabled()) return;
+
+                window.record(stamps);
+                if (++recordsSinceClockCheck < RECORDS_PER_CLOCK_CHECK) [[likely]] return;
+
+                recordsSinceClockCheck = 0;
+                if (std::chrono::steady_clock::now() - windowStart >= collector.getReportInterval()) [[unlikely]] flush();
+            }
+        }
+
+        void flush() noexcept;
+
+        // Deleted default ctors and assignment operators
+        StageLatencyRecorder() = delete;
+
+        StageLatencyRecorder(const StageLatencyRecorder& other) = delete;
+
+        StageLatencyRecorder(StageLatencyRecorder&& other) = delete;
+
+        StageLatencyRecorder& operator=(const StageLatencyRecorder& other) = delete;
+
+        StageLatencyRecorder& operator=(StageLatencyRecorder&& other) = delete;
+    };
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_STAGELATENCY_HPP
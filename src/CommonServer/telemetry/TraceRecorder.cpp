@@ -0,0 +1,154 @@
+//
+// Records spans into per-thread ring buffers and dumps them at shutdown as a Chrome trace (JSON) file
+// that can be opened in Perfetto or chrome://tracing.
+//
+// Created by Michael Lewis on 1/23/24.
+//
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "TraceRecorder.hpp"
+#include "../logging/LogLevel.hpp"
+#include "../utils/ConfigManager.hpp"
+
+namespace BeaconTech::Common
+{
+    namespace
+    {
+        // Thread and span names are identifiers, but quotes and backslashes would still break the JSON
+        std::string escape(const std::string& value)
+        {
+            std::string escaped;
+            escaped.reserve(value.size());
+            for (char c : value)
+            {
+                if (c == '"' || c == '\\') escaped += '\\';
+                escaped += c;
+            }
+
+            return escaped;
+        }
+    }
+
+    // The ring size is rounded up to a power of two so that a slot is found with a mask
+    TraceRecorder::TraceRecorder()
+        : fileName{ConfigManager::config().traceFile},
+          bufferEvents{std::bit_ceil(std::max<std::size_t>(
+                  ConfigManager::config().traceBufferEvents, 1))}
+    {
+        sampleEvery = std::max(ConfigManager::config().traceSampleEvery, 1U);
+    }
+
+    TraceRecorder& TraceRecorder::getInstance()
+    {
+        static TraceRecorder instance{};
+        return instance;
+    }
+
+    // Enables tracing when a traceFile is configured. Call once the configs are loaded
+    void TraceRecorder::start()
+    {
+        if (!BEACONTECH_TRACE_SPANS) return;
+
+        TraceRecorder& recorder = getInstance();
+        if (recorder.fileName.empty()) return;
+
+        // Spans carry raw TSC readings that are only converted when they are dumped
+        Clock::calibrateTsc();
+        enabled.store(true, std::memory_order_relaxed);
+    }
+
+    // Creates the ring of the calling thread the first time it records a span. The thread is named after
+    // its role by the ThreadFactory
+    TraceBuffer* TraceRecorder::registerThread()
+    {
+        TraceRecorder& recorder = getInstance();
+
+        char threadName[16]{};
+        pthread_getname_np(pthread_self(), threadName, sizeof(threadName));
+
+        const std::lock_guard<std::mutex> lock{recorder.mutex};
+        if (!isEnabled()) return nullptr;
+
+        return recorder.buffers.emplace_back(std::make_unique<TraceBuffer>(threadName, gettid(),
+                                                                            recorder.bufferEvents)).get();
+    }
+
+    // Writes the spans of every thread as complete ("X") events with microsecond timestamps relative to
+    // the first span. The rings are read without synchronization, so call it once every traced thread has
+    // stopped, including the log flush workers (see LoggerManager::shutdown)
+    void TraceRecorder::dump()
+    {
+        if (!isEnabled()) return;
+
+        TraceRecorder& recorder = getInstance();
+        const std::lock_guard<std::mutex> lock{recorder.mutex};
+        enabled.store(false, std::memory_order_relaxed);
+
+        std::ofstream file{recorder.fileName, std::ios::out | std::ios::trunc};
+        if (!file.is_open())
+        {
+            std::cerr << LogLevel::WARN.getDesc() << " : Unable to open trace file " << recorder.fileName << std::endl;
+            return;
+        }
+
+        // The rings only hold the most recent spans of each thread
+        const auto firstEvent = [](const TraceBuffer& buffer) {
+            const std::uint64_t written = buffer.written.load(std::memory_order_acquire);
+            return written - std::min<std::uint64_t>(written, buffer.events.size());
+        };
+
+        std::int64_t origin = std::numeric_limits<std::int64_t>::max();
+        for (const auto& buffer : recorder.buffers)
+        {
+            const std::uint64_t written = buffer->written.load(std::memory_order_acquire);
+            for (std::uint64_t i = firstEvent(*buffer); i < written; ++i)
+            {
+                origin = std::min(origin, Clock::tscToEpochNanos(buffer->events[i & buffer->mask].beginTicks));
+            }
+        }
+
+        const int pid = getpid();
+        std::uint64_t spans = 0;
+        std::uint64_t overwritten = 0;
+        char line[512];
+        bool first = true;
+
+        file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        for (const auto& buffer : recorder.buffers)
+        {
+            file << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+                 << ",\"tid\":" << buffer->threadId << ",\"args\":{\"name\":\"" << escape(buffer->threadName) << "\"}}";
+            first = false;
+
+            const std::uint64_t written = buffer->written.load(std::memory_order_acquire);
+            overwritten += firstEvent(*buffer);
+            for (std::uint64_t i = firstEvent(*buffer); i < written; ++i)
+            {
+                const TraceEvent& event = buffer->events[i & buffer->mask];
+                const std::int64_t beginNanos = Clock::tscToEpochNanos(event.beginTicks);
+                const std::int64_t endNanos = Clock::tscToEpochNanos(event.endTicks);
+
+                std::snprintf(line, sizeof(line),
+                              ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%lld,\"ts\":%.3f,\"dur\":%.3f}",
+                              escape(event.name).c_str(), pid, static_cast<long long>(buffer->threadId),
+                              static_cast<double>(beginNanos - origin) / 1000.0,
+                              static_cast<double>(std::max<std::int64_t>(endNanos - beginNanos, 0)) / 1000.0);
+                file << line;
+                ++spans;
+            }
+        }
+        file << "\n]}\n";
+
+        std::cerr << LogLevel::INFO.getDesc() << " : Wrote " << spans << " spans to " << recorder.fileName
+                  << " (" << overwritten << " older spans were overwritten)" << std::endl;
+    }
+} // namespace BeaconTech::Common
@@ -0,0 +1,178 @@
+//
+// Records spans (a static name, the thread and its begin/end TSC readings) for offline profiling, e.g. of
+// a slow backtest replay. Every thread records into its own ring buffer without synchronization and the
+// rings are dumped at shutdown to a Chrome trace (JSON) file that can be opened in Perfetto or
+// chrome://tracing. Each ring keeps the most recent traceBufferEvents spans of its thread.
+//
+// A span is a scoped object. Spans are sampled to bound the overhead on hot paths: one in every
+// traceSampleEvery outermost spans of a thread is recorded together with every span nested in it, so
+// a sampled timeline is never missing its inner spans. Unsampled spans are always recorded:
+//
+//   TraceSpan span{"OrderBook::apply"};                  (sampled)
+//   TraceSpan span{"MarketDataHistoricalClient::replay", false};   (always recorded)
+//
+// Tracing is enabled by setting traceFile and compiles out entirely unless BEACONTECH_TRACE_SPANS is set
+// (the CMake option of the same name):
+//
+//   "traceFile": ""    "traceBufferEvents": "65536"    "traceSampleEvery": "1"
+//
+// Created by Michael Lewis on 1/23/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_TRACERECORDER_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_TRACERECORDER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../utils/Clock.hpp"
+
+#ifndef BEACONTECH_TRACE_SPANS
+#define BEACONTECH_TRACE_SPANS 0
+#endif
+
+namespace BeaconTech::Common
+{
+
+    struct TraceEvent
+    {
+        const char* name;
+        std::uint64_t beginTicks;
+        std::uint64_t endTicks;
+    };
+
+    // The ring of a single thread. Only the owning thread writes to it
+    struct TraceBuffer
+    {
+        const std::string threadName;
+        const std::int64_t threadId;
+        const std::uint64_t mask;
+        std::vector<TraceEvent> events;
+        std::atomic<std::uint64_t> written{0};
+
+        TraceBuffer(std::string threadName, std::int64_t threadId, std::size_t capacity)
+            : threadName{std::move(threadName)}, threadId{threadId}, mask{capacity - 1}, events(capacity) {}
+    };
+
+    class TraceRecorder final
+    {
+    private:
+        inline static std::atomic<bool> enabled{false};
+        inline static std::uint32_t sampleEvery{1};
+        inline static thread_local TraceBuffer* buffer{nullptr};
+        inline static thread_local std::uint32_t untilSample{1};
+        inline static thread_local std::uint32_t openSpans{0};   // Open sampled spans of the thread
+        inline static thread_local bool recording{false};        // The sampling decision of the outermost span
+
+        std::string fileName;
+        std::size_t bufferEvents;
+        std::mutex mutex;
+        std::vector<std::unique_ptr<TraceBuffer>> buffers;
+
+        TraceRecorder();
+
+        static TraceRecorder& getInstance();
+
+        static TraceBuffer* registerThread();
+
+    public:
+        ~TraceRecorder() = default;
+
+        static inline bool isEnabled() noexcept
+        {
+            return BEACONTECH_TRACE_SPANS && enabled.load(std::memory_order_relaxed);
+        }
+
+        // Opens a sampled span. Returns whether it is recorded, which the outermost open span decides
+        static inline bool enterSampled() noexcept
+        {
+            if (openSpans++ == 0)
+            {
+                recording = --untilSample == 0;
+                if (recording) untilSample = sampleEvery;
+            }
+
+            return recording;
+        }
+
+        static inline void exitSampled() noexcept
+        {
+            --openSpans;
+        }
+
+        static inline void end(const char* name, std::uint64_t beginTicks) noexcept
+        {
+            TraceBuffer* threadBuffer = buffer;
+            if (threadBuffer == nullptr) [[unlikely]]
+            {
+                threadBuffer = buffer = registerThread();
+                if (threadBuffer == nullptr) return;
+            }
+
+            const std::uint64_t index = threadBuffer->written.load(std::memory_order_relaxed);
+            threadBuffer->events[index & threadBuffer->mask] = TraceEvent{name, beginTicks, Clock::readTsc()};
+            threadBuffer->written.store(index + 1, std::memory_order_release);
+        }
+
+        static void start();
+
+        static void dump();
+
+        // Deleted default ctors and assignment operators
+        TraceRecorder(const TraceRecorder& other) = delete;
+
+        TraceRecorder(TraceRecorder&& other) = delete;
+
+        TraceRecorder& operator=(const TraceRecorder& other) = delete;
+
+        TraceRecorder& operator=(TraceRecorder&& other) = delete;
+    };
+
+    // Records the time from its construction to its destruction. The name must be a string literal (or
+    // otherwise outlive the dump)
+    class TraceSpan final
+    {
+    private:
+        const char* name;
+        std::uint64_t beginTicks;   // 0 when the span is not recorded
+        bool sampled;
+
+    public:
+        explicit TraceSpan(const char* name, bool sampled = true) noexcept
+            : name{name}, beginTicks{0}, sampled{false}
+        {
+            if (!TraceRecorder::isEnabled()) [[likely]] return;
+
+            this->sampled = sampled;
+            if (!sampled || TraceRecorder::enterSampled()) beginTicks = Clock::readTsc();
+        }
+
+        ~TraceSpan()
+        {
+            if (beginTicks != 0) [[unlikely]] TraceRecorder::end(name, beginTicks);
+            if (sampled) [[unlikely]] TraceRecorder::exitSampled();
+        }
+
+        // Drops the span, e.g. a poll that turned out to have no work
+        inline void cancel() noexcept { beginTicks = 0; }
+
+        // Deleted default ctors and assignment operators
+        TraceSpan() = delete;
+
+        TraceSpan(const TraceSpan& other) = delete;
+
+        TraceSpan(TraceSpan&& other) = delete;
+
+        TraceSpan& operator=(const TraceSpan& other) = delete;
+
+        TraceSpan& operator=(TraceSpan&& other) = delete;
+    };
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_TRACERECORDER_HPP
@@ -13,6 +13,7 @@
 #include "../../MarketData/OrderBook.hpp"
 #include "../../MessageObjects/marketdata/Quote.hpp"
 #include "../../MessageObjects/marketdata/PriceLevel.hpp"
+#include "../telemetry/StageLatency.hpp"
 
 namespace BeaconTech::Common
 {
@@ -30,7 +31,11 @@ namespace BeaconTech::Common
 
     using MdCallback = std::function<void (const std::uint32_t& instrumentId,
                                            const MarketData::Quote& quote,
-                                           const Bbo& bbo)>;
+                                           const Bbo& bbo,
+                                           const StageStamps& stamps)>;
+
+    // Invoked on the market data thread when no book update is pending (e.g. a read timed out or a replay ended)
+    using MdIdleCallback = std::function<void ()>;
 
 } // namespace BeaconTech::Common
 
@@ -1,19 +1,85 @@
 //
 // A simple utility class to measure elapsed time. Typical use cases are for profiling the
-// running time of algorithms.
+// running time of algorithms. Also owns the calibration of the process wide TSC clock.
 //
 // Created by Michael Lewis on 7/6/23.
 //
 
 #include <chrono>
+#include <cmath>
+#include <cstring>
+#include <ctime>
 #include <iostream>
-#include <sstream>
-#include <iomanip>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
 
 #include "Clock.hpp"
+#include "ConfigManager.hpp"
+#include "../logging/LogLevel.hpp"
 
 namespace BeaconTech::Common
 {
+    namespace
+    {
+        struct TscCalibration
+        {
+            std::mutex mutex;
+            bool calibrated{false};
+            TscSample anchor{};             // The first sample, so the rate is measured over the whole session
+            TscSample last{};
+            std::uint64_t intervalTicks{0}; // Ticks between recalibrations
+        };
+
+        TscCalibration calibration{};
+
+        std::int64_t clockNanos(clockid_t clock) noexcept
+        {
+            timespec time{};
+            clock_gettime(clock, &time);
+            return static_cast<std::int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+        }
+
+        // Reads the TSC directly, since Clock::readTsc only returns TSC readings once calibration is done
+        std::uint64_t rawTscOrdered() noexcept
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            unsigned int aux;
+            return __rdtscp(&aux);
+#else
+            return 0;
+#endif
+        }
+
+        // Brackets the clock reads between two TSC readings and keeps the tightest of a few attempts,
+        // so a preemption or an interrupt between the readings does not skew the sample
+        TscSample sampleTsc() noexcept
+        {
+            constexpr int ATTEMPTS = 5;
+
+            TscSample best{};
+            std::uint64_t bestWidth = UINT64_MAX;
+            for (int i = 0; i < ATTEMPTS; ++i)
+            {
+                const std::uint64_t before = rawTscOrdered();
+                const std::int64_t monotonicNanos = clockNanos(CLOCK_MONOTONIC);
+                const std::int64_t realtimeNanos = clockNanos(CLOCK_REALTIME);
+                const std::uint64_t after = rawTscOrdered();
+
+                if (after - before < bestWidth)
+                {
+                    bestWidth = after - before;
+                    best = TscSample{before + (after - before) / 2, monotonicNanos, realtimeNanos};
+                }
+            }
+
+            return best;
+        }
+    }
+
     Clock::Clock() : tradeDate_{std::chrono::sys_days{std::chrono::floor<std::chrono::days>(std::chrono::system_clock::now())}}
     {
 
@@ -54,17 +120,135 @@ namespace BeaconTech::Common
 
     const std::string Clock::getLocalDateAndTime()
     {
-        auto now = std::chrono::system_clock::now();
-        auto time = std::chrono::system_clock::to_time_t(now);
-//            auto tm = *std::gmtime(&time);
-        auto tm = *std::localtime(&time);
+        return getLocalDateAndTime(nowNanos());
+    }
+
+    // Formats a timestamp taken earlier (e.g. on another thread) as the local date and time
+    const std::string Clock::getLocalDateAndTime(std::int64_t epochNanos)
+    {
+        std::string dateAndTime(LOCAL_DATE_TIME_LENGTH, ' ');
+        formatLocalDateAndTime(epochNanos, dateAndTime.data());
+        return dateAndTime;
+    }
+
+    // Writes LOCAL_DATE_TIME_LENGTH characters. The date and time down to the second only changes once a
+    // second, so it is cached per thread rather than converted with localtime_r for every timestamp
+    void Clock::formatLocalDateAndTime(std::int64_t epochNanos, char* out) noexcept
+    {
+        constexpr std::int64_t NANOS_PER_SECOND = 1000000000;
+        constexpr std::size_t SECONDS_LENGTH = LOCAL_DATE_TIME_LENGTH - 9;   // yyyy-mm-dd HH:MM:SS.
+
+        thread_local std::int64_t cachedSecond = INT64_MIN;
+        thread_local char cachedPrefix[SECONDS_LENGTH + 1];
+
+        const std::int64_t second = epochNanos / NANOS_PER_SECOND;
+        if (second != cachedSecond)
+        {
+            const auto time = static_cast<std::time_t>(second);
+            // localtime_r rather than localtime, which shares a static buffer between threads
+            std::tm tm{};
+            localtime_r(&time, &tm);
+            std::strftime(cachedPrefix, sizeof(cachedPrefix), "%Y-%m-%d %H:%M:%S.", &tm);
+            cachedSecond = second;
+        }
+
+        std::memcpy(out, cachedPrefix, SECONDS_LENGTH);
+
+        std::int64_t nanos = epochNanos % NANOS_PER_SECOND;
+        for (std::size_t i = LOCAL_DATE_TIME_LENGTH; i > SECONDS_LENGTH; --i, nanos /= 10)
+        {
+            out[i - 1] = static_cast<char>('0' + nanos % 10);
+        }
+    }
+
+    // Determines if the TSC runs at a constant rate in every P-, C- and T-state (CPUID 0x80000007 EDX bit 8)
+    bool Clock::isTscInvariant() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0) return false;
+        return (edx & (1U << 8)) != 0;
+#else
+        return false;
+#endif
+    }
+
+    ClockSource Clock::getClockSource() noexcept
+    {
+        return tscEnabled.load(std::memory_order_relaxed) ? ClockSource::TSC : ClockSource::SYSTEM;
+    }
+
+    // Selects the clock source and calibrates the TSC once per process. Blocks for ~10ms the first time
+    // it is called, so call it during startup before any timestamps are taken. Calls made before the
+    // configs are loaded (e.g. by a Logger) keep the system clock, and the selection is made by
+    // ConfigManager::loadDefaultConfigs so that clockSource and tscRecalibrateSeconds are honored
+    void Clock::calibrateTsc()
+    {
+        if (!ConfigManager::isLoaded()) return;
+
+        const std::lock_guard<std::mutex> lock{calibration.mutex};
+        if (calibration.calibrated) return;
+        calibration.calibrated = true;
+
+        const bool tscConfigured = ConfigManager::config().clockSource == "TSC";
+        if (!tscConfigured) return;
+
+        if (!isTscInvariant())
+        {
+            std::cerr << LogLevel::WARN.getDesc()
+                      << " : The TSC is not invariant, falling back to the system clock" << std::endl;
+            return;
+        }
+
+        constexpr auto CALIBRATION_INTERVAL = std::chrono::milliseconds(10);
+        calibration.anchor = sampleTsc();
+        std::this_thread::sleep_for(CALIBRATION_INTERVAL);
+        const TscSample sample = sampleTsc();
+
+        const double ticksPerNano = static_cast<double>(sample.tsc - calibration.anchor.tsc)
+                                    / static_cast<double>(sample.monotonicNanos - calibration.anchor.monotonicNanos);
+        calibration.intervalTicks = static_cast<std::uint64_t>(
+                ticksPerNano * 1e9 * ConfigManager::config().tscRecalibrateSeconds);
+
+        calibration.last = calibration.anchor;
+        recalibrate(sample);
+
+        // Readings are only taken with rdtsc once there is a conversion for them
+        tscEnabled.store(true, std::memory_order_release);
+    }
+
+    // Re-measures the rate over the whole session, which averages out the error of the individual
+    // samples, and re-anchors the offset to CLOCK_REALTIME so NTP adjustments are followed. The log flush
+    // workers call this on every pass; it only samples the clocks once tscRecalibrateSeconds has passed
+    void Clock::recalibrateTscIfDue() noexcept
+    {
+        if (!tscEnabled.load(std::memory_order_relaxed)) return;
+
+        std::unique_lock<std::mutex> lock{calibration.mutex, std::try_to_lock};
+        if (!lock.owns_lock() || calibration.intervalTicks == 0) return;
+        if (readTsc() - calibration.last.tsc < calibration.intervalTicks) [[likely]] return;
+
+        recalibrate(sampleTsc());
+    }
+
+    // Publishes the conversion through the sequence lock. Called with the calibration mutex held
+    void Clock::recalibrate(const TscSample& sample) noexcept
+    {
+        const TscSample& anchor = calibration.anchor;
+        const double nanosPerTick = static_cast<double>(sample.monotonicNanos - anchor.monotonicNanos)
+                                    / static_cast<double>(sample.tsc - anchor.tsc);
+        const auto multiplier = static_cast<std::uint64_t>(std::llround(std::ldexp(nanosPerTick, SHIFT)));
+
+        const std::uint64_t sequence = conversion.sequence.load(std::memory_order_relaxed);
+        conversion.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
 
-        auto epoch = now.time_since_epoch();
-        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(epoch).count() % 1000000000;
+        conversion.baseTicks.store(sample.tsc, std::memory_order_relaxed);
+        conversion.baseNanos.store(sample.realtimeNanos, std::memory_order_relaxed);
+        conversion.multiplier.store(multiplier, std::memory_order_relaxed);
 
-        std::ostringstream oss;
-        oss << std::put_time(&tm, "%Y-%m-%d %T.") << ns;
-        return oss.str();
+        conversion.sequence.store(sequence + 2, std::memory_order_release);
+        calibration.last = sample;
     }
 
     const TimePoint &Clock::getStartTime() const
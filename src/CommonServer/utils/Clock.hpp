@@ -2,27 +2,94 @@
 // A simple utility class to measure elapsed time. Typical use cases are for profiling the
 // running time of algorithms.
 //
+// Clock also provides the process wide, low overhead timestamp source. The clock source is read from
+// config.json:
+//
+// 1) TSC    - Reads the invariant CPU timestamp counter (a few ns) and converts cycles to nanoseconds
+//             since the UNIX epoch with a multiply-shift. The rate is calibrated against CLOCK_MONOTONIC
+//             and the offset against CLOCK_REALTIME at startup and every tscRecalibrateSeconds
+// 2) SYSTEM - Reads the system clock. Used when the TSC is not invariant (it changes rate with the CPU
+//             frequency or stops in deep C-states) or the CPU has no TSC
+//
+//   "clockSource": "TSC"    "tscRecalibrateSeconds": "1"
+//
 // Created by Michael Lewis on 7/6/23.
 //
 
 #ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_CLOCK_HPP
 #define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_CLOCK_HPP
 
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 #include "../types/DateTimes.hpp"
 
 namespace BeaconTech::Common
 {
+    enum class ClockSource : std::int8_t
+    {
+        TSC = 0,
+        SYSTEM = 1
+    };
+
+    // A TSC reading paired with the clocks it is calibrated against
+    struct TscSample
+    {
+        std::uint64_t tsc;
+        std::int64_t monotonicNanos;
+        std::int64_t realtimeNanos;
+    };
+
+    // Converts ticks to nanoseconds since the UNIX epoch as
+    //   epochNanos = baseNanos + ((ticks - baseTicks) * multiplier) >> SHIFT
+    // Published with a sequence lock, so readers never block and never see a torn conversion
+    struct alignas(64) TscConversion
+    {
+        std::atomic<std::uint64_t> sequence{0};     // Odd while the conversion is being updated
+        std::atomic<std::uint64_t> baseTicks{0};
+        std::atomic<std::int64_t> baseNanos{0};
+        std::atomic<std::uint64_t> multiplier{0};   // Nanoseconds per tick << SHIFT
+    };
+
     class Clock
     {
     private:
+        static constexpr int SHIFT = 32;
+
+        // Tags the readings taken in SYSTEM mode. A TSC reading never has the top bit set (it would take
+        // decades of uptime), so a reading taken before the TSC was enabled still converts correctly after
+        static constexpr std::uint64_t SYSTEM_TICK = std::uint64_t{1} << 63;
+
+        // The 64 x 64 bit product of the conversion needs 128 bits (__extension__ keeps -Wpedantic quiet)
+        __extension__ using Uint128 = unsigned __int128;
+
+        inline static TscConversion conversion{};
+        inline static std::atomic<bool> tscEnabled{false};
+
         TimePoint startTime;
         TimePoint stopTime;
         TradeDate tradeDate_;
         UnixNanos timePoint;
 
+        static void recalibrate(const TscSample& sample) noexcept;
+
+        static inline std::int64_t systemNanos() noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
     public:
+        // The length of a formatted local date and time (yyyy-mm-dd HH:MM:SS.nnnnnnnnn)
+        static constexpr std::size_t LOCAL_DATE_TIME_LENGTH = 29;
+
         Clock();
 
         void start();
@@ -43,6 +110,80 @@ namespace BeaconTech::Common
 
         static const std::string getLocalDateAndTime();
 
+        static const std::string getLocalDateAndTime(std::int64_t epochNanos);
+
+        static void formatLocalDateAndTime(std::int64_t epochNanos, char* out) noexcept;
+
+        // Reads the raw timestamp counter. Use tscToEpochNanos to convert the reading. In SYSTEM mode a
+        // reading is the system clock in nanoseconds tagged with SYSTEM_TICK, so readings queued before
+        // calibrateTsc switches the source are still converted as system clock readings
+        static inline std::uint64_t readTsc() noexcept
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            if (tscEnabled.load(std::memory_order_relaxed)) [[likely]] return __rdtsc();
+#endif
+            return SYSTEM_TICK | static_cast<std::uint64_t>(systemNanos());
+        }
+
+        // Like readTsc, but waits for every earlier instruction to complete first (rdtscp). Use to
+        // close a measured interval so the work being measured cannot be reordered past the reading
+        static inline std::uint64_t readTscOrdered() noexcept
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            if (tscEnabled.load(std::memory_order_relaxed)) [[likely]]
+            {
+                unsigned int aux;
+                return __rdtscp(&aux);
+            }
+#endif
+            return SYSTEM_TICK | static_cast<std::uint64_t>(systemNanos());
+        }
+
+        // Converts a reading of readTsc to nanoseconds since the UNIX epoch. Readings from either clock
+        // source can be converted, whichever source is selected now
+        static inline std::int64_t tscToEpochNanos(std::uint64_t tsc) noexcept
+        {
+            if ((tsc & SYSTEM_TICK) != 0) return static_cast<std::int64_t>(tsc & ~SYSTEM_TICK);
+
+            std::uint64_t sequence;
+            std::uint64_t baseTicks;
+            std::int64_t baseNanos;
+            std::uint64_t multiplier;
+            do
+            {
+                sequence = conversion.sequence.load(std::memory_order_acquire);
+                baseTicks = conversion.baseTicks.load(std::memory_order_relaxed);
+                baseNanos = conversion.baseNanos.load(std::memory_order_relaxed);
+                multiplier = conversion.multiplier.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+            }
+            while ((sequence & 1) != 0 || sequence != conversion.sequence.load(std::memory_order_relaxed));
+
+            // Readings taken before the last recalibration are behind the base
+            if (tsc >= baseTicks) [[likely]]
+            {
+                return baseNanos + static_cast<std::int64_t>(
+                        (static_cast<Uint128>(tsc - baseTicks) * multiplier) >> SHIFT);
+            }
+
+            return baseNanos - static_cast<std::int64_t>(
+                    (static_cast<Uint128>(baseTicks - tsc) * multiplier) >> SHIFT);
+        }
+
+        // Nanoseconds since the UNIX epoch from the configured clock source
+        static inline std::int64_t nowNanos() noexcept
+        {
+            return tscToEpochNanos(readTsc());
+        }
+
+        static void calibrateTsc();
+
+        static void recalibrateTscIfDue() noexcept;
+
+        static bool isTscInvariant() noexcept;
+
+        static ClockSource getClockSource() noexcept;
+
         // Deleted default ctors and assignment operators
         Clock(const Clock& other) = delete;
 
@@ -0,0 +1,103 @@
+//
+// Every key that config.json may contain, declared once with its type and default. The list is expanded
+// into the fields of the ConfigSnapshot and into the table the ConfigManager validates config.json with,
+// so adding a key here is all it takes to make it loadable.
+//
+// KEY(name, type, default, scope) where scope is one of
+//
+// 1) GLOBAL - Only the unscoped key is valid (e.g. "logLanes")
+// 2) ROLE   - The key may also be scoped to a thread role or role group (e.g. "engine-0.idleMaxSpins"),
+//             falling back to the unscoped key. Scoped values are read with the role lookups of the
+//             ConfigManager
+// 3) SCOPED - The key is only valid scoped to a role or role group (e.g. "engine.cpus"). Its field in
+//             the snapshot is never read
+//
+// The supported types are bool ("true"/"false"), std::uint32_t, double and std::string. String keys that
+// name an enumerator (clockSource, idleStrategy, logLevel and logFsync) are also checked against their
+// allowed values by the ConfigManager.
+//
+// Created by Michael Lewis on 1/25/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_CONFIGKEYS_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_CONFIGKEYS_HPP
+
+#define BEACONTECH_CONFIG_KEYS(KEY)                                                           \
+    /* Environment */                                                                         \
+    KEY(environmentType,            std::string,   "Dev",                           GLOBAL)   \
+    KEY(clockSource,                std::string,   "TSC",                           GLOBAL)   \
+    KEY(tscRecalibrateSeconds,      std::uint32_t, 1,                               GLOBAL)   \
+    KEY(hugePages,                  bool,          true,                            GLOBAL)   \
+    KEY(lockMemory,                 bool,          false,                           GLOBAL)   \
+    KEY(reloadConfigs,              bool,          true,                            GLOBAL)   \
+                                                                                              \
+    /* Threads and queues */                                                                  \
+    KEY(cpus,                       std::string,   "",                              SCOPED)   \
+    KEY(numaNode,                   std::uint32_t, 0,                               SCOPED)   \
+    KEY(fifoPriority,               std::uint32_t, 0,                               SCOPED)   \
+    KEY(idleStrategy,               std::string,   "BUSY_SPIN",                     ROLE)     \
+    KEY(idleMaxSpins,               std::uint32_t, 1'000,                           ROLE)     \
+    KEY(idleMaxYields,              std::uint32_t, 100,                             ROLE)     \
+    KEY(idleMinSleepMicros,         std::uint32_t, 1,                               ROLE)     \
+    KEY(idleMaxSleepMicros,         std::uint32_t, 1'000,                           ROLE)     \
+    KEY(idleMaxParkMicros,          std::uint32_t, 100'000,                         ROLE)     \
+    KEY(queueTelemetrySeconds,      std::uint32_t, 10,                              ROLE)     \
+    KEY(ringSize,                   std::uint32_t, 4096,                            ROLE)     \
+    KEY(CLFQSize,                   std::uint32_t, 4096,                            GLOBAL)   \
+    KEY(numThreads,                 std::uint32_t, 1,                               GLOBAL)   \
+    KEY(numEngineThreads,           std::uint32_t, 1,                               GLOBAL)   \
+    KEY(numListeners,               std::uint32_t, 1,                               GLOBAL)   \
+    KEY(gateListenersOnEngine,      bool,          true,                            GLOBAL)   \
+                                                                                              \
+    /* Logging */                                                                             \
+    KEY(logLevel,                   std::string,   "INFO",                          GLOBAL)   \
+    KEY(logDirectory,               std::string,   "",                              GLOBAL)   \
+    KEY(logRingSize,                std::uint32_t, 2097152,                         GLOBAL)   \
+    KEY(logLanes,                   std::uint32_t, 16,                              GLOBAL)   \
+    KEY(logFlushThreads,            std::uint32_t, 1,                               GLOBAL)   \
+    KEY(logBufferSize,              std::uint32_t, 1048576,                         GLOBAL)   \
+    KEY(logFlushMicros,             std::uint32_t, 1000,                            GLOBAL)   \
+    KEY(logFsync,                   std::string,   "NEVER",                         GLOBAL)   \
+    KEY(logFsyncMillis,             std::uint32_t, 1000,                            GLOBAL)   \
+    KEY(logStatsSeconds,            std::uint32_t, 60,                              GLOBAL)   \
+    KEY(logRotateMegabytes,         std::uint32_t, 256,                             GLOBAL)   \
+    KEY(logRotateMinutes,           std::uint32_t, 1440,                            GLOBAL)   \
+    KEY(logCompressLevel,           std::uint32_t, 3,                               GLOBAL)   \
+    KEY(logArchiveMegabytes,        std::uint32_t, 4096,                            GLOBAL)   \
+                                                                                              \
+    /* Telemetry */                                                                           \
+    KEY(latencyTraceSeconds,        std::uint32_t, 10,                              GLOBAL)   \
+    KEY(traceFile,                  std::string,   "",                              GLOBAL)   \
+    KEY(traceBufferEvents,          std::uint32_t, 65536,                           GLOBAL)   \
+    KEY(traceSampleEvery,           std::uint32_t, 1,                               GLOBAL)   \
+    KEY(metricsOutput,              std::string,   "",                              GLOBAL)   \
+    KEY(metricsIntervalSeconds,     std::uint32_t, 10,                              GLOBAL)   \
+                                                                                              \
+    /* Market data */                                                                         \
+    KEY(dbnApiKey,                  std::string,   "",                              GLOBAL)   \
+    KEY(marketData,                 std::string,   "../src/marketdata/historicaldata", GLOBAL) \
+    KEY(fileToDownload,             std::string,   "",                              GLOBAL)   \
+    KEY(flatHistoricalDataFile,     std::string,   "",                              GLOBAL)   \
+    KEY(printBbo,                   bool,          false,                           GLOBAL)   \
+    KEY(printBboPerSecond,          std::uint32_t, 10,                              GLOBAL)   \
+                                                                                              \
+    /* Strategies */                                                                          \
+    KEY(instrumentRoutesFile,       std::string,   "",                              GLOBAL)   \
+    KEY(instrumentParamsFile,       std::string,   "",                              GLOBAL)   \
+    KEY(maxInstruments,             std::uint32_t, 4096,                            GLOBAL)   \
+    KEY(routingImbalanceThreshold,  double,        1.25,                            GLOBAL)   \
+    KEY(routingRebalanceSeconds,    std::uint32_t, 0,                               GLOBAL)   \
+    KEY(routingWarmupSeconds,       std::uint32_t, 0,                               GLOBAL)   \
+    KEY(targetSpreadBps,            double,        0.0002,                          GLOBAL)   \
+    KEY(targetSize,                 std::uint32_t, 100,                             GLOBAL)   \
+    KEY(featureHalfLifeMillis,      std::uint32_t, 1000,                            GLOBAL)   \
+    KEY(featureWindowMillis,        std::uint32_t, 1000,                            GLOBAL)   \
+    KEY(featureWindowCapacity,      std::uint32_t, 4096,                            GLOBAL)   \
+    KEY(featureSpreadEvents,        std::uint32_t, 100,                             GLOBAL)   \
+                                                                                              \
+    /* IPC */                                                                                 \
+    KEY(orderRequestRing,           std::string,   "/beacontech-order-requests",    GLOBAL)   \
+    KEY(executionReportRing,        std::string,   "/beacontech-execution-reports", GLOBAL)   \
+    KEY(ipcRingSize,                std::uint32_t, 4096,                            GLOBAL)
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_CONFIGKEYS_HPP
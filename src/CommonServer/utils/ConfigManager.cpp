@@ -7,38 +7,252 @@
 
 #include <cctype>
 #include <algorithm>
+#include <charconv>
 #include <fstream>
 #include <exception>
 #include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
 #include "ConfigManager.hpp"
+#include "Clock.hpp"
 #include "../logging/LogLevel.hpp"
 
 using json = nlohmann::json;
 
 namespace BeaconTech::Common
 {
-    // Loads a JSON formatted config file and builds an unordered map from the key-value pair
-    void ConfigManager::loadDefaultConfigs()
+    namespace
     {
-        try
+        enum class ConfigScope : std::int8_t
+        {
+            GLOBAL = 0,
+            ROLE = 1,
+            SCOPED = 2
+        };
+
+        // A declared key and how to parse its value into a snapshot
+        struct ConfigKey
+        {
+            std::string_view name;
+            std::string_view type;
+            ConfigScope scope;
+            bool (*parse)(const std::string& text, ConfigSnapshot& snapshot);
+        };
+
+        // Compares text to an expected value in lower or upper case
+        bool equalsIgnoreCase(std::string_view text, std::string_view expected)
         {
-            static std::ifstream configFile{filePath, std::ios::in};
-            static nlohmann::json json = json::parse(configFile);
+            return std::equal(text.cbegin(), text.cend(), expected.cbegin(), expected.cend(),
+                              [](char lhs, char rhs) { return std::tolower(lhs) == std::tolower(rhs); });
+        }
+
+        bool parseValue(const std::string& text, bool& value)
+        {
+            if (equalsIgnoreCase(text, "true")) value = true;
+            else if (equalsIgnoreCase(text, "false")) value = false;
+            else return false;
+
+            return true;
+        }
+
+        // The whole value must be a number that fits the type
+        template<typename T>
+        bool parseNumber(const std::string& text, T& value)
+        {
+            const char* end = text.data() + text.size();
+            const auto result = std::from_chars(text.data(), end, value);
+            return result.ec == std::errc{} && result.ptr == end;
+        }
+
+        bool parseValue(const std::string& text, std::uint32_t& value)
+        {
+            return parseNumber(text, value);
+        }
+
+        bool parseValue(const std::string& text, double& value)
+        {
+            return parseNumber(text, value);
+        }
+
+        bool parseValue(const std::string& text, std::string& value)
+        {
+            value = text;
+            return true;
+        }
 
-            // Uses structured binding to access the key:value pair from the object
-            for (auto& [key, val] : json.items())
+#define BEACONTECH_CONFIG_KEY(name, type, defaultValue, scope)                                    \
+        ConfigKey{#name, #type, ConfigScope::scope,                                            \
+                  [](const std::string& text, ConfigSnapshot& snapshot) { return parseValue(text, snapshot.name); }},
+
+        const ConfigKey CONFIG_KEYS[] = {
+            BEACONTECH_CONFIG_KEYS(BEACONTECH_CONFIG_KEY)
+        };
+
+#undef BEACONTECH_CONFIG_KEY
+
+        // String keys that name an enumerator. The components that read them fall back to a default for an
+        // unknown name, so any other value is rejected here instead of being silently ignored
+        struct ConfigChoices
+        {
+            std::string_view name;
+            std::vector<std::string_view> values;
+            bool ignoreCase;
+        };
+
+        const ConfigChoices CONFIG_CHOICES[] = {
+            {"clockSource", {"TSC", "SYSTEM"}, false},
+            {"idleStrategy", {"BUSY_SPIN", "SPIN_YIELD", "BACKOFF", "PARK"}, true},
+            {"logLevel", {"DEBUG", "INFO", "WARN", "ERROR"}, false},
+            {"logFsync", {"NEVER", "INTERVAL", "ALWAYS"}, false}
+        };
+
+        const ConfigChoices* findConfigChoices(std::string_view name)
+        {
+            const auto choices = std::find_if(std::begin(CONFIG_CHOICES), std::end(CONFIG_CHOICES),
+                                              [name](const ConfigChoices& candidate) { return candidate.name == name; });
+            return choices == std::end(CONFIG_CHOICES) ? nullptr : choices;
+        }
+
+        bool isChoice(const ConfigChoices& choices, const std::string& value)
+        {
+            return std::any_of(choices.values.cbegin(), choices.values.cend(), [&](std::string_view choice) {
+                return choices.ignoreCase ? equalsIgnoreCase(value, choice) : value == choice;
+            });
+        }
+
+        // e.g. "one of TSC, SYSTEM"
+        std::string describeChoices(const ConfigChoices& choices)
+        {
+            std::string description = "one of ";
+            for (std::size_t i = 0; i < choices.values.size(); ++i)
             {
-                configs.emplace(key, val);
+                if (i > 0) description += ", ";
+                description += choices.values[i];
             }
+
+            return description;
+        }
+
+        const ConfigKey* findConfigKey(std::string_view name)
+        {
+            const auto key = std::find_if(std::begin(CONFIG_KEYS), std::end(CONFIG_KEYS),
+                                          [name](const ConfigKey& candidate) { return candidate.name == name; });
+            return key == std::end(CONFIG_KEYS) ? nullptr : key;
+        }
+
+        // Parses every config into a snapshot. Scoped configs (role.key) are parsed into a scratch snapshot
+        // since only the role lookups read them. Returns a description of every invalid config
+        std::vector<std::string> parseConfigs(const std::unordered_map<std::string, std::string>& configs,
+                                              ConfigSnapshot& snapshot)
+        {
+            std::vector<std::string> errors;
+            ConfigSnapshot scratch{};
+
+            for (const auto& [name, value] : configs)
+            {
+                const auto dot = name.find_last_of('.');
+                const bool scoped = dot != std::string::npos;
+                const ConfigKey* key = findConfigKey(scoped ? std::string_view{name}.substr(dot + 1) : std::string_view{name});
+
+                const bool known = key != nullptr && (scoped ? dot > 0 && key->scope != ConfigScope::GLOBAL
+                                                             : key->scope != ConfigScope::SCOPED);
+                if (!known)
+                {
+                    errors.push_back("Unknown config " + name);
+                    continue;
+                }
+
+                if (!key->parse(value, scoped ? scratch : snapshot))
+                {
+                    errors.push_back("Invalid value \"" + value + "\" for config " + name + " (" +
+                                     std::string{key->type} + ")");
+                }
+                else if (const ConfigChoices* choices = findConfigChoices(key->name);
+                         choices != nullptr && !isChoice(*choices, value))
+                {
+                    errors.push_back("Invalid value \"" + value + "\" for config " + name + " (" +
+                                     describeChoices(*choices) + ")");
+                }
+            }
+
+            return errors;
+        }
+    }
+
+    ConfigSnapshot& ConfigManager::snapshot() noexcept
+    {
+        static ConfigSnapshot instance{};
+        return instance;
+    }
+
+    const ConfigSnapshot& ConfigManager::config() noexcept
+    {
+        return snapshot();
+    }
+
+    const std::string& ConfigManager::getFilePath() noexcept
+    {
+        return filePath;
+    }
+
+    // Reads the JSON formatted config file into a map of key-value pairs. Throws if it cannot be parsed
+    std::unordered_map<std::string, std::string> ConfigManager::readConfigFile()
+    {
+        std::ifstream configFile{filePath, std::ios::in};
+        const nlohmann::json json = json::parse(configFile);
+
+        // Uses structured binding to access the key:value pair from the object
+        std::unordered_map<std::string, std::string> values;
+        for (auto& [key, val] : json.items())
+        {
+            values.emplace(key, val.is_string() ? val.get<std::string>() : val.dump());
+        }
+
+        return values;
+    }
+
+    // Reads the config file again for the ConfigReloader. Returns a description of every invalid config
+    std::vector<std::string> ConfigManager::reloadConfigFile(ConfigSnapshot& loaded)
+    {
+        return parseConfigs(readConfigFile(), loaded);
+    }
+
+    // Loads a JSON formatted config file, builds an unordered map from the key-value pair and parses it
+    // into the typed snapshot. Throws if any config is unknown or has a value of the wrong type
+    void ConfigManager::loadDefaultConfigs()
+    {
+        try
+        {
+            configs = readConfigFile();
         }
         catch (const std::exception& e)
         {
             std::cerr << Common::LogLevel::SEVERE.getDesc()
                       << " : Unable to load default configs - " << e.what() << std::endl;
         }
+
+        ConfigSnapshot loaded{};
+        const std::vector<std::string> errors = parseConfigs(configs, loaded);
+        if (!errors.empty())
+        {
+            for (const auto& error : errors)
+            {
+                std::cerr << Common::LogLevel::SEVERE.getDesc() << " : " << error << std::endl;
+            }
+
+            throw std::runtime_error("Invalid configs in " + filePath);
+        }
+
+        snapshot() = std::move(loaded);
+        latestSnapshot.store(&snapshot(), std::memory_order_release);
+
+        // The clock source is only selected once the configs are loaded, so clockSource is honored
+        Clock::calibrateTsc();
     }
 
     // Extracts a string value from the config. Default if null
@@ -73,4 +287,22 @@ namespace BeaconTech::Common
         auto config = configs.find(configName);
         return config == configs.cend() ? defaultValue : std::stod(config->second);
     }
+
+    // Extracts a string value scoped to a thread role (e.g. engine-0.idleStrategy).
+    // Falls back to the unscoped config and then to the default if both are null
+    std::string ConfigManager::roleConfigValueDefaultIfNull(const std::string& role, const std::string& configName,
+                                                            const std::string& defaultValue)
+    {
+        auto config = configs.find(role + "." + configName);
+        return config == configs.cend() ? stringConfigValueDefaultIfNull(configName, defaultValue) : config->second;
+    }
+
+    // Extracts a string value scoped to a thread role and converts it into an int.
+    // Falls back to the unscoped config and then to the default if both are null
+    uint32_t ConfigManager::roleIntConfigValueDefaultIfNull(const std::string& role, const std::string& configName,
+                                                            const uint32_t& defaultValue)
+    {
+        auto config = configs.find(role + "." + configName);
+        return config == configs.cend() ? intConfigValueDefaultIfNull(configName, defaultValue) : std::stoi(config->second);
+    }
 } // namespace BeaconTech::Common
\ No newline at end of file
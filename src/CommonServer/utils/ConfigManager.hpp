@@ -1,6 +1,18 @@
 //
 // Loads configs from a JSON file into a highly efficient unordered map that can be accessed
-// by all system components to customize runtime behavior
+// by all system components to customize runtime behavior.
+//
+// Every key is declared in ConfigKeys.hpp and parsed once at load into a typed ConfigSnapshot, so hot
+// code reads plain fields instead of parsing strings:
+//
+//   if (ConfigManager::config().printBbo) ...
+//
+// Unknown keys and values that do not parse as the type of their key are rejected when the configs
+// are loaded. Role scoped keys (e.g. engine-0.idleStrategy) are validated the same way and read with
+// the role lookups.
+//
+// config() always returns the configs loaded at startup. When the ConfigReloader is watching the file,
+// threads that hold a ConfigReader also see the snapshots it publishes (see ConfigReloader.hpp).
 //
 // Created by Michael Lewis on 9/29/23.
 //
@@ -8,20 +20,67 @@
 #ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_CONFIGMANAGER_HPP
 #define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_CONFIGMANAGER_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+#include "ConfigKeys.hpp"
 
 namespace BeaconTech::Common
 {
+    // The value of every declared key, either from config.json or its default
+    struct ConfigSnapshot
+    {
+#define BEACONTECH_CONFIG_FIELD(name, type, defaultValue, scope) type name{defaultValue};
+        BEACONTECH_CONFIG_KEYS(BEACONTECH_CONFIG_FIELD)
+#undef BEACONTECH_CONFIG_FIELD
+
+        // 0 for the configs loaded at startup and incremented by every reload
+        std::uint64_t version{0};
+
+        bool operator==(const ConfigSnapshot& other) const = default;
+    };
+
     class ConfigManager
     {
     private:
         inline static const std::string filePath = "/Users/mlewis/CLionProjects/Multi-Threaded-Algorithmic-Trading-System/src/CommonServer/resources/config.json";
         inline static std::unordered_map<std::string, std::string> configs{};
 
+        // The latest snapshot. Published by the ConfigReloader after a reload
+        inline static std::atomic<const ConfigSnapshot*> latestSnapshot{nullptr};
+
+        static ConfigSnapshot& snapshot() noexcept;
+
+        static std::unordered_map<std::string, std::string> readConfigFile();
+
+        static std::vector<std::string> reloadConfigFile(ConfigSnapshot& loaded);
+
+        friend class ConfigReloader;
+
     public:
         static void loadDefaultConfigs();
 
+        // The typed configs loaded at startup. Holds the defaults until the configs are loaded
+        static const ConfigSnapshot& config() noexcept;
+
+        // The latest snapshot, which may be reclaimed after the next reload. Only a ConfigReader may hold it
+        static inline const ConfigSnapshot* latest() noexcept
+        {
+            const ConfigSnapshot* latest = latestSnapshot.load(std::memory_order_acquire);
+            return latest == nullptr ? &config() : latest;
+        }
+
+        // Determines if loadDefaultConfigs has run, i.e. config() no longer holds the defaults
+        static inline bool isLoaded() noexcept
+        {
+            return latestSnapshot.load(std::memory_order_acquire) != nullptr;
+        }
+
+        static const std::string& getFilePath() noexcept;
+
         static std::string stringConfigValueDefaultIfNull(const std::string& configName, const std::string& defaultValue);
 
         static bool boolConfigValueDefaultIfNull(const std::string& configName, const bool& defaultValue);
@@ -29,6 +88,12 @@ namespace BeaconTech::Common
         static uint32_t intConfigValueDefaultIfNull(const std::string& configName, const uint32_t& defaultValue);
 
         static double doubleConfigValueDefaultIfNull(const std::string& configName, const double& defaultValue);
+
+        static std::string roleConfigValueDefaultIfNull(const std::string& role, const std::string& configName,
+                                                        const std::string& defaultValue);
+
+        static uint32_t roleIntConfigValueDefaultIfNull(const std::string& role, const std::string& configName,
+                                                        const uint32_t& defaultValue);
     };
 } // namespace BeaconTech::Common
 
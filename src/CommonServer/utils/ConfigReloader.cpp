@@ -0,0 +1,203 @@
+//
+// Reloads config.json when it changes and publishes the new snapshot to the ConfigReaders of the engine
+// threads. Replaced snapshots are deleted once every reader has moved past them.
+//
+// Created by Michael Lewis on 1/26/24.
+//
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "ConfigReloader.hpp"
+#include "../concurrency/ThreadFactory.hpp"
+#include "../logging/LogLevel.hpp"
+
+namespace BeaconTech::Common
+{
+    namespace
+    {
+        // Replaced snapshots are also reclaimed when the file has not changed for this long
+        constexpr int RECLAIM_INTERVAL_MILLIS = 1000;
+    }
+
+    ConfigReader::ConfigReader() : snapshot{nullptr}, version{0}
+    {
+        snapshot = ConfigReloader::getInstance().addReader(*this);
+    }
+
+    ConfigReader::~ConfigReader()
+    {
+        ConfigReloader::getInstance().removeReader(*this);
+    }
+
+    ConfigReloader::ConfigReloader() : inotifyFd{-1}, wakeFd{-1}
+    {
+
+    }
+
+    // Readers that outlive the reloader fall back to the startup configs
+    ConfigReloader::~ConfigReloader()
+    {
+        stop();
+        ConfigManager::latestSnapshot.store(&ConfigManager::config(), std::memory_order_release);
+    }
+
+    // Constructed by start() or the first ConfigReader, so it is destroyed after every reader with static storage
+    ConfigReloader& ConfigReloader::getInstance()
+    {
+        static ConfigReloader instance{};
+        return instance;
+    }
+
+    // Watches the directory rather than the file, so that editors that save by replacing the file are seen
+    void ConfigReloader::start()
+    {
+        ConfigReloader& reloader = getInstance();
+        if (!ConfigManager::config().reloadConfigs || reloader.thread.joinable()) return;
+
+        const std::filesystem::path path{ConfigManager::getFilePath()};
+        reloader.inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        reloader.wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (reloader.inotifyFd < 0 || reloader.wakeFd < 0 ||
+            inotify_add_watch(reloader.inotifyFd, path.parent_path().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+        {
+            std::cerr << LogLevel::WARN.getDesc() << " : Unable to watch " << path << " for changes - "
+                      << std::strerror(errno) << std::endl;
+            stop();
+            return;
+        }
+
+        reloader.thread = ThreadFactory::createThread("config-reloader", [&reloader]() { reloader.run(); });
+    }
+
+    void ConfigReloader::stop()
+    {
+        ConfigReloader& reloader = getInstance();
+        if (reloader.thread.joinable())
+        {
+            const std::uint64_t wake = 1;
+            [[maybe_unused]] const ssize_t written = write(reloader.wakeFd, &wake, sizeof(wake));
+            reloader.thread.join();
+        }
+
+        if (reloader.inotifyFd >= 0) close(reloader.inotifyFd);
+        if (reloader.wakeFd >= 0) close(reloader.wakeFd);
+        reloader.inotifyFd = -1;
+        reloader.wakeFd = -1;
+    }
+
+    // Registers the reader with the latest snapshot. The reader's version is set under the lock so that
+    // the snapshot cannot be reclaimed before the reader is seen
+    const ConfigSnapshot* ConfigReloader::addReader(ConfigReader& reader)
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        const ConfigSnapshot* latest = ConfigManager::latest();
+        reader.version.store(latest->version, std::memory_order_relaxed);
+        readers.push_back(&reader);
+
+        return latest;
+    }
+
+    void ConfigReloader::removeReader(ConfigReader& reader)
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        readers.erase(std::remove(readers.begin(), readers.end(), &reader), readers.end());
+    }
+
+    void ConfigReloader::run()
+    {
+        const std::string fileName = std::filesystem::path{ConfigManager::getFilePath()}.filename().string();
+        std::array<pollfd, 2> fds{pollfd{inotifyFd, POLLIN, 0}, pollfd{wakeFd, POLLIN, 0}};
+        alignas(inotify_event) char events[4096];
+
+        while (true)
+        {
+            if (poll(fds.data(), fds.size(), RECLAIM_INTERVAL_MILLIS) < 0 && errno != EINTR) break;
+            if (fds[1].revents != 0) break;
+
+            // A save usually raises several events, but the file only needs to be read once
+            bool changed = false;
+            ssize_t length;
+            while ((length = read(inotifyFd, events, sizeof(events))) > 0)
+            {
+                for (ssize_t offset = 0; offset < length;)
+                {
+                    const auto* event = reinterpret_cast<const inotify_event*>(events + offset);
+                    if (event->len > 0 && fileName == event->name) changed = true;
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                }
+            }
+
+            if (changed) reload();
+            reclaim();
+        }
+    }
+
+    // Parses the file into a new snapshot and publishes it if it is valid and differs from the latest one
+    void ConfigReloader::reload()
+    {
+        auto loaded = std::make_unique<ConfigSnapshot>();
+        try
+        {
+            const std::vector<std::string> errors = ConfigManager::reloadConfigFile(*loaded);
+            for (const auto& error : errors)
+            {
+                std::cerr << LogLevel::WARN.getDesc() << " : " << error << std::endl;
+            }
+
+            if (!errors.empty())
+            {
+                std::cerr << LogLevel::WARN.getDesc() << " : Keeping the current configs" << std::endl;
+                return;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << LogLevel::WARN.getDesc() << " : Unable to reload configs - " << e.what() << std::endl;
+            return;
+        }
+
+        const ConfigSnapshot* latest = ConfigManager::latest();
+        loaded->version = latest->version;
+        if (*loaded == *latest) return;
+
+        loaded->version = latest->version + 1;
+        const ConfigSnapshot* published = loaded.get();
+        {
+            const std::lock_guard<std::mutex> lock{mutex};
+            snapshots.push_back(std::move(loaded));
+        }
+
+        ConfigManager::latestSnapshot.store(published, std::memory_order_release);
+        std::cerr << LogLevel::INFO.getDesc() << " : Reloaded configs version=" << published->version << std::endl;
+    }
+
+    // Deletes the replaced snapshots that are older than the snapshot of every reader
+    void ConfigReloader::reclaim()
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        const ConfigSnapshot* latest = ConfigManager::latest();
+
+        std::uint64_t oldestInUse = std::numeric_limits<std::uint64_t>::max();
+        for (const ConfigReader* reader : readers)
+        {
+            oldestInUse = std::min(oldestInUse, reader->version.load(std::memory_order_acquire));
+        }
+
+        std::erase_if(snapshots, [latest, oldestInUse](const std::unique_ptr<ConfigSnapshot>& snapshot) {
+            return snapshot.get() != latest && snapshot->version < oldestInUse;
+        });
+    }
+} // namespace BeaconTech::Common
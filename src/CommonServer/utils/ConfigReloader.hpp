@@ -0,0 +1,117 @@
+//
+// Reloads config.json when it changes so that parameters such as targetSpreadBps can be tuned without a
+// restart. A background thread (role config-reloader) watches the file with inotify, parses it into a new
+// immutable ConfigSnapshot and publishes it with an atomic pointer swap. A file that fails validation is
+// reported and the current snapshot is kept.
+//
+// Engine threads read the configs through a ConfigReader and call refresh() at an event boundary (e.g.
+// before each book update) to pick up the latest snapshot, so the read path takes no locks. Every reader
+// publishes the version of the snapshot it is using, and a replaced snapshot is deleted once every reader
+// has moved past it. Keys that are only read when a component is created (e.g. logLanes) still need a
+// restart, as do role scoped keys, and code that reads ConfigManager::config() keeps the startup configs.
+//
+//   "reloadConfigs": "true"
+//
+// Created by Michael Lewis on 1/26/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_CONFIGRELOADER_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_CONFIGRELOADER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ConfigManager.hpp"
+
+namespace BeaconTech::Common
+{
+
+    // A single thread's view of the configs. Only the owning thread may call refresh() or get()
+    class ConfigReader final
+    {
+    private:
+        const ConfigSnapshot* snapshot;
+        std::atomic<std::uint64_t> version;   // The version of the snapshot in use, read by the reloader
+
+        friend class ConfigReloader;
+
+    public:
+        ConfigReader();
+
+        ~ConfigReader();
+
+        // Moves to the latest snapshot. Returns true if it changed, after which references into the
+        // previous snapshot must no longer be used
+        inline bool refresh() noexcept
+        {
+            const ConfigSnapshot* latest = ConfigManager::latest();
+            if (latest == snapshot) [[likely]] return false;
+
+            snapshot = latest;
+            version.store(latest->version, std::memory_order_release);
+            return true;
+        }
+
+        inline const ConfigSnapshot& get() const noexcept { return *snapshot; }
+
+        // Deleted default ctors and assignment operators
+        ConfigReader(const ConfigReader& other) = delete;
+
+        ConfigReader(ConfigReader&& other) = delete;
+
+        ConfigReader& operator=(const ConfigReader& other) = delete;
+
+        ConfigReader& operator=(ConfigReader&& other) = delete;
+    };
+
+    class ConfigReloader final
+    {
+    private:
+        std::mutex mutex;
+        std::vector<ConfigReader*> readers;
+        std::vector<std::unique_ptr<ConfigSnapshot>> snapshots;   // Reloaded snapshots that may still be read
+
+        int inotifyFd;
+        int wakeFd;
+        std::thread thread;
+
+        ConfigReloader();
+
+        void run();
+
+        void reload();
+
+        void reclaim();
+
+    public:
+        ~ConfigReloader();
+
+        static ConfigReloader& getInstance();
+
+        // Starts watching config.json if reloadConfigs is set. Call once the configs are loaded
+        static void start();
+
+        static void stop();
+
+        // Called by a ConfigReader when it is created, returning the snapshot it starts with
+        const ConfigSnapshot* addReader(ConfigReader& reader);
+
+        void removeReader(ConfigReader& reader);
+
+        // Deleted default ctors and assignment operators
+        ConfigReloader(const ConfigReloader& other) = delete;
+
+        ConfigReloader(ConfigReloader&& other) = delete;
+
+        ConfigReloader& operator=(const ConfigReloader& other) = delete;
+
+        ConfigReloader& operator=(ConfigReloader&& other) = delete;
+    };
+
+} // namespace BeaconTech::Common
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_CONFIGRELOADER_HPP
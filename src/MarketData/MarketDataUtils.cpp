@@ -24,9 +24,29 @@ using namespace std::chrono_literals;
 namespace BeaconTech::MarketData
 {
 
+    namespace
+    {
+        // Microseconds since the start of the window, which then restarts
+        std::int64_t restartWindow(std::chrono::steady_clock::time_point& windowStart)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - windowStart);
+            windowStart = now;
+            return elapsed.count();
+        }
+    }
+
+    // Created on first use rather than during static initialization, so that the logger and the
+    // LoggerManager and MetricsRegistry it creates read the configs loaded by main()
+    const BeaconTech::Common::Logger& MarketDataUtils::logger()
+    {
+        static const BeaconTech::Common::Logger instance{CLASS_PATH, APP_NAME, 0};
+        return instance;
+    }
+
     MarketDataUtils::MarketDataUtils()
     {
-        clock.start();
+
     }
 
     // Build the market data client. Retry up to a maximum of 10 times before throwing an error
@@ -39,28 +59,26 @@ namespace BeaconTech::MarketData
             {
                 ++attempts;
                 return databento::HistoricalBuilder{}
-                        .SetKey(Common::ConfigManager::stringConfigValueDefaultIfNull("dbnApiKey", ""))
+                        .SetKey(Common::ConfigManager::config().dbnApiKey)
                         .Build();
             }
             catch (const databento::HttpResponseError& e)
             {
-                std::string msg = "Unable to connect to market data client - Attempt="
-                        + std::to_string(attempts) + ": " + e.what();
-                LOGGER.logWarn(CLASS, "getHistoricalClient", msg.c_str());
+                logger().logWarn(CLASS, "getHistoricalClient", "Unable to connect to market data client - Attempt=%: %",
+                               attempts, e.what());
                 if (attempts == 10)
                 {
-                    LOGGER.logSevere(CLASS, "getHistoricalClient", "Exceeded max attempts connecting to market data provider");
+                    logger().logSevere(CLASS, "getHistoricalClient", "Exceeded max attempts connecting to market data provider");
                     throw e;
                 }
             }
             catch (const std::exception& e)
             {
-                std::string msg = "Unable to connect to market data client - Attempt="
-                        + std::to_string(attempts) + ": " + e.what();
-                LOGGER.logWarn(CLASS, "getHistoricalClient", msg.c_str());
+                logger().logWarn(CLASS, "getHistoricalClient", "Unable to connect to market data client - Attempt=%: %",
+                               attempts, e.what());
                 if (attempts == 10)
                 {
-                    LOGGER.logSevere(CLASS, "getHistoricalClient", "Exceeded max attempts connecting to market data provider");
+                    logger().logSevere(CLASS, "getHistoricalClient", "Exceeded max attempts connecting to market data provider");
                     throw e;
                 }
             }
@@ -72,9 +90,8 @@ namespace BeaconTech::MarketData
             }
             catch (const std::exception& e)
             {
-                std::string msg = "Unable to connect to market data client - Attempt="
-                        + std::to_string(attempts) + ": " + e.what();
-                LOGGER.logWarn(CLASS, "getHistoricalClient", msg.c_str());
+                logger().logWarn(CLASS, "getHistoricalClient", "Unable to connect to market data client - Attempt=%: %",
+                               attempts, e.what());
             }
         }
     }
@@ -97,23 +114,21 @@ namespace BeaconTech::MarketData
             }
             catch (const databento::HttpResponseError& e)
             {
-                std::string msg = "Unable to connect to market data client - Attempt="
-                        + std::to_string(attempts) + ": " + e.what();
-                LOGGER.logWarn(CLASS, "getLiveClient", msg.c_str());
+                logger().logWarn(CLASS, "getLiveClient", "Unable to connect to market data client - Attempt=%: %",
+                               attempts, e.what());
                 if (attempts == 10)
                 {
-                    LOGGER.logSevere(CLASS, "getLiveClient", "Exceeded max attempts connecting to market data provider");
+                    logger().logSevere(CLASS, "getLiveClient", "Exceeded max attempts connecting to market data provider");
                     throw e;
                 }
             }
             catch (const std::exception& e)
             {
-                std::string msg = "Unable to connect to market data client - Attempt="
-                        + std::to_string(attempts) + ": " + e.what();
-                LOGGER.logWarn(CLASS, "getLiveClient", msg.c_str());
+                logger().logWarn(CLASS, "getLiveClient", "Unable to connect to market data client - Attempt=%: %",
+                               attempts, e.what());
                 if (attempts == 10)
                 {
-                    LOGGER.logSevere(CLASS, "getLiveClient", "Exceeded max attempts connecting to market data provider");
+                    logger().logSevere(CLASS, "getLiveClient", "Exceeded max attempts connecting to market data provider");
                     throw e;
                 }
             }
@@ -125,9 +140,8 @@ namespace BeaconTech::MarketData
             }
             catch (const std::exception& e)
             {
-                std::string msg = "Unable to connect to market data client - Attempt="
-                        + std::to_string(attempts) + e.what();
-                LOGGER.logWarn(CLASS, "getLiveClient", msg.c_str());
+                logger().logWarn(CLASS, "getLiveClient", "Unable to connect to market data client - Attempt=%: %",
+                               attempts, e.what());
             }
         }
     }
@@ -135,37 +149,30 @@ namespace BeaconTech::MarketData
     // Helper function used to determine which mode to run in
     std::string MarketDataUtils::getEnvironmentType()
     {
-        return Common::ConfigManager::stringConfigValueDefaultIfNull("environmentType", "Dev");
+        return Common::ConfigManager::config().environmentType;
     }
 
     // Used to partition the system into multiple symbol ranged engines (aka threads)
     unsigned int MarketDataUtils::getNumThreads()
     {
-        return Common::ConfigManager::intConfigValueDefaultIfNull("numThreads", 1);
+        return Common::ConfigManager::config().numThreads;
     }
 
-    // Prints best bid and ask for each book after processing the last message in the packet
+    // Prints a sample of the best bid and ask for each book after processing the last message in the packet.
+    // Each instrument is limited to printBboPerSecond lines, and every BBO_THROUGHPUT_INTERVAL BBOs the
+    // engine logs how long they took. The samplers are thread local, so the engines share no counters
     void MarketDataUtils::printBbo(const Common::Bbo& bbo, const double& fairMarketPrice)
     {
-        if (!Common::ConfigManager::boolConfigValueDefaultIfNull("printBbo", false)) return;
-
-        ++counter;
-        if (counter % 1'000'000 == 0)
-        {
-            clock.stop();
-            LOGGER.logInfo(CLASS, "printBbo", "Microseconds=% startTime=% stopTime=%",
-                           clock.elapsedTime(), clock.getStartTime().time_since_epoch().count(),
-                           clock.getStopTime().time_since_epoch().count());
-            clock.start();
-        }
-
-        std::uint32_t instrumentId;
-        MarketData::PriceLevel bestBid{};
-        MarketData::PriceLevel bestAsk{};
+        static const Common::ConfigSnapshot& config = Common::ConfigManager::config();
+        if (!config.printBbo) return;
 
-        std::tie(instrumentId, bestBid, bestAsk) = bbo;
+        thread_local auto windowStart = std::chrono::steady_clock::now();
+        LOG_EVERY_N(logger(), INFO, BBO_THROUGHPUT_INTERVAL, CLASS, "printBbo", "Bbos=% Microseconds=%",
+                    BBO_THROUGHPUT_INTERVAL, restartWindow(windowStart));
 
-        LOGGER.logInfo(CLASS, "printBbo", "InstrumentId=% bestBid=$% x % bestAsk=$% x % fairPrice=$%",
-                       instrumentId, bestBid.price, bestBid.size, bestAsk.price, bestAsk.size, fairMarketPrice);
+        const auto& [instrumentId, bestBid, bestAsk] = bbo;
+        LOG_RATE_LIMITED(logger(), INFO, config.printBboPerSecond, instrumentId, CLASS, "printBbo",
+                         "InstrumentId=% bestBid=$% x % bestAsk=$% x % fairPrice=$%",
+                         instrumentId, bestBid.price, bestBid.size, bestAsk.price, bestAsk.size, fairMarketPrice);
     }
 } // namespace BeaconTech::marketdata
\ No newline at end of file
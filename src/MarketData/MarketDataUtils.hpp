@@ -9,6 +9,7 @@
 
 #define CLASS_FILE_PATH (std::filesystem::path(__FILE__).parent_path().string())
 
+#include <cstdint>
 #include <string>
 #include <utility>
 
@@ -21,6 +22,8 @@
 #include "OrderBook.hpp"
 #include "../MessageObjects/marketdata/PriceLevel.hpp"
 #include "../CommonServer/logging/Logger.hpp"
+#include "../CommonServer/logging/LogSampler.hpp"
+#include "../CommonServer/utils/Clock.hpp"
 
 namespace BeaconTech::MarketData
 {
@@ -31,9 +34,11 @@ namespace BeaconTech::MarketData
         inline static const std::string CLASS_PATH = CLASS_FILE_PATH;
         inline static const std::string APP_NAME = "MARKETDATA";
         inline static const std::string CLASS = "MARKETDATAUTILS";
-        inline static BeaconTech::Common::Logger LOGGER{CLASS_PATH, APP_NAME, 0};
-        inline static BeaconTech::Common::Clock clock{};
-        inline static int counter = 0;
+
+        // Each engine logs its BBO throughput every BBO_THROUGHPUT_INTERVAL BBOs
+        static constexpr std::uint64_t BBO_THROUGHPUT_INTERVAL = 1'000'000;
+
+        static const BeaconTech::Common::Logger& logger();
 
     public:
         MarketDataUtils();
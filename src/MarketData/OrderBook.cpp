@@ -21,6 +21,7 @@
 #include "../MessageObjects/marketdata/Side.hpp"
 #include "../MessageObjects/marketdata/OrderBookAction.hpp"
 #include "../MessageObjects/marketdata/Quote.hpp"
+#include "../CommonServer/telemetry/TraceRecorder.hpp"
 
 namespace BeaconTech::MarketData
 {
@@ -39,6 +40,7 @@ namespace BeaconTech::MarketData
 
     const Quote* OrderBook::apply(const databento::MboMsg& mboMsg)
     {
+        Common::TraceSpan span{"OrderBook::apply"};
         auto action = mboMsg.action;
 
         // Trade or Fill -> No change to book because all fills are
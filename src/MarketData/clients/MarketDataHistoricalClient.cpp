@@ -22,6 +22,7 @@
 #include "../processors/MarketDataProcessor.hpp"
 #include "../../CommonServer/utils/ConfigManager.hpp"
 #include "../../CommonServer/logging/Logger.hpp"
+#include "../../CommonServer/telemetry/TraceRecorder.hpp"
 
 namespace BeaconTech::MarketData
 {
@@ -44,10 +45,10 @@ namespace BeaconTech::MarketData
 
     // Allows system components to subscribe to book updates via a callback
     void MarketDataHistoricalClient::subscribe(MarketDataHistoricalClient& marketDataClient,
-                                               const Common::MdCallback& callback)
+                                               const Common::MdCallback& callback,
+                                               const Common::MdIdleCallback& idleCallback)
     {
-
-        streamingClient.initialize(marketDataClient, callback);
+        streamingClient.initialize(marketDataClient, callback, idleCallback);
     }
 
     // Batch download historical data files for back-testing. Note - This can be converted into a
@@ -57,8 +58,8 @@ namespace BeaconTech::MarketData
     {
         // Batch download historical data files for back-testing
         return _client.BatchDownload(
-                Common::ConfigManager::stringConfigValueDefaultIfNull("marketData", "../src/marketdata/historicaldata"),
-                Common::ConfigManager::stringConfigValueDefaultIfNull("fileToDownload", ""));
+                Common::ConfigManager::config().marketData,
+                Common::ConfigManager::config().fileToDownload);
     }
 
     // Read from a file previously downloaded to avoid for testing. Will eventually need to migrate over to
@@ -66,7 +67,7 @@ namespace BeaconTech::MarketData
     // when back-testing instead of running batch downloads for each back-test.
     std::vector<std::string> MarketDataHistoricalClient::readFromFile()
     {
-        return {Common::ConfigManager::stringConfigValueDefaultIfNull("flatHistoricalDataFile", "")};
+        return {Common::ConfigManager::config().flatHistoricalDataFile};
     }
 
     // Used by the MarketDataConsumer to consume bookUpdates published by the market data provider (pub-sub model)
@@ -89,18 +90,22 @@ namespace BeaconTech::MarketData
                             return streamingProcessor.processBookUpdate(record);
                         };
 
+                        // Always traced, so every replay shows up in the timeline whatever the sampling
+                        Common::TraceSpan span{"MarketDataHistoricalClient::replay", false};
                         databento::DbnFileStore dbn_store{bookUpdate};
                         dbn_store.Replay(callback);
                     }
+
+                    streamingProcessor.onIdle();
                 }
             }
             catch (const databento::HttpResponseError& e)
             {
-                logger.logSevere(CLASS, "getBookUpdate", e.what());
+                logger.logSevere(CLASS, "getBookUpdate", "%", e.what());
             }
             catch (const std::exception& e)
             {
-                logger.logSevere(clientName, "getBookUpdate", e.what());
+                logger.logSevere(clientName, "getBookUpdate", "%", e.what());
             }
         };
     }
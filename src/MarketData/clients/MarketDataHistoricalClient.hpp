@@ -51,11 +51,15 @@ namespace BeaconTech::MarketData
         static std::vector<std::string> readFromFile();
 
     public:
+        // Replays records received long ago, so their receive timestamps are not comparable to the local clock
+        static constexpr bool REPLAY = true;
+
         MarketDataHistoricalClient(std::string clientName, const BeaconTech::Common::Logger& logger);
 
         ~MarketDataHistoricalClient() override = default;
 
-        void subscribe(MarketDataHistoricalClient& marketDataClient, const Common::MdCallback& callback);
+        void subscribe(MarketDataHistoricalClient& marketDataClient, const Common::MdCallback& callback,
+                       const Common::MdIdleCallback& idleCallback = {});
 
         std::function<void ()> getBookUpdate(MarketDataProcessor& streamingProcessor) override;
 
@@ -37,9 +37,10 @@ namespace BeaconTech::MarketData
     }
 
     // Allows system components to subscribe to book updates via a callback
-    void MarketDataLiveClient::subscribe(MarketDataLiveClient& marketDataClient, const Common::MdCallback& callback)
+    void MarketDataLiveClient::subscribe(MarketDataLiveClient& marketDataClient, const Common::MdCallback& callback,
+                                         const Common::MdIdleCallback& idleCallback)
     {
-        streamingClient.initialize(marketDataClient, callback);
+        streamingClient.initialize(marketDataClient, callback, idleCallback);
     }
 
     // Used by the MarketDataConsumer to consume bookUpdates published by the market data provider (pub-sub model)
@@ -66,15 +67,16 @@ namespace BeaconTech::MarketData
                 else
                 {
                     logger.logWarn(CLASS, "getBookUpdate", "Timed out waiting for record");
+                    streamingProcessor.onIdle();
                 }
             }
             catch (const databento::HttpResponseError& e)
             {
-                logger.logSevere(CLASS, "getBookUpdate", e.what());
+                logger.logSevere(CLASS, "getBookUpdate", "%", e.what());
             }
             catch (const std::exception& e)
             {
-                logger.logSevere(CLASS, "getBookUpdate", e.what());
+                logger.logSevere(CLASS, "getBookUpdate", "%", e.what());
             }
         };
     }
@@ -40,12 +40,14 @@ namespace BeaconTech::MarketData
         MarketDataStreamingClient<MarketDataLiveClient> streamingClient;
 
     public:
+        static constexpr bool REPLAY = false;
 
         explicit MarketDataLiveClient(std::string clientName, const BeaconTech::Common::Logger& logger);
 
         ~MarketDataLiveClient() override = default;
 
-        void subscribe(MarketDataLiveClient& marketDataClient, const Common::MdCallback& callback);
+        void subscribe(MarketDataLiveClient& marketDataClient, const Common::MdCallback& callback,
+                       const Common::MdIdleCallback& idleCallback = {});
 
         std::function<void ()> getBookUpdate(MarketDataProcessor& streamingProcessor) override;
 
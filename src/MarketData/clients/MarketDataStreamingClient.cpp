@@ -16,7 +16,7 @@ namespace BeaconTech::MarketData
     // Overloaded ctor that initializes the streaming client and downstream components
     template<typename T>
     MarketDataStreamingClient<T>::MarketDataStreamingClient()
-        : streamingProcessor{}, streamingConsumer{streamingProcessor}
+        : streamingProcessor{T::REPLAY}, streamingConsumer{streamingProcessor}
     {
 
     }
@@ -37,9 +37,10 @@ namespace BeaconTech::MarketData
     // Initialize the processor and consumer. The processor must be initialized before the consumer to avoid
     // missing any book updates that our app consumes from the publisher before the processor is able to handle it
     template<typename T>
-    void MarketDataStreamingClient<T>::initialize(T& marketDataClient, const Common::MdCallback& callback)
+    void MarketDataStreamingClient<T>::initialize(T& marketDataClient, const Common::MdCallback& callback,
+                                                  const Common::MdIdleCallback& idleCallback)
     {
-        streamingProcessor.initialize(callback);
+        streamingProcessor.initialize(callback, idleCallback);
         streamingConsumer.start(marketDataClient);
     }
 } // namespace BeaconTech::marketdata
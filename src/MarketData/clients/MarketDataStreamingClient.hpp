@@ -33,7 +33,8 @@ namespace BeaconTech::MarketData
 
         MarketDataProcessor& createStreamingProcessor();
 
-        void initialize(T& marketDataClient, const Common::MdCallback& callback);
+        void initialize(T& marketDataClient, const Common::MdCallback& callback,
+                        const Common::MdIdleCallback& idleCallback = {});
 
         // Deleted default ctors and assignment operators
         MarketDataStreamingClient(const MarketDataStreamingClient<T>& other) = delete;
@@ -7,10 +7,11 @@
 #ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_MARKETDATACONSUMER_CPP
 #define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_MARKETDATACONSUMER_CPP
 
-#include <future>
+#include <thread>
 
 #include "MarketDataConsumer.hpp"
 #include "../processors/MarketDataProcessor.hpp"
+#include "../../CommonServer/concurrency/ThreadFactory.hpp"
 
 namespace BeaconTech::MarketData
 {
@@ -31,10 +32,11 @@ namespace BeaconTech::MarketData
     {
 //        this->marketDataClient = marketDataClient_;
 
-        // Note - The destructor of the std::future will block at the end of the full expression
-        // until the asynchronous operation completes. As a result, we use a lvalue expression
-        // whose lifetime is bound to the variable
-        auto future = std::async(std::launch::async, marketDataClient_.getBookUpdate(streamingProcessor));
+        // The consumer runs on a dedicated md-consumer thread so that its topology (name, cores, priority)
+        // can be configured. Note - Start blocks until the consumer completes, which preserves the
+        // lifetime guarantees downstream components rely on (the engines outlive every book update)
+        std::thread consumerThread = Common::ThreadFactory::createThread(ROLE, marketDataClient_.getBookUpdate(streamingProcessor));
+        if (consumerThread.joinable()) consumerThread.join();
     }
 
     // Disconnects the session gateway
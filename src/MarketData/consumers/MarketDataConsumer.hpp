@@ -7,6 +7,8 @@
 #ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_MARKETDATACONSUMER_HPP
 #define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_MARKETDATACONSUMER_HPP
 
+#include <string>
+
 #include "../processors/MarketDataProcessor.hpp"
 #include "../MarketDataUtils.hpp"
 
@@ -16,6 +18,8 @@ namespace BeaconTech::MarketData
     class MarketDataConsumer
     {
     private:
+        inline static const std::string ROLE = "md-consumer";
+
         T* marketDataClient;
         MarketDataProcessor& streamingProcessor;
         bool stopSignal;
@@ -12,18 +12,29 @@
 #include "MarketDataProcessor.hpp"
 #include "../../MarketData/MarketDataUtils.hpp"
 #include "../../MessageObjects/marketdata/Quote.hpp"
+#include "../../CommonServer/telemetry/TraceRecorder.hpp"
+#include "../../CommonServer/utils/Clock.hpp"
 
 namespace BeaconTech::MarketData
 {
 
-    MarketDataProcessor::MarketDataProcessor() : orderBook{}
+    MarketDataProcessor::MarketDataProcessor(bool replay)
+        : orderBook{}, replay{replay}, messages{Common::MetricsRegistry::getInstance().counter("md.messages")},
+          bookUpdates{Common::MetricsRegistry::getInstance().counter("md.bookUpdates")}
     {
 
     }
 
-    void MarketDataProcessor::initialize(const Common::MdCallback& _callback)
+    void MarketDataProcessor::initialize(const Common::MdCallback& _callback, const Common::MdIdleCallback& _idleCallback)
     {
         this->callback = _callback;
+        this->idleCallback = _idleCallback;
+    }
+
+    // Called by the clients when no book update is pending so that subscribers can finish deferred work
+    void MarketDataProcessor::onIdle()
+    {
+        if (idleCallback) idleCallback();
     }
 
     // Handles incoming market by order messages and updates the order book.
@@ -32,6 +43,9 @@ namespace BeaconTech::MarketData
     requires Common::Mbbo<T>
     void MarketDataProcessor::handle(const T& mbbo)
     {
+        // Only read for traced replays. The clock is read before the book is touched, as ts_recv would have been
+        const std::uint64_t readTicks = Common::LATENCY_TRACING && replay ? Common::Clock::readTsc() : 0;
+
         // Apply the quote to the order book
         const MarketData::Quote* quote = orderBook.apply(mbbo);
 
@@ -42,13 +56,23 @@ namespace BeaconTech::MarketData
 
         if (quote == nullptr) [[unlikely]] return;
 
+        Common::StageStamps stamps{};
+        if constexpr (Common::LATENCY_TRACING)
+        {
+            stamps.stampReceived(replay ? Common::Clock::tscToEpochNanos(readTicks)
+                                        : mbbo.ts_recv.time_since_epoch().count());
+        }
+        stamps.stamp(Common::PipelineStage::BOOK_APPLIED);
+
         std::uint32_t instrumentId = mbbo.hd.instrument_id;
         const Common::Bbo* bbo = orderBook.getBbo(instrumentId);
 
         // Only send downstream when bbo is valid
         if (bbo == nullptr) [[unlikely]] return;
 
-        callback(instrumentId, *quote, *bbo);
+        stamps.stamp(Common::PipelineStage::BBO_BUILT);
+        bookUpdates.add();
+        callback(instrumentId, *quote, *bbo, stamps);
     }
 
     // The system is currently focused on market making strategies. As a result, the system is only processing
@@ -66,6 +90,8 @@ namespace BeaconTech::MarketData
     // a templated handler that performs compile-time validation via concepts
     databento::KeepGoing MarketDataProcessor::processBookUpdate(const databento::Record& record)
     {
+        Common::TraceSpan span{"MarketDataProcessor::processBookUpdate"};
+        messages.add();
         auto mbo = record.Get<databento::MboMsg>();
         handle<databento::MboMsg>(mbo);
 
@@ -12,6 +12,7 @@
 
 #include "../OrderBook.hpp"
 #include "../../CommonServer/concepts/BTConcepts.hpp"
+#include "../../CommonServer/telemetry/MetricsRegistry.hpp"
 
 namespace BeaconTech::MarketData
 {
@@ -20,13 +21,24 @@ namespace BeaconTech::MarketData
     private:
         MarketData::OrderBook orderBook;
         Common::MdCallback callback;
+        Common::MdIdleCallback idleCallback;
+
+        // Replayed records carry receive timestamps from the original session, so RECEIVED is stamped with
+        // the local clock when the record is read instead
+        bool replay;
+
+        // Published as md.messages and md.bookUpdates. Written by the market data thread only
+        Common::Counter& messages;
+        Common::Counter& bookUpdates;
 
     public:
-        MarketDataProcessor();
+        explicit MarketDataProcessor(bool replay);
 
         virtual ~MarketDataProcessor() = default;
 
-        void initialize(const Common::MdCallback& callback);
+        void initialize(const Common::MdCallback& callback, const Common::MdIdleCallback& idleCallback = {});
+
+        void onIdle();
 
         // OrderBook Updates
         template<typename T>
@@ -40,6 +52,8 @@ namespace BeaconTech::MarketData
         databento::KeepGoing processBookUpdate(const databento::Record& record);
 
         // Deleted default ctors and assignment operators
+        MarketDataProcessor() = delete;
+
         MarketDataProcessor(const MarketDataProcessor& other) = delete;
 
         MarketDataProcessor(MarketDataProcessor&& other) = delete;
@@ -0,0 +1,38 @@
+//
+// The response of the risk manager to an OrderRequest for a single order. Reports cross the process
+// boundary through a SharedMemoryRing, so the struct is packed, trivially copyable and only holds
+// fixed width fields. Codes are sent by id (see ExecType.hpp, OrderStatus.hpp and Side.hpp).
+//
+// Created by Michael Lewis on 1/13/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_EXECUTIONREPORT_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_EXECUTIONREPORT_HPP
+
+#include <cstdint>
+#include <type_traits>
+
+namespace BeaconTech::Strategies
+{
+
+#pragma pack(push, 1)
+    struct ExecutionReport
+    {
+        std::uint64_t requestId;      // Request the order was created for
+        std::int64_t clOrdId;
+        std::int64_t sendNanos;       // CLOCK_MONOTONIC time the report was published
+        std::uint32_t strategyId;
+        std::uint32_t instrumentId;
+        double price;
+        std::uint32_t qty;
+        std::int8_t sideId;
+        std::int8_t execTypeId;
+        std::int8_t orderStatusId;
+    };
+#pragma pack(pop)
+
+    static_assert(std::is_trivially_copyable_v<ExecutionReport>);
+
+} // namespace BeaconTech::Strategies
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_EXECUTIONREPORT_HPP
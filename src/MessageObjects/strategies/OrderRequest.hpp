@@ -0,0 +1,35 @@
+//
+// A request from a strategy to the risk manager to quote both sides of an instrument. Requests cross
+// the process boundary through a SharedMemoryRing, so the struct is packed, trivially copyable and
+// only holds fixed width fields.
+//
+// Created by Michael Lewis on 1/13/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_ORDERREQUEST_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_ORDERREQUEST_HPP
+
+#include <cstdint>
+#include <type_traits>
+
+namespace BeaconTech::Strategies
+{
+
+#pragma pack(push, 1)
+    struct OrderRequest
+    {
+        std::uint64_t requestId;      // Unique per strategy engine
+        std::int64_t sendNanos;       // CLOCK_MONOTONIC time the request was published
+        std::uint32_t strategyId;     // Engine thread that sent the request
+        std::uint32_t instrumentId;
+        double bidPrice;
+        double askPrice;
+        std::uint32_t qty;
+    };
+#pragma pack(pop)
+
+    static_assert(std::is_trivially_copyable_v<OrderRequest>);
+
+} // namespace BeaconTech::Strategies
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_ORDERREQUEST_HPP
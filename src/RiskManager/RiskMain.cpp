@@ -2,13 +2,21 @@
 // Created by Michael Lewis on 11/6/24.
 //
 
-#include <iostream>
+#include <csignal>
 
+#include "../CommonServer/utils/ConfigManager.hpp"
 #include "RiskServer.hpp"
 
 int main()
 {
-    std::cout << "TEST" << std::endl;
+    BeaconTech::Common::ConfigManager::loadDefaultConfigs();
+    BeaconTech::RiskManager::RiskServer server{};
+
+    // Stop consuming order requests on Ctrl-C or kill
+    std::signal(SIGINT, [](int) { BeaconTech::RiskManager::RiskServer::stop(); });
+    std::signal(SIGTERM, [](int) { BeaconTech::RiskManager::RiskServer::stop(); });
+
+    server.run();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -1,5 +1,98 @@
 //
+// The main entry point for the risk manager process. The server consumes order requests that the
+// strategies publish over shared memory, creates orders through the OrderManager and publishes an
+// execution report for each order back to the strategies.
+//
 // Created by Michael Lewis on 11/6/24.
 //
 
+#include <exception>
+
 #include "RiskServer.hpp"
+#include "../CommonServer/concurrency/ThreadFactory.hpp"
+#include "../CommonServer/ipc/IpcChannels.hpp"
+#include "../CommonServer/logging/LogSampler.hpp"
+
+namespace BeaconTech::RiskManager
+{
+    RiskServer::RiskServer()
+        : logger{CLASS_PATH, APP_NAME, 0}, clock{std::make_shared<Common::Clock>()}, orderManager{logger, clock},
+          orderRequests{Common::IpcChannels::orderRequestRing(), Common::IpcChannels::ringSize()},
+          executionReports{Common::IpcChannels::executionReportRing(), Common::IpcChannels::ringSize()},
+          idleStrategy{ROLE},
+          droppedExecutionReports{Common::MetricsRegistry::getInstance().counter("risk.droppedExecutionReports")}
+    {
+        logger.logInfo(CLASS, "CTOR", "Creating RiskServer");
+    }
+
+    RiskServer::~RiskServer()
+    {
+        logger.logInfo(CLASS, "DTOR", "Destroying RiskServer");
+    }
+
+    // Consumes order requests on the calling thread until stop is called. Requests published while the
+    // risk manager was down are still in the ring and are processed first
+    void RiskServer::run()
+    {
+        Common::ThreadFactory::applyTopology(Common::ThreadTopology::fromConfig(ROLE));
+        logger.logInfo(CLASS, "run", "Consuming order requests from % (% pending)",
+                       orderRequests.getName(), orderRequests.size());
+
+        const auto hasWork = [this]() { return orderRequests.size() > 0 || !running; };
+        Strategies::OrderRequest request{};
+
+        while (running)
+        {
+            if (!orderRequests.tryConsume(request))
+            {
+                idleStrategy.idle(hasWork);
+                continue;
+            }
+
+            idleStrategy.reset();
+
+            try
+            {
+                onOrderRequest(request);
+            }
+            catch (const std::exception& e)
+            {
+                logger.logSevere(CLASS, "run", "%", e.what());
+            }
+        }
+    }
+
+    // Safe to call from a signal handler
+    void RiskServer::stop() noexcept
+    {
+        running = false;
+    }
+
+    void RiskServer::onOrderRequest(const Strategies::OrderRequest& request)
+    {
+        const auto [buyOrder, sellOrder] = orderManager.onOrderRequest(request.instrumentId, request.bidPrice,
+                                                                      request.askPrice, request.qty);
+
+        publishExecutionReport(request, buyOrder);
+        publishExecutionReport(request, sellOrder);
+    }
+
+    // Reports are dropped rather than blocking the risk manager when the strategies stop consuming. The
+    // drops are counted in risk.droppedExecutionReports and only logged once a second
+    void RiskServer::publishExecutionReport(const Strategies::OrderRequest& request, const Strategies::Order& order)
+    {
+        const Strategies::ExecutionReport report{request.requestId, order.clOrdId, Common::IpcChannels::now(),
+                                                 request.strategyId, order.instrumentId, order.price, order.qty,
+                                                 static_cast<std::int8_t>(static_cast<int32_t>(order.side)),
+                                                 static_cast<std::int8_t>(static_cast<int32_t>(order.execType)),
+                                                 static_cast<std::int8_t>(static_cast<int32_t>(order.orderStatus))};
+
+        if (!executionReports.tryPublish(report)) [[unlikely]]
+        {
+            droppedExecutionReports.add();
+            LOG_RATE_LIMITED(logger, WARN, 1, 0, CLASS, "publishExecutionReport",
+                             "Dropped execution report for requestId=%, % is full (% dropped so far)",
+                             request.requestId, executionReports.getName(), droppedExecutionReports.get());
+        }
+    }
+} // namespace BeaconTech::RiskManager
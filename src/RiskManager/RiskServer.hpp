@@ -1,15 +1,76 @@
 //
+// The main entry point for the risk manager process. The server consumes order requests that the
+// strategies publish over shared memory, creates orders through the OrderManager and publishes an
+// execution report for each order back to the strategies.
+//
 // Created by Michael Lewis on 11/6/24.
 //
 
 #ifndef BEACONTECH_RISKSERVER_HPP
 #define BEACONTECH_RISKSERVER_HPP
 
+#define CLASS_FILE_PATH (std::filesystem::path(__FILE__).parent_path().string())
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <string>
 
-class RiskServer
+#include "managers/OrderManager.hpp"
+#include "../CommonServer/concurrency/IdleStrategy.hpp"
+#include "../CommonServer/ipc/SharedMemoryRing.hpp"
+#include "../CommonServer/logging/Logger.hpp"
+#include "../CommonServer/telemetry/MetricsRegistry.hpp"
+#include "../CommonServer/utils/Clock.hpp"
+#include "../MessageObjects/strategies/ExecutionReport.hpp"
+#include "../MessageObjects/strategies/Order.hpp"
+#include "../MessageObjects/strategies/OrderRequest.hpp"
+
+namespace BeaconTech::RiskManager
 {
 
-};
+    class RiskServer
+    {
+    private:
+        inline static const std::string CLASS_PATH = CLASS_FILE_PATH;
+        inline static const std::string APP_NAME = "RISK";
+        inline static const std::string CLASS = "RiskServer";
+        inline static const std::string ROLE = "risk-server";
+
+        inline static std::atomic<bool> running{true};
+
+        BeaconTech::Common::Logger logger;
+        std::shared_ptr<Common::Clock> clock;
+        OrderManager orderManager;
+
+        Common::SharedMemoryRing<Strategies::OrderRequest> orderRequests;
+        Common::SharedMemoryRing<Strategies::ExecutionReport> executionReports;
+        Common::ConfiguredIdleStrategy idleStrategy;
+        Common::Counter& droppedExecutionReports;   // risk.droppedExecutionReports
+
+        void onOrderRequest(const Strategies::OrderRequest& request);
+
+        void publishExecutionReport(const Strategies::OrderRequest& request, const Strategies::Order& order);
+
+    public:
+        RiskServer();
+
+        virtual ~RiskServer();
+
+        void run();
+
+        static void stop() noexcept;
+
+        // Deleted default ctors and assignment operators
+        RiskServer(const RiskServer& other) = delete;
+
+        RiskServer(RiskServer&& other) = delete;
+
+        RiskServer& operator=(const RiskServer& other) = delete;
+
+        RiskServer& operator=(RiskServer&& other) = delete;
+    };
 
+} // namespace BeaconTech::RiskManager
 
 #endif //BEACONTECH_RISKSERVER_HPP
@@ -13,7 +13,7 @@
 namespace BeaconTech::RiskManager
 {
     OrderManager::OrderManager(const BeaconTech::Common::Logger& logger, const std::shared_ptr<Common::Clock>& clock)
-        : logger{logger}, clock{clock}, openOrders{new std::unordered_map<uint32_t, Strategies::Order>()}
+        : logger{logger}, clock{clock}, openOrders{}
     {
         logger.logInfo(CLASS, "CTOR", "Creating OrderManager");
     }
@@ -24,22 +24,27 @@ namespace BeaconTech::RiskManager
     }
 
     // Creates buy and sell orders for the MarketMaker, uses the RiskManager for pre-trade risk checks,
-    // and sends the orders into the market
-    void OrderManager::onOrderRequest(const uint32_t& instrumentId, double bidPrice, double askPrice, uint32_t qty)
+    // and sends the orders into the market. Returns the buy and sell orders
+    std::pair<Strategies::Order, Strategies::Order> OrderManager::onOrderRequest(const uint32_t& instrumentId,
+                                                                               double bidPrice, double askPrice,
+                                                                               uint32_t qty)
     {
-        Strategies::Order buyOrder = OrderUtil::createOrder(instrumentId, clock, bidPrice, qty,
-                                                            MarketData::Side::BUY, ExecType::SUBMIT,
-                                                            OrderStatus::SUBMIT_PENDING);
+        Strategies::Order buyOrder = Strategies::OrderUtil::createOrder(instrumentId, clock, bidPrice, qty,
+                                                                        MarketData::Side::BUY,
+                                                                        Strategies::ExecType::SUBMIT,
+                                                                        Strategies::OrderStatus::SUBMIT_PENDING);
 
-        Strategies::Order sellOrder = OrderUtil::createOrder(instrumentId, clock, askPrice, qty,
-                                                             MarketData::Side::SELL, ExecType::SUBMIT,
-                                                             OrderStatus::SUBMIT_PENDING);
+        Strategies::Order sellOrder = Strategies::OrderUtil::createOrder(instrumentId, clock, askPrice, qty,
+                                                                         MarketData::Side::SELL,
+                                                                         Strategies::ExecType::SUBMIT,
+                                                                         Strategies::OrderStatus::SUBMIT_PENDING);
 
         // todo cancel/modify open orders if necessary, perform pre-trade risk checks in RiskManager
         //      need a SubmitHandler, ReplaceHandler, CancelHandler and will pass the order to the
-        //      respective handler
+        //      respective handler. Until then the new quote simply replaces the previous one
 
-        openOrders->emplace(buyOrder.clOrdId, buyOrder);
-        openOrders->emplace(sellOrder.clOrdId, sellOrder);
+        openOrders.insert_or_assign(instrumentId, std::make_pair(buyOrder, sellOrder));
+
+        return {buyOrder, sellOrder};
     }
 } // BeaconTech::RiskManager
\ No newline at end of file
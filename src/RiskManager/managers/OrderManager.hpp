@@ -9,6 +9,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <utility>
 
 #include "../../MessageObjects/strategies/Order.hpp"
 #include "../../CommonServer/utils/Clock.hpp"
@@ -25,15 +26,17 @@ namespace BeaconTech::RiskManager
         const BeaconTech::Common::Logger& logger;
         const std::shared_ptr<Common::Clock>& clock;
 
-        // Order properties
-        std::unordered_map<uint32_t, Strategies::Order>* openOrders; // instrumentId -> order
+        // Order properties. The MarketMaker keeps one quote per instrument, so each order request replaces
+        // the open buy and sell orders of its instrument and the map is bounded by the number of instruments
+        std::unordered_map<uint32_t, std::pair<Strategies::Order, Strategies::Order>> openOrders; // instrumentId -> (buy, sell)
 
     public:
         OrderManager(const BeaconTech::Common::Logger& logger, const std::shared_ptr<Common::Clock>& clock);
 
         virtual ~OrderManager();
 
-        void onOrderRequest(const uint32_t& instrumentId, double bidPrice, double askPrice, uint32_t qty);
+        std::pair<Strategies::Order, Strategies::Order> onOrderRequest(const uint32_t& instrumentId, double bidPrice,
+                                                                       double askPrice, uint32_t qty);
 
         // Deleted default ctors and assignment operators
         OrderManager(const OrderManager& other) = delete;
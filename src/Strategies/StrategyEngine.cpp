@@ -12,17 +12,26 @@
 #include "StrategyEngine.hpp"
 #include "StrategyServer.hpp"
 #include "algos/MarketMaker.hpp"
+#include "../CommonServer/ipc/IpcChannels.hpp"
+#include "../CommonServer/logging/LogSampler.hpp"
 
 namespace BeaconTech::Strategies
 {
     template<typename T>
-    StrategyEngine<T>::StrategyEngine(const StrategyServer<T>& server, uint32_t threadId)
+    StrategyEngine<T>::StrategyEngine(const StrategyServer<T>& server, uint32_t threadId,
+                                      Common::StageLatencyCollector& stageLatencyCollector)
         : server{server}, logger{CLASS_PATH, APP_NAME, threadId}, threadId{threadId},
-          clock{std::make_shared<Common::Clock>()}, featureEngine{logger}
+          clock{std::make_shared<Common::Clock>()}, stageLatencies{stageLatencyCollector}, config{},
+          featureEngine{logger, "features-engine-" + std::to_string(threadId), server.getInstrumentCapacity()},
+          orderRequests{Common::IpcChannels::orderRequestRing(), Common::IpcChannels::ringSize()}, nextRequestId{0},
+          sentOrderRequests{Common::MetricsRegistry::getInstance().counter(
+                  "strategy.orderRequests", "engine=" + std::to_string(threadId))},
+          droppedOrderRequests{Common::MetricsRegistry::getInstance().counter(
+                  "strategy.droppedOrderRequests", "engine=" + std::to_string(threadId))}
     {
         logger.logInfo(CLASS, "CTOR", "Creating StrategyEngine");
 
-        marketMaker = new MarketMaker<T>{logger, clock, *this, featureEngine};
+        marketMaker = new MarketMaker<T>{logger, clock, *this, featureEngine, config, server.getStrategyConfig()};
     }
 
     template<typename T>
@@ -32,12 +41,47 @@ namespace BeaconTech::Strategies
         delete this->marketMaker;
     }
 
-    // Informs the feature engine and strategy about quotes and book updates
+    // Picks up reloaded configs, informs the feature engine and strategy about quotes and book updates and
+    // records how long the update took to get through each stage of the pipeline
     template<typename T>
-    void StrategyEngine<T>::onOrderBookUpdate(const MarketData::Quote& quote, const Common::Bbo& bbo)
+    void StrategyEngine<T>::onOrderBookUpdate(std::uint32_t slot, const MarketData::Quote& quote,
+                                              const Common::Bbo& bbo, Common::StageStamps stamps)
     {
-        featureEngine.onOrderBookUpdate(quote, bbo);
-        onOrderBookUpdateAlgo(quote, bbo);
+        stamps.stamp(Common::PipelineStage::DEQUEUED);
+        if (config.refresh()) [[unlikely]]
+        {
+            logger.logInfo(CLASS, "onOrderBookUpdate", "Using configs version=% targetSpreadBps=% targetSize=%",
+                           config.get().version, config.get().targetSpreadBps, config.get().targetSize);
+        }
+
+        featureEngine.onOrderBookUpdate(slot, quote, bbo);
+        stamps.stamp(Common::PipelineStage::FEATURES_COMPUTED);
+        onOrderBookUpdateAlgo(slot, quote, bbo);
+        stamps.stamp(Common::PipelineStage::STRATEGY_DONE);
+
+        stageLatencies.record(stamps);
+    }
+
+    // Sends a two-sided order request to the risk manager over shared memory. The request is dropped
+    // (and false returned) when the risk manager has fallen a full ring behind, so the engine never blocks.
+    // The drops are counted in strategy.droppedOrderRequests and only logged once a second
+    template<typename T>
+    bool StrategyEngine<T>::sendOrderRequest(std::uint32_t instrumentId, double bidPrice, double askPrice, std::uint32_t qty)
+    {
+        const OrderRequest request{nextRequestId++, Common::IpcChannels::now(), threadId,
+                                   instrumentId, bidPrice, askPrice, qty};
+
+        if (orderRequests.tryPublish(request)) [[likely]]
+        {
+            sentOrderRequests.add();
+            return true;
+        }
+
+        droppedOrderRequests.add();
+        LOG_RATE_LIMITED(logger, WARN, 1, 0, CLASS, "sendOrderRequest",
+                         "Dropped order request for instrumentId=%, % is full (% dropped so far)",
+                         instrumentId, orderRequests.getName(), droppedOrderRequests.get());
+        return false;
     }
 
 } // namespace BeaconTech::Strategies
@@ -7,6 +7,7 @@
 #ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_STRATEGYENGINE_HPP
 #define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_STRATEGYENGINE_HPP
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -15,10 +16,15 @@
 #include "../MarketData/clients/MarketDataLiveClient.hpp"
 #include "../MarketData/OrderBook.hpp"
 #include "../MessageObjects/marketdata/Quote.hpp"
+#include "../MessageObjects/strategies/OrderRequest.hpp"
 #include "algos/MarketMaker.hpp"
 #include "algos/FeatureEngine.hpp"
 #include "../CommonServer/utils/Clock.hpp"
+#include "../CommonServer/utils/ConfigReloader.hpp"
 #include "../CommonServer/logging/Logger.hpp"
+#include "../CommonServer/ipc/SharedMemoryRing.hpp"
+#include "../CommonServer/telemetry/MetricsRegistry.hpp"
+#include "../CommonServer/telemetry/StageLatency.hpp"
 
 namespace BeaconTech::Strategies
 {
@@ -43,20 +49,32 @@ namespace BeaconTech::Strategies
         const BeaconTech::Common::Logger logger;
         uint32_t threadId;
         std::shared_ptr<Common::Clock> clock;
+        Common::StageLatencyRecorder stageLatencies;
+        Common::ConfigReader config;
 
         // Strategy properties
-        FeatureEngine featureEngine;
+        typename MarketMaker<T>::Features featureEngine;
         MarketMaker<T>* marketMaker;
 
+        // Order properties
+        Common::SharedMemoryRing<OrderRequest> orderRequests;
+        std::uint64_t nextRequestId;
+        Common::Counter& sentOrderRequests;      // strategy.orderRequests
+        Common::Counter& droppedOrderRequests;   // strategy.droppedOrderRequests
+
     public:
-        StrategyEngine(const StrategyServer<T>& server, const uint32_t threadId);
+        StrategyEngine(const StrategyServer<T>& server, const uint32_t threadId,
+                       Common::StageLatencyCollector& stageLatencyCollector);
 
         virtual ~StrategyEngine();
 
-        void onOrderBookUpdate(const MarketData::Quote& quote, const Common::Bbo& bbo);
+        void onOrderBookUpdate(std::uint32_t slot, const MarketData::Quote& quote, const Common::Bbo& bbo,
+                               Common::StageStamps stamps);
+
+        bool sendOrderRequest(std::uint32_t instrumentId, double bidPrice, double askPrice, std::uint32_t qty);
 
         // Callbacks that dispatch order book updates and downstream responses to the trading algorithm
-        std::function<void (const MarketData::Quote &quote, const Common::Bbo& bbo)> onOrderBookUpdateAlgo;
+        std::function<void (std::uint32_t slot, const MarketData::Quote &quote, const Common::Bbo& bbo)> onOrderBookUpdateAlgo;
 
         // Deleted default ctors and assignment operators
         StrategyEngine() = delete;
@@ -2,7 +2,10 @@
 // Created by Michael Lewis on 12/20/23.
 //
 
+#include "../CommonServer/logging/LoggerManager.hpp"
+#include "../CommonServer/telemetry/TraceRecorder.hpp"
 #include "../CommonServer/utils/ConfigManager.hpp"
+#include "../CommonServer/utils/ConfigReloader.hpp"
 #include "../MarketData/clients/MarketDataHistoricalClient.hpp"
 #include "StrategyServer.hpp"
 
@@ -11,7 +14,18 @@ int main()
     using Client = BeaconTech::MarketData::MarketDataHistoricalClient;
 
     BeaconTech::Common::ConfigManager::loadDefaultConfigs();
-    BeaconTech::Strategies::StrategyServer<Client> server{};
+    BeaconTech::Common::TraceRecorder::start();
+    BeaconTech::Common::ConfigReloader::start();
+
+    {
+        BeaconTech::Strategies::StrategyServer<Client> server{};
+    }
+
+    // The replay and engine threads have stopped once the server is destroyed. The log flush workers also
+    // record spans, so they are stopped before the trace rings are read
+    BeaconTech::Common::ConfigReloader::stop();
+    BeaconTech::Common::LoggerManager::getInstance().shutdown();
+    BeaconTech::Common::TraceRecorder::dump();
 
     return 0;
 }
\ No newline at end of file
@@ -1,7 +1,11 @@
 //
 // The main entry point for all downstream business logic. The server is responsible
 // for creating engines and facilitating the handoff between inbound data and the
-// deterministic message processing queue that feeds the engines
+// deterministic message processing queue that feeds the engines.
+//
+// Each engine thread owns a multicast ring. A book update is copied into the ring once and every
+// listener of that engine thread (the strategy engine first, then any additional non-trading listeners)
+// reads it in place.
 //
 // Created by Michael Lewis on 10/4/23.
 //
@@ -9,23 +13,38 @@
 #ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_STRATEGYSERVER_CPP
 #define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_STRATEGYSERVER_CPP
 
+#include <algorithm>
 #include <exception>
 #include <memory>
+#include <thread>
 
 #include "StrategyServer.hpp"
+#include "../CommonServer/concurrency/IdleStrategy.hpp"
+#include "../CommonServer/concurrency/ThreadFactory.hpp"
+#include "../CommonServer/ipc/IpcChannels.hpp"
+#include "../CommonServer/telemetry/MetricsRegistry.hpp"
 
 namespace BeaconTech::Strategies
 {
     template<typename T>
     StrategyServer<T>::StrategyServer()
         : logger{CLASS_PATH, APP_NAME, 0},
-          numEngineThreads{Common::ConfigManager::intConfigValueDefaultIfNull("numEngineThreads", 1)},
-          numListeners{Common::ConfigManager::intConfigValueDefaultIfNull("numListeners", 1)},
-          marketDataClient{APP_NAME, logger}
+          numEngineThreads{Common::ConfigManager::config().numEngineThreads},
+          numListeners{Common::ConfigManager::config().numListeners},
+          instruments{Common::ConfigManager::config().maxInstruments}, strategyConfig{instruments},
+          router{numEngineThreads, instruments},
+          stageLatencies{[this](const Common::StageLatencies& latencies, double windowSeconds) {
+              logStageLatencies(latencies, windowSeconds);
+          }},
+          marketDataClient{APP_NAME, logger},
+          executionReports{Common::IpcChannels::executionReportRing(), Common::IpcChannels::ringSize()},
+          consumeExecutionReports{true}
     {
         logger.logInfo(CLASS, "CTOR", "Creating StrategyServer");
 
+        executionReportThread = Common::ThreadFactory::createThread("exec-reports", &StrategyServer::executionReportLoop, this);
         createThreads();
+        logMemoryReport();
         subscribeToMarketData();
     }
 
@@ -35,75 +54,289 @@ namespace BeaconTech::Strategies
         logger.logInfo(CLASS, "DTOR", "Destroying StrategyServer");
 
         marketDataClient.stop();
-        for (const auto& queueProcessor : queueProcessors)
+        drainHandoffs();
+
+        consumeExecutionReports = false;
+        if (executionReportThread.joinable()) executionReportThread.join();
+        for (const auto& engineProcessor : engineProcessors)
         {
-            queueProcessor->stop();
-            delete queueProcessor;
+            engineProcessor->stop();
+            delete engineProcessor;
         }
 
+        // Engines hand their last window to the collector when they are destroyed
         for (const auto& strategyEngine : strategyEngines)
         {
             delete strategyEngine;
         }
+
+        for (const auto& bookLogger : bookLoggers)
+        {
+            delete bookLogger;
+        }
+
+        stageLatencies.report();
     }
 
-    // Creates the engines and listener. The number of threads is configurable to partition the
+    // Creates the engines and listeners. The number of threads is configurable to partition the
     // system by symbol ranges (improves latency and throughput). Each thread can be also
-    // configured to have multiple listeners. The typical use case is to have one engine thread
-    // to ensure sequencing of each engine. Any additional listener should only be used for logging.
+    // configured to have multiple listeners that all see every book update of the thread. The first
+    // listener of each thread is the only engine that trades, since every listener sees every update.
+    // Additional listeners log the book updates and are gated on the engine by default so they only
+    // see an update once the engine has processed it.
     template<typename T>
     void StrategyServer<T>::createThreads()
     {
+        const uint32_t listenersPerThread = std::max(numListeners / numEngineThreads, 1U);
+        const bool gateListeners = Common::ConfigManager::config().gateListenersOnEngine;
+
         for (uint32_t thread = 0; thread < numEngineThreads; ++thread)
         {
-            // When numListeners > numEngineThreads, the extra threads should be used for logging
-            for (uint32_t listenerId = 0; listenerId < (numListeners / numEngineThreads); ++listenerId)
+            // Each engine gets its own ring
+            auto engineProcessor = new EngineProcessor{"engine-" + std::to_string(thread),
+                    [this](const Common::QueueTelemetry& telemetry) { logQueueTelemetry(telemetry); }};
+
+            auto strategyEngine = new StrategyEngine<T>{*this, thread, stageLatencies};
+            strategyEngines.emplace_back(strategyEngine);
+
+            engineProcessor->addListener([strategyEngine](const BookEvent& event, std::int64_t) {
+                strategyEngine->onOrderBookUpdate(event.slot, event.quote, event.bbo, event.stamps);
+            });
+
+            for (uint32_t listenerId = 1; listenerId < listenersPerThread; ++listenerId)
             {
-                strategyEngines.emplace_back(new StrategyEngine<T>{*this, thread});
+                auto bookLogger = new BookLogger{thread};
+                bookLoggers.emplace_back(bookLogger);
+
+                std::vector<std::size_t> dependsOn;
+                if (gateListeners) dependsOn.push_back(0);
+
+                engineProcessor->addListener([bookLogger](const BookEvent& event, std::int64_t) {
+                    bookLogger->onBookEvent(event);
+                }, dependsOn);
             }
 
-            // Each engine gets its own CLFQ
-            queueProcessors.emplace_back(new CLFQProcessor{});
+            engineProcessor->start();
+            engineProcessors.emplace_back(engineProcessor);
         }
     }
 
-    // Calculates the positive modulo from the instrumentId and numEngineThreads.
-    // Returns the engine at the associated index
+    // Returns the engine that currently owns the instrument
     template<typename T>
     uint32_t StrategyServer<T>::getEngineThread(const uint32_t& instrumentId) const
     {
-        return ((instrumentId % numEngineThreads) + numEngineThreads) % numEngineThreads;
+        return router.getEngine(instrumentId);
+    }
+
+    // The per-instrument strategy parameters, indexed by the slot of each book update
+    template<typename T>
+    const StrategyConfigManager& StrategyServer<T>::getStrategyConfig() const noexcept
+    {
+        return strategyConfig;
     }
 
-    // Schedules entities for processing by enqueueing them into a concurrent queue
+    // The number of instrument slots, which sizes every per-instrument table of the engines
+    template<typename T>
+    uint32_t StrategyServer<T>::getInstrumentCapacity() const noexcept
+    {
+        return instruments.getCapacity();
+    }
+
+    // Schedules book updates for processing by publishing them into the ring of the engine that owns the instrument
     template<typename T>
     void StrategyServer<T>::scheduleJob(const uint32_t& instrumentId,
                                         const MarketData::Quote& quote,
-                                        const Common::Bbo& bbo)
+                                        const Common::Bbo& bbo,
+                                        const Common::StageStamps& stamps)
+    {
+        if (!handoffs.empty()) [[unlikely]] progressHandoffs();
+
+        const Route& route = router.route(instrumentId);
+        if (auto handoff = handoffs.find(instrumentId); handoff != handoffs.end()) [[unlikely]]
+        {
+            handoff->second.deferredEvents.emplace_back(instrumentId, route.slot, quote, bbo, stamps);
+        }
+        else
+        {
+            publish(route.engine, instrumentId, route.slot, quote, bbo, stamps);
+        }
+
+        // An instrument must not be moved again while a handoff is in progress, otherwise its deferred
+        // updates would be released behind updates sent to its new engine
+        if (router.rebalanceDue() && handoffs.empty()) [[unlikely]] rebalance();
+    }
+
+    // Copies the update into the next slot of the engine's ring. The quote and bbo must be copied because
+    // the order book overwrites them on the next update
+    template<typename T>
+    void StrategyServer<T>::publish(uint32_t engine, uint32_t instrumentId, uint32_t slot,
+                                    const MarketData::Quote& quote, const Common::Bbo& bbo,
+                                    const Common::StageStamps& stamps)
     {
-        queueProcessors.at(getEngineThread(instrumentId))->enqueue([&]() {
-            strategyEngines.at(getEngineThread(instrumentId))->onOrderBookUpdate(quote, bbo);
+        engineProcessors.at(engine)->publish([&](BookEvent& event) {
+            event.instrumentId = instrumentId;
+            event.slot = slot;
+            event.quote = quote;
+            event.bbo = bbo;
+            event.stamps = stamps;
+            event.stamps.stamp(Common::PipelineStage::PUBLISHED);
         });
     }
 
+    // Moves instruments to the engines planned by the router. Each move is a drain-and-handoff:
+    // 1) The last sequence published to the old engine is recorded
+    // 2) New updates for the instrument are deferred on the market data thread
+    // 3) Once every listener of the old engine has processed that sequence, the deferred updates are
+    //    released to the new engine
+    // Per-instrument ordering is preserved because the new engine never sees an update before
+    // the old engine has finished with its predecessors. The route only changes once the handoff exists.
+    template<typename T>
+    void StrategyServer<T>::rebalance()
+    {
+        for (const auto& reassignment : router.planRebalance())
+        {
+            const std::int64_t drainSequence = engineProcessors.at(reassignment.fromEngine)->getCursor();
+            const bool created = handoffs.emplace(reassignment.instrumentId,
+                    Handoff{reassignment.fromEngine, reassignment.toEngine, drainSequence, {}}).second;
+            if (!created) continue;
+
+            router.reassign(reassignment.instrumentId, reassignment.toEngine);
+
+            logger.logInfo(CLASS, "rebalance", "Moving instrumentId=% from engine-% to engine-%",
+                           reassignment.instrumentId, reassignment.fromEngine, reassignment.toEngine);
+        }
+    }
+
+    // Releases the deferred updates of every instrument whose old engine has drained
+    template<typename T>
+    void StrategyServer<T>::progressHandoffs()
+    {
+        for (auto it = handoffs.begin(); it != handoffs.end();)
+        {
+            const Handoff& handoff = it->second;
+            if (engineProcessors.at(handoff.fromEngine)->minimumSequence() < handoff.drainSequence)
+            {
+                ++it;
+                continue;
+            }
+
+            for (const auto& event : handoff.deferredEvents)
+            {
+                publish(handoff.toEngine, event.instrumentId, event.slot, event.quote, event.bbo, event.stamps);
+            }
+
+            it = handoffs.erase(it);
+        }
+    }
+
+    // Releases every deferred update once no more book updates will arrive (e.g. the replay has ended), so
+    // they reach the engines before the engines are stopped
+    template<typename T>
+    void StrategyServer<T>::drainHandoffs()
+    {
+        while (!handoffs.empty())
+        {
+            progressHandoffs();
+            if (!handoffs.empty()) std::this_thread::yield();
+        }
+    }
+
+    // Logs how long book updates waited in an engine queue before being processed and how deep the queue got.
+    // Runs on the engine thread at the end of each telemetry window
+    template<typename T>
+    void StrategyServer<T>::logQueueTelemetry(const Common::QueueTelemetry& telemetry) const
+    {
+        const auto& sojourn = telemetry.getSojourn();
+        logger.logInfo(CLASS, "logQueueTelemetry",
+                       "role=% jobs=% window=%s sojourn mean=%ns p50=%ns p99=%ns p99.9=%ns max=%ns maxDepth=%",
+                       telemetry.getRole(), sojourn.getCount(), telemetry.getWindowSeconds(), sojourn.getMean(),
+                       sojourn.percentile(50.0), sojourn.percentile(99.0), sojourn.percentile(99.9),
+                       sojourn.getMax(), telemetry.getMaxDepth());
+    }
+
+    // Logs the latency of each pipeline stage across every engine, from the gateway receiving the packet
+    // (tickToTrade covers all of the stages). Runs on whichever engine thread completes the window
+    template<typename T>
+    void StrategyServer<T>::logStageLatencies(const Common::StageLatencies& latencies, double windowSeconds) const
+    {
+        for (std::size_t interval = 0; interval < Common::StageLatencies::INTERVALS; ++interval)
+        {
+            const auto& histogram = latencies.getHistogram(interval);
+            logger.logInfo(CLASS, "logStageLatencies",
+                           "stage=% updates=% window=%s mean=%ns p50=%ns p99=%ns p99.9=%ns max=%ns",
+                           Common::StageLatencies::getIntervalName(interval), histogram.getCount(), windowSeconds,
+                           histogram.getMean(), histogram.percentile(50.0), histogram.percentile(99.0),
+                           histogram.percentile(99.9), histogram.getMax());
+        }
+    }
+
+    // Logs which of the rings and queues allocated so far are backed by huge pages and locked in memory
+    template<typename T>
+    void StrategyServer<T>::logMemoryReport() const
+    {
+        for (const auto& region : Common::MemoryProvider::report())
+        {
+            logger.logInfo(CLASS, "logMemoryReport", "name=% bytes=% mappedBytes=% pageType=% hugePageBytes=% locked=%",
+                           region.name, region.bytes, region.mappedBytes,
+                           Common::memoryPageTypeToString(region.pageType), region.hugePageBytes,
+                           region.locked ? "true" : "false");
+        }
+    }
+
+    // Consumes the execution reports the risk manager publishes in response to order requests. The time
+    // from publish to consume goes into the strategy.executionReportLatency histogram, and each report is
+    // only logged at DEBUG
+    template<typename T>
+    void StrategyServer<T>::executionReportLoop()
+    {
+        Common::ConfiguredIdleStrategy idleStrategy{"exec-reports"};
+        Common::LatencyHistogram& reportLatency =
+                Common::MetricsRegistry::getInstance().histogram("strategy.executionReportLatency");
+        const auto hasWork = [this]() { return executionReports.size() > 0 || !consumeExecutionReports; };
+        ExecutionReport report{};
+
+        while (consumeExecutionReports)
+        {
+            if (!executionReports.tryConsume(report))
+            {
+                idleStrategy.idle(hasWork);
+                continue;
+            }
+
+            idleStrategy.reset();
+            const std::int64_t latency = Common::IpcChannels::now() - report.sendNanos;
+            reportLatency.record(static_cast<std::uint64_t>(std::max<std::int64_t>(latency, 0)));
+            LOG_DEBUG(logger, CLASS, "executionReportLoop",
+                      "requestId=% strategyId=% clOrdId=% instrumentId=% price=% qty=% side=% execType=% orderStatus=% latency=%ns",
+                      report.requestId, report.strategyId, report.clOrdId, report.instrumentId, report.price,
+                      report.qty, static_cast<int>(report.sideId), static_cast<int>(report.execTypeId),
+                      static_cast<int>(report.orderStatusId), latency);
+        }
+    }
+
     // Creates a callback for the streaming processor to schedule book updates onto the engine
     template<typename T>
     void StrategyServer<T>::subscribeToMarketData()
     {
         callback = [&](const uint32_t& instrumentId,
                        const MarketData::Quote& quote,
-                       const Common::Bbo& bbo) -> void {
+                       const Common::Bbo& bbo,
+                       const Common::StageStamps& stamps) -> void {
             try
             {
-                scheduleJob(instrumentId, quote, bbo);
+                scheduleJob(instrumentId, quote, bbo, stamps);
             }
             catch (const std::exception& e)
             {
-                logger.logSevere(CLASS, "subscribeToMarketData", e.what());
+                logger.logSevere(CLASS, "subscribeToMarketData", "%", e.what());
             }
         };
 
-        marketDataClient.subscribe(marketDataClient, callback);
+        // Pending handoffs are also progressed while the feed is quiet, so deferred updates of a moved
+        // instrument do not wait for its next book update
+        marketDataClient.subscribe(marketDataClient, callback, [this]() {
+            if (!handoffs.empty()) progressHandoffs();
+        });
     }
 
 } // namespace BeaconTech::Strategies
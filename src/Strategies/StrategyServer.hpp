@@ -1,7 +1,11 @@
 //
 // The main entry point for all downstream business logic. The server is responsible
 // for creating engines and facilitating the handoff between inbound data and the
-// deterministic message processing queue that feeds the engines
+// deterministic message processing queue that feeds the engines.
+//
+// Each engine thread owns a multicast ring. A book update is copied into the ring once and every
+// listener of that engine thread (the strategy engine first, then any additional non-trading listeners)
+// reads it in place.
 //
 // Created by Michael Lewis on 10/4/23.
 //
@@ -11,11 +15,25 @@
 
 #define CLASS_FILE_PATH (std::filesystem::path(__FILE__).parent_path().string())
 
-#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include "StrategyEngine.hpp"
-#include "../CommonServer/handlers/CLFQProcessor.hpp"
+#include "listeners/BookLogger.hpp"
+#include "routing/BookEvent.hpp"
+#include "routing/InstrumentRouter.hpp"
+#include "../StrategyCommon/managers/InstrumentRegistry.hpp"
+#include "../StrategyCommon/managers/StrategyConfigManager.hpp"
+#include "../CommonServer/handlers/MulticastProcessor.hpp"
+#include "../CommonServer/ipc/SharedMemoryRing.hpp"
+#include "../CommonServer/memory/MemoryProvider.hpp"
+#include "../CommonServer/telemetry/StageLatency.hpp"
+#include "../MessageObjects/strategies/ExecutionReport.hpp"
 
 namespace BeaconTech::Strategies
 {
@@ -23,7 +41,17 @@ namespace BeaconTech::Strategies
     template<typename T>
     class StrategyEngine;
 
-    using CLFQProcessor = Common::CLFQProcessor<std::function<void ()>>;
+    using EngineProcessor = Common::MulticastProcessor<BookEvent>;
+
+    // An instrument that is moving between engines. Updates are deferred until every listener of the
+    // old engine has processed drainSequence, the last update published to it before the move
+    struct Handoff
+    {
+        std::uint32_t fromEngine;
+        std::uint32_t toEngine;
+        std::int64_t drainSequence;
+        std::vector<BookEvent> deferredEvents;
+    };
 
     template<typename T>
     class StrategyServer
@@ -37,10 +65,38 @@ namespace BeaconTech::Strategies
         uint32_t numEngineThreads;
         uint32_t numListeners;
         std::vector<StrategyEngine<T>*> strategyEngines;
-        std::vector<CLFQProcessor*> queueProcessors;
+        std::vector<BookLogger*> bookLoggers;
+        std::vector<EngineProcessor*> engineProcessors;
+        InstrumentRegistry instruments;
+        StrategyConfigManager strategyConfig;
+        InstrumentRouter router;
+        Common::StageLatencyCollector stageLatencies;
+        std::unordered_map<std::uint32_t, Handoff> handoffs; // instrumentId -> in progress handoff
         T marketDataClient;
         Common::MdCallback callback;
 
+        // Execution reports from the risk manager
+        Common::SharedMemoryRing<ExecutionReport> executionReports;
+        std::atomic<bool> consumeExecutionReports;
+        std::thread executionReportThread;
+
+        void publish(std::uint32_t engine, std::uint32_t instrumentId, std::uint32_t slot,
+                     const MarketData::Quote& quote, const Common::Bbo& bbo, const Common::StageStamps& stamps);
+
+        void rebalance();
+
+        void progressHandoffs();
+
+        void drainHandoffs();
+
+        void logQueueTelemetry(const Common::QueueTelemetry& telemetry) const;
+
+        void logStageLatencies(const Common::StageLatencies& latencies, double windowSeconds) const;
+
+        void logMemoryReport() const;
+
+        void executionReportLoop();
+
     public:
         StrategyServer();
 
@@ -50,9 +106,14 @@ namespace BeaconTech::Strategies
 
         uint32_t getEngineThread(const uint32_t& instrumentId) const;
 
+        const StrategyConfigManager& getStrategyConfig() const noexcept;
+
+        std::uint32_t getInstrumentCapacity() const noexcept;
+
         void subscribeToMarketData();
 
-        void scheduleJob(const std::uint32_t& instrumentId, const MarketData::Quote& quote, const Common::Bbo& bbo);
+        void scheduleJob(const std::uint32_t& instrumentId, const MarketData::Quote& quote, const Common::Bbo& bbo,
+                         const Common::StageStamps& stamps);
 
         // Deleted default ctors and assignment operators
         StrategyServer(const StrategyServer<T>& other) = delete;
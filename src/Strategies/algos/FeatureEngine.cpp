@@ -1,49 +1,46 @@
 //
 // A minimal feature engine whose protocol is to compute features that the algos will use to
-// drive their trading strategy.
-//
-// Current features include:
-// 1) Fair market value, which is derived from price and quantity updates in the order book.
+// drive their trading strategy. The features are declared at compile time by the strategy that
+// reads them (see FeaturePipeline.hpp and Features.hpp).
 //
 // Created by Michael Lewis on 10/24/23.
 //
 
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_FEATUREENGINE_CPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_FEATUREENGINE_CPP
+
+#include <tuple>
+
 #include "FeatureEngine.hpp"
 
 namespace BeaconTech::Strategies
 {
-    FeatureEngine::FeatureEngine(const BeaconTech::Common::Logger& logger) : logger{logger}, marketPrice{Common::NaN}
+    template<typename... Features>
+    FeatureEngine<Features...>::FeatureEngine(const BeaconTech::Common::Logger& logger, const std::string& name,
+                                              std::uint32_t capacity)
+        : logger{logger}, pipeline{name, capacity, FeatureParams::fromConfig()}
     {
         logger.logInfo(CLASS, "CTOR", "Creating FeatureEngine");
     }
 
-    FeatureEngine::~FeatureEngine()
+    template<typename... Features>
+    FeatureEngine<Features...>::~FeatureEngine()
     {
         logger.logInfo(CLASS, "DTOR", "Destroying FeatureEngine");
     }
 
-    double FeatureEngine::getMarketPrice() const
-    {
-        return marketPrice;
-    }
-
-    // Calculates the fair market price.
-    // It is the weighted price of the current BBO and moves to where the market is trending.
-    // For example, the market is likely to trend toward the offer when there are more open bids,
-    // so the fair price is tilted toward the offer. Conversely, the market is likely to trend toward
-    // the bid when there are more open offers, so the fair price is tilted toward the bid.
-    void FeatureEngine::onOrderBookUpdate(const MarketData::Quote& quote, const Common::Bbo& bbo)
+    // Updates the features of the instrument with its new BBO
+    template<typename... Features>
+    void FeatureEngine<Features...>::onOrderBookUpdate(std::uint32_t slot, const MarketData::Quote& quote,
+                                                       const Common::Bbo& bbo)
     {
-        std::uint32_t instrumentId;
-        MarketData::PriceLevel bestBid{};
-        MarketData::PriceLevel bestAsk{};
-        std::tie(instrumentId, bestBid, bestAsk) = bbo;
+        const MarketData::PriceLevel& bestBid = std::get<1>(bbo);
+        const MarketData::PriceLevel& bestAsk = std::get<2>(bbo);
 
-        double bidPrice = bestBid.price;
-        double bidSize = static_cast<double>(bestBid.size);
-        double askPrice = bestAsk.price;
-        double askSize = static_cast<double>(bestAsk.size);
-
-        marketPrice = (bidPrice * askSize + askPrice * bidSize) / (bidSize + askSize);
+        pipeline.update(slot, BookTop{static_cast<std::int64_t>(quote.timestamp.time_since_epoch().count()),
+                                      bestBid.price, static_cast<double>(bestBid.size),
+                                      bestAsk.price, static_cast<double>(bestAsk.size)});
     }
-} // BeaconTech
\ No newline at end of file
+} // BeaconTech
+
+#endif
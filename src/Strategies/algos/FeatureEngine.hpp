@@ -2,8 +2,21 @@
 // A minimal feature engine whose protocol is to compute features that the algos will use to
 // drive their trading strategy.
 //
-// Current features include:
+// The features are declared at compile time by the strategy that reads them (e.g. the MarketMaker only
+// reads the fair market price):
+//
+//   FeatureEngine<FairPrice>
+//
+// Features they depend on are added automatically, and each book update inlines into one straight-line
+// update of just those features (see FeaturePipeline.hpp). The available features are listed in
+// Features.hpp and include:
 // 1) Fair market value, which is derived from price and quantity updates in the order book.
+// 2) Mid price, spread and imbalance of the BBO.
+// 3) Rolling window features: EWMA of the mid price, realized volatility, order flow imbalance, update
+//    intensity and spread statistics. The time of an update is the exchange timestamp of its quote.
+//
+// Features are kept per instrument, indexed by the dense slot the InstrumentRegistry assigned it, in
+// structure of arrays columns. An engine only ever touches the slots of the instruments routed to it.
 //
 // Created by Michael Lewis on 10/24/23.
 //
@@ -11,12 +24,18 @@
 #ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_FEATUREENGINE_HPP
 #define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_FEATUREENGINE_HPP
 
+#include <cstdint>
+#include <string>
+
 #include "../../CommonServer/logging/Logger.hpp"
 #include "../../MarketData/OrderBook.hpp"
+#include "../../StrategyCommon/features/FeaturePipeline.hpp"
+#include "../../StrategyCommon/features/Features.hpp"
 
 namespace BeaconTech::Strategies
 {
 
+    template<typename... Features>
     class FeatureEngine
     {
     private:
@@ -26,27 +45,44 @@ namespace BeaconTech::Strategies
         const BeaconTech::Common::Logger& logger;
 
         // Feature properties
-        double marketPrice;
+        FeaturePipeline<Features...> pipeline;
 
     public:
-        explicit FeatureEngine(const BeaconTech::Common::Logger& logger);
+        FeatureEngine(const BeaconTech::Common::Logger& logger, const std::string& name, std::uint32_t capacity);
 
         virtual ~FeatureEngine();
 
-        double getMarketPrice() const;
+        inline std::uint32_t getCapacity() const noexcept { return pipeline.getCapacity(); }
 
-        void onOrderBookUpdate(const MarketData::Quote& quote, const Common::Bbo& bbo);
+        // A feature of the pipeline, e.g. featureEngine.template get<FairPrice>().getValue(slot)
+        template<typename Feature>
+        inline const Feature& get() const noexcept { return pipeline.template get<Feature>(); }
+
+        void onOrderBookUpdate(std::uint32_t slot, const MarketData::Quote& quote, const Common::Bbo& bbo);
+
+        // Recomputes the features of the slots [first, last) that support batch updates from their BBOs
+        inline void computeFeatures(std::uint32_t first, std::uint32_t last) noexcept
+        {
+            pipeline.compute(first, last);
+        }
 
         // Deleted default ctors and assignment operators
-        FeatureEngine(const FeatureEngine& other) = delete;
+        FeatureEngine(const FeatureEngine<Features...>& other) = delete;
 
-        FeatureEngine(FeatureEngine&& other) = delete;
+        FeatureEngine(FeatureEngine<Features...>&& other) = delete;
 
-        FeatureEngine& operator=(const FeatureEngine& other) = delete;
+        FeatureEngine<Features...>& operator=(const FeatureEngine<Features...>& other) = delete;
 
-        FeatureEngine& operator=(FeatureEngine&& other) = delete;
+        FeatureEngine<Features...>& operator=(FeatureEngine<Features...>&& other) = delete;
     };
 
 } // BeaconTech::Strategies
 
+
+//********** Start Template Definitions **********
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_FEATUREENGINE_CPP
+#include "FeatureEngine.cpp"
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_FEATUREENGINE_CPP
+//********** End Template Definitions **********
+
 #endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_FEATUREENGINE_HPP
@@ -14,14 +14,16 @@
 #ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_MARKETMAKER_CPP
 #define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_MARKETMAKER_CPP
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <tuple>
 
 #include "MarketMaker.hpp"
 #include "../StrategyEngine.hpp"
 #include "FeatureEngine.hpp"
-#include "../../RiskManager/managers/OrderManager.hpp"
-#include "../../CommonServer/utils/ConfigManager.hpp"
+#include "../../CommonServer/utils/ConfigReloader.hpp"
+#include "../../StrategyCommon/managers/StrategyConfigManager.hpp"
 #include "../../MessageObjects/marketdata/Quote.hpp"
 #include "../../MarketData/MarketDataUtils.hpp"
 #include "../../CommonServer/utils/Clock.hpp"
@@ -30,10 +32,10 @@ namespace BeaconTech::Strategies
 {
     template<typename T>
     MarketMaker<T>::MarketMaker(const BeaconTech::Common::Logger& logger, const std::shared_ptr<Common::Clock>& clock,
-                                StrategyEngine<T>& strategyEngine, const FeatureEngine& featureEngine)
-        : logger{logger}, clock{clock}, strategyEngine{strategyEngine}, featureEngine{featureEngine},
-          targetSpreadBps{Common::ConfigManager::doubleConfigValueDefaultIfNull("targetSpreadBps", 0.0002)},
-          targetSize{Common::ConfigManager::intConfigValueDefaultIfNull("targetSize", 100)}
+                                StrategyEngine<T>& strategyEngine, const Features& featureEngine,
+                                const Common::ConfigReader& config, const StrategyConfigManager& strategyConfig)
+        : logger{logger}, clock{clock}, strategyEngine{strategyEngine}, featureEngine{featureEngine}, config{config},
+          strategyConfig{strategyConfig}
     {
         logger.logInfo(CLASS, "CTOR", "Creating MarketMaker");
         initializeCallbacks();
@@ -48,26 +50,31 @@ namespace BeaconTech::Strategies
     template<typename T>
     void MarketMaker<T>::initializeCallbacks()
     {
-        strategyEngine.onOrderBookUpdateAlgo = [this](auto quote, auto bbo) -> void { onOrderBookUpdate(quote, bbo); };
+        strategyEngine.onOrderBookUpdateAlgo = [this](auto slot, auto quote, auto bbo) -> void {
+            onOrderBookUpdate(slot, quote, bbo);
+        };
     }
 
     // Process the BBO, calculate fair market price, perform risk checks and create, modify, or cancel passive orders
     template<typename T>
-    void MarketMaker<T>::onOrderBookUpdate(const MarketData::Quote& quote, const Common::Bbo& bbo)
+    void MarketMaker<T>::onOrderBookUpdate(std::uint32_t slot, const MarketData::Quote& quote, const Common::Bbo& bbo)
     {
-        double fairMarketPrice = featureEngine.getMarketPrice();
+        const InstrumentParams& params = strategyConfig.getParams(slot);
+        if (!params.enabled) return;
+
+        double fairMarketPrice = featureEngine.get<FairPrice>().getValue(slot);
         if (std::isnan(fairMarketPrice)) return;
 
         MarketData::MarketDataUtils::printBbo(bbo, fairMarketPrice);
 
+        const double targetSpreadBps = params.targetSpreadBps > 0.0 ? params.targetSpreadBps : config.get().targetSpreadBps;
         double bidPrice = std::get<1>(bbo).price;
         double askPrice = std::get<2>(bbo).price;
 
         // Calculate bid and ask prices that the strategy will use for the passive orders it sends into
-        // the market. A future release will upgrade the intelligence of this logic to dynamically determine
-        // a based on the instrument because spreads vary across instruments. However, for now, the system
-        // threshold uses a default config to set the target spread at 2% which is roughly the average
-        // spread on NSDQ listed securities.
+        // the market. Spreads vary across instruments, so the threshold is the target spread configured for
+        // the instrument. Instruments without one use the default config, which sets the target spread at
+        // 2% which is roughly the average spread on NSDQ listed securities.
         //
         // The system will use the BBO on orders it sends into the market whenever the difference
         // between our fair market price and the BBO is >= to the threshold. The intuition is simple -
@@ -83,8 +90,20 @@ namespace BeaconTech::Strategies
         bidPrice = bidPrice - (fairMarketPrice - bidPrice >= (bidPrice * targetSpreadBps) ? 0 : 1);
         askPrice = askPrice + (askPrice - fairMarketPrice >= (askPrice * targetSpreadBps) ? 0 : 1);
 
-        // todo - send request over multicst into risk manager
-//        orderManager.onOrderRequest(std::get<0>(bbo), bidPrice, askPrice, targetSize);
+        // Keep the passive prices on the instrument's tick grid, rounding away from the market. The epsilon
+        // keeps prices that are already on the grid (but not exactly representable) where they are
+        if (params.tickSize > 0.0)
+        {
+            bidPrice = std::floor(bidPrice / params.tickSize + 1e-9) * params.tickSize;
+            askPrice = std::ceil(askPrice / params.tickSize - 1e-9) * params.tickSize;
+        }
+
+        // Caps the size of each request. The strategy does not track its fills, so there is no position limit
+        std::uint32_t qty = params.targetSize > 0 ? params.targetSize : config.get().targetSize;
+        if (params.maxOrderSize > 0) qty = std::min(qty, params.maxOrderSize);
+
+        // Send the request to the risk manager, which performs the pre-trade risk checks and creates the orders
+        strategyEngine.sendOrderRequest(std::get<0>(bbo), bidPrice, askPrice, qty);
     }
 } // BeaconTech
 
@@ -21,6 +21,8 @@
 #include "FeatureEngine.hpp"
 #include "../../MessageObjects/marketdata/Quote.hpp"
 #include "../../CommonServer/utils/Clock.hpp"
+#include "../../CommonServer/utils/ConfigReloader.hpp"
+#include "../../StrategyCommon/managers/StrategyConfigManager.hpp"
 
 namespace BeaconTech::Strategies
 {
@@ -32,6 +34,10 @@ namespace BeaconTech::Strategies
     template<typename T>
     class MarketMaker
     {
+    public:
+        // The features the algorithm reads. Only these are computed by the engine's feature engine
+        using Features = FeatureEngine<FairPrice>;
+
     private:
         inline static const std::string CLASS = "MarketMaker";
 
@@ -41,21 +47,23 @@ namespace BeaconTech::Strategies
 
         // Strategy properties
         StrategyEngine<T>& strategyEngine;
-        const FeatureEngine& featureEngine;
+        const Features& featureEngine;
 
-        // Order properties
-        double targetSpreadBps;
-        std::uint32_t targetSize;
+        // Order properties are read per instrument from the strategy configs, falling back to the engine's
+        // reloadable configs for the targetSpreadBps and targetSize of instruments that do not set their own
+        const Common::ConfigReader& config;
+        const StrategyConfigManager& strategyConfig;
 
     public:
         MarketMaker(const BeaconTech::Common::Logger& logger, const std::shared_ptr<Common::Clock>& clock,
-                    StrategyEngine<T>& strategyEngine, const FeatureEngine& featureEngine);
+                    StrategyEngine<T>& strategyEngine, const Features& featureEngine,
+                    const Common::ConfigReader& config, const StrategyConfigManager& strategyConfig);
 
         virtual ~MarketMaker();
 
         void initializeCallbacks();
 
-        void onOrderBookUpdate(const MarketData::Quote &quote, const Common::Bbo& bbo);
+        void onOrderBookUpdate(std::uint32_t slot, const MarketData::Quote &quote, const Common::Bbo& bbo);
 
         // Deleted default ctors and assignment operators
         MarketMaker() = delete;
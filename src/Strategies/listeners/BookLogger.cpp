@@ -0,0 +1,35 @@
+//
+// A non-trading listener that logs the book updates of an engine thread.
+//
+// Created by Michael Lewis on 1/29/24.
+//
+
+#include <tuple>
+
+#include "BookLogger.hpp"
+#include "../../CommonServer/logging/LogSampler.hpp"
+#include "../../CommonServer/utils/ConfigManager.hpp"
+
+namespace BeaconTech::Strategies
+{
+    BookLogger::BookLogger(std::uint32_t threadId)
+        : logger{CLASS_PATH, APP_NAME, threadId},
+          maxPerSecond{Common::ConfigManager::config().printBboPerSecond}
+    {
+        logger.logInfo(CLASS, "CTOR", "Creating BookLogger");
+    }
+
+    BookLogger::~BookLogger()
+    {
+        logger.logInfo(CLASS, "DTOR", "Destroying BookLogger");
+    }
+
+    // Logs a sample of the BBO of each instrument. Runs on the engine thread that owns the listener
+    void BookLogger::onBookEvent(const BookEvent& event)
+    {
+        const auto& [instrumentId, bestBid, bestAsk] = event.bbo;
+        LOG_RATE_LIMITED(logger, INFO, maxPerSecond, instrumentId, CLASS, "onBookEvent",
+                         "InstrumentId=% bestBid=$% x % bestAsk=$% x %",
+                         instrumentId, bestBid.price, bestBid.size, bestAsk.price, bestAsk.size);
+    }
+} // namespace BeaconTech::Strategies
@@ -0,0 +1,56 @@
+//
+// A non-trading listener that logs the book updates of an engine thread. It runs behind the engine that
+// trades (see StrategyServer::createThreads), so it never sends orders or records stage latencies.
+// Each instrument is limited to printBboPerSecond lines.
+//
+// Created by Michael Lewis on 1/29/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_BOOKLOGGER_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_BOOKLOGGER_HPP
+
+#define CLASS_FILE_PATH (std::filesystem::path(__FILE__).parent_path().string())
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include "../../MarketData/OrderBook.hpp"
+#include "../routing/BookEvent.hpp"
+#include "../../CommonServer/logging/Logger.hpp"
+
+namespace BeaconTech::Strategies
+{
+
+    class BookLogger
+    {
+    private:
+        inline static const std::string CLASS_PATH = CLASS_FILE_PATH;
+        inline static const std::string APP_NAME = "STRATEGIES";
+        inline static const std::string CLASS = "BookLogger";
+
+        const BeaconTech::Common::Logger logger;
+        std::uint32_t maxPerSecond;
+
+    public:
+        explicit BookLogger(std::uint32_t threadId);
+
+        virtual ~BookLogger();
+
+        void onBookEvent(const BookEvent& event);
+
+        // Deleted default ctors and assignment operators
+        BookLogger() = delete;
+
+        BookLogger(const BookLogger& other) = delete;
+
+        BookLogger(BookLogger&& other) = delete;
+
+        BookLogger& operator=(const BookLogger& other) = delete;
+
+        BookLogger& operator=(BookLogger&& other) = delete;
+    };
+
+} // namespace BeaconTech::Strategies
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_BOOKLOGGER_HPP
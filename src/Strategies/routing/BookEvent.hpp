@@ -0,0 +1,46 @@
+//
+// A book update as it travels from the market data thread to the engine listeners. Events live in the
+// slots of an engine's SequencedRing and are overwritten in place, so every member is copied (not
+// referenced) from the order book when the event is published.
+//
+// Created by Michael Lewis on 1/11/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_BOOKEVENT_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_BOOKEVENT_HPP
+
+#include <cstdint>
+
+#include "../../CommonServer/types/MdTypes.hpp"
+#include "../../CommonServer/types/NumericTypes.hpp"
+#include "../../CommonServer/telemetry/StageLatency.hpp"
+#include "../../MessageObjects/marketdata/Quote.hpp"
+
+namespace BeaconTech::Strategies
+{
+
+    struct BookEvent
+    {
+        std::uint32_t instrumentId;
+        std::uint32_t slot;         // See InstrumentRegistry.hpp
+        MarketData::Quote quote;
+        Common::Bbo bbo;
+        [[no_unique_address]] Common::StageStamps stamps;
+
+        // Ring slots are default constructed before the first event is written to them
+        BookEvent() : instrumentId{0}, slot{0}, quote{0, MarketData::Side::UNKNOWN, Common::NaN, 0, {}}, bbo{}, stamps{}
+        {
+
+        }
+
+        BookEvent(std::uint32_t instrumentId, std::uint32_t slot, const MarketData::Quote& quote,
+                  const Common::Bbo& bbo, const Common::StageStamps& stamps)
+            : instrumentId{instrumentId}, slot{slot}, quote{quote}, bbo{bbo}, stamps{stamps}
+        {
+
+        }
+    };
+
+} // namespace BeaconTech::Strategies
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_BOOKEVENT_HPP
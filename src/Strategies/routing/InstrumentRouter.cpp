@@ -0,0 +1,202 @@
+//
+// Assigns instruments to engine threads. Every book update for an instrument is processed by a single
+// engine so that updates are deterministically sequenced per instrument.
+//
+// Routes come from three sources, in order of precedence:
+// 1) Pinned routes loaded from the file configured by instrumentRoutesFile (lines of instrumentId,engine)
+// 2) Balanced routes computed from the message rate of each instrument. The rates are gathered during
+//    the first routingWarmupSeconds of the session and, optionally, every routingRebalanceSeconds after that
+// 3) instrumentId % numEngines for instruments that have not been routed yet
+//
+// Created by Michael Lewis on 1/9/24.
+//
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "InstrumentRouter.hpp"
+#include "../../CommonServer/logging/LogLevel.hpp"
+#include "../../CommonServer/utils/ConfigManager.hpp"
+
+namespace BeaconTech::Strategies
+{
+    InstrumentRouter::InstrumentRouter(std::uint32_t numEngines, InstrumentRegistry& instruments)
+        : numEngines{std::max(numEngines, 1U)}, instruments{instruments},
+          warmup{Common::ConfigManager::config().routingWarmupSeconds},
+          rebalanceInterval{Common::ConfigManager::config().routingRebalanceSeconds},
+          imbalanceThreshold{Common::ConfigManager::config().routingImbalanceThreshold},
+          windowStart{std::chrono::steady_clock::now()}, nextRebalance{windowStart + warmup},
+          rebalanceEnabled{warmup.count() > 0 && this->numEngines > 1}, messagesSinceClockCheck{0}
+    {
+        loadPinnedRoutes(Common::ConfigManager::config().instrumentRoutesFile);
+    }
+
+    // Loads routes that are fixed for the session. Each line is formatted as instrumentId,engine.
+    // Blank lines and lines starting with # are ignored
+    void InstrumentRouter::loadPinnedRoutes(const std::string& routesFile)
+    {
+        if (routesFile.empty()) return;
+
+        std::ifstream file{routesFile, std::ios::in};
+        if (!file.is_open())
+        {
+            std::cerr << Common::LogLevel::WARN.getDesc()
+                      << " : Unable to open instrument routes file " << routesFile << std::endl;
+            return;
+        }
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.empty() || line.front() == '#') continue;
+
+            try
+            {
+                auto comma = line.find(',');
+                std::uint32_t instrumentId = std::stoul(line.substr(0, comma));
+                std::uint32_t engine = std::stoul(line.substr(comma + 1));
+
+                if (comma == std::string::npos || engine >= numEngines)
+                {
+                    std::cerr << Common::LogLevel::WARN.getDesc()
+                              << " : Ignoring invalid instrument route " << line << std::endl;
+                    continue;
+                }
+
+                routes[instrumentId] = Route{engine, instruments.slot(instrumentId), 0, true};
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << Common::LogLevel::WARN.getDesc()
+                          << " : Ignoring invalid instrument route " << line << " - " << e.what() << std::endl;
+            }
+        }
+    }
+
+    // Returns the route (engine and slot) of the instrument and records the message for load statistics.
+    // Unknown instruments are assigned by modulo until the next rebalance.
+    const Route& InstrumentRouter::route(std::uint32_t instrumentId)
+    {
+        auto it = routes.find(instrumentId);
+        if (it == routes.end()) [[unlikely]]
+        {
+            it = routes.emplace(instrumentId, Route{instrumentId % numEngines, instruments.slot(instrumentId), 0, false}).first;
+        }
+
+        ++it->second.messages;
+        return it->second;
+    }
+
+    // Read-only lookup that does not record statistics or create routes
+    std::uint32_t InstrumentRouter::getEngine(std::uint32_t instrumentId) const
+    {
+        auto it = routes.find(instrumentId);
+        return it == routes.cend() ? instrumentId % numEngines : it->second.engine;
+    }
+
+    // Determines if the statistics window has elapsed
+    bool InstrumentRouter::rebalanceDue() noexcept
+    {
+        if (!rebalanceEnabled) [[likely]] return false;
+        if (++messagesSinceClockCheck < CLOCK_CHECK_INTERVAL) [[likely]] return false;
+
+        messagesSinceClockCheck = 0;
+        return std::chrono::steady_clock::now() >= nextRebalance;
+    }
+
+    // Calculates the messages per second processed by each engine in the current window
+    std::vector<double> InstrumentRouter::engineLoads(double windowSeconds) const
+    {
+        std::vector<double> loads(numEngines, 0.0);
+        for (const auto& [instrumentId, route] : routes)
+        {
+            loads[route.engine] += static_cast<double>(route.messages) / windowSeconds;
+        }
+
+        return loads;
+    }
+
+    // Ratio of the busiest engine to the average engine. 1.0 is perfectly balanced
+    double InstrumentRouter::imbalance(const std::vector<double>& loads)
+    {
+        double total = std::accumulate(loads.cbegin(), loads.cend(), 0.0);
+        if (total <= 0.0) return 1.0;
+
+        double mean = total / static_cast<double>(loads.size());
+        return *std::max_element(loads.cbegin(), loads.cend()) / mean;
+    }
+
+    // Plans a balanced assignment using longest-processing-time-first: the busiest instruments are placed
+    // first, each on the least loaded engine (preferring its current engine on ties to avoid needless moves).
+    // The plan is only adopted when the current imbalance exceeds routingImbalanceThreshold and the plan
+    // improves on it. The routes are left unchanged; the caller must start a handoff for each returned
+    // instrument and then apply it with reassign.
+    std::vector<Reassignment> InstrumentRouter::planRebalance()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        const double windowSeconds = std::max(std::chrono::duration<double>(now - windowStart).count(), 1e-9);
+
+        std::vector<double> currentLoads = engineLoads(windowSeconds);
+        std::vector<double> plannedLoads(numEngines, 0.0);
+        std::vector<std::pair<std::uint32_t, Route*>> candidates;
+
+        for (auto& [instrumentId, route] : routes)
+        {
+            if (route.pinned) plannedLoads[route.engine] += static_cast<double>(route.messages) / windowSeconds;
+            else candidates.emplace_back(instrumentId, &route);
+        }
+
+        std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.second->messages > rhs.second->messages;
+        });
+
+        std::vector<std::uint32_t> plannedEngines;
+        plannedEngines.reserve(candidates.size());
+        for (const auto& [instrumentId, route] : candidates)
+        {
+            std::uint32_t engine = route->engine;
+            for (std::uint32_t candidate = 0; candidate < numEngines; ++candidate)
+            {
+                if (plannedLoads[candidate] < plannedLoads[engine]) engine = candidate;
+            }
+
+            plannedLoads[engine] += static_cast<double>(route->messages) / windowSeconds;
+            plannedEngines.push_back(engine);
+        }
+
+        std::vector<Reassignment> reassignments;
+        if (imbalance(currentLoads) > imbalanceThreshold && imbalance(plannedLoads) < imbalance(currentLoads))
+        {
+            for (std::size_t i = 0; i < candidates.size(); ++i)
+            {
+                auto& [instrumentId, route] = candidates[i];
+                if (route->engine == plannedEngines[i]) continue;
+
+                reassignments.push_back(Reassignment{instrumentId, route->engine, plannedEngines[i]});
+            }
+        }
+
+        // Start a new statistics window
+        for (auto& [instrumentId, route] : routes) route.messages = 0;
+        windowStart = now;
+        nextRebalance = now + rebalanceInterval;
+        rebalanceEnabled = rebalanceInterval.count() > 0;
+
+        return reassignments;
+    }
+
+    // Moves the instrument to the engine. Pinned and unknown instruments are left alone
+    void InstrumentRouter::reassign(std::uint32_t instrumentId, std::uint32_t engine)
+    {
+        auto it = routes.find(instrumentId);
+        if (it == routes.end() || it->second.pinned || engine >= numEngines) return;
+
+        it->second.engine = engine;
+    }
+} // namespace BeaconTech::Strategies
@@ -0,0 +1,106 @@
+//
+// Assigns instruments to engine threads. Every book update for an instrument is processed by a single
+// engine so that updates are deterministically sequenced per instrument.
+//
+// Routes come from three sources, in order of precedence:
+// 1) Pinned routes loaded from the file configured by instrumentRoutesFile (lines of instrumentId,engine)
+// 2) Balanced routes computed from the message rate of each instrument. The rates are gathered during
+//    the first routingWarmupSeconds of the session and, optionally, every routingRebalanceSeconds after that
+// 3) instrumentId % numEngines for instruments that have not been routed yet
+//
+// The router only plans reassignments. The StrategyServer owns the drain-and-handoff protocol that
+// moves an instrument between engines without violating per-instrument ordering, and only applies a
+// reassignment (reassign) once the handoff for it has been created.
+//
+// Each route also carries the dense slot of the instrument (see InstrumentRegistry.hpp), so the lookup that
+// picks the engine also yields the index of the instrument's parameters and features.
+//
+// The router is only accessed by the market data consumer thread, so it requires no synchronization.
+//
+// Created by Michael Lewis on 1/9/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_INSTRUMENTROUTER_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_INSTRUMENTROUTER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../StrategyCommon/managers/InstrumentRegistry.hpp"
+
+namespace BeaconTech::Strategies
+{
+
+    struct Route
+    {
+        std::uint32_t engine;
+        std::uint32_t slot;
+        std::uint64_t messages;  // Messages received in the current statistics window
+        bool pinned;
+    };
+
+    struct Reassignment
+    {
+        std::uint32_t instrumentId;
+        std::uint32_t fromEngine;
+        std::uint32_t toEngine;
+    };
+
+    class InstrumentRouter
+    {
+    private:
+        // Only look at the clock once every CLOCK_CHECK_INTERVAL messages to keep the clock off the hot path
+        static constexpr std::uint32_t CLOCK_CHECK_INTERVAL = 1024;
+
+        std::uint32_t numEngines;
+        InstrumentRegistry& instruments;
+        std::unordered_map<std::uint32_t, Route> routes; // instrumentId -> route
+
+        // Rebalancing properties
+        std::chrono::seconds warmup;
+        std::chrono::seconds rebalanceInterval;
+        double imbalanceThreshold;
+        std::chrono::steady_clock::time_point windowStart;
+        std::chrono::steady_clock::time_point nextRebalance;
+        bool rebalanceEnabled;
+        std::uint32_t messagesSinceClockCheck;
+
+        void loadPinnedRoutes(const std::string& routesFile);
+
+        std::vector<double> engineLoads(double windowSeconds) const;
+
+        static double imbalance(const std::vector<double>& loads);
+
+    public:
+        InstrumentRouter(std::uint32_t numEngines, InstrumentRegistry& instruments);
+
+        virtual ~InstrumentRouter() = default;
+
+        const Route& route(std::uint32_t instrumentId);
+
+        std::uint32_t getEngine(std::uint32_t instrumentId) const;
+
+        bool rebalanceDue() noexcept;
+
+        std::vector<Reassignment> planRebalance();
+
+        void reassign(std::uint32_t instrumentId, std::uint32_t engine);
+
+        // Deleted default ctors and assignment operators
+        InstrumentRouter() = delete;
+
+        InstrumentRouter(const InstrumentRouter& other) = delete;
+
+        InstrumentRouter(InstrumentRouter&& other) = delete;
+
+        InstrumentRouter& operator=(const InstrumentRouter& other) = delete;
+
+        InstrumentRouter& operator=(InstrumentRouter&& other) = delete;
+    };
+
+} // namespace BeaconTech::Strategies
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_INSTRUMENTROUTER_HPP
@@ -0,0 +1,40 @@
+//
+// Composes features at compile time and keeps their values in slot indexed columns.
+//
+// Created by Michael Lewis on 1/29/24.
+//
+
+#include <stdexcept>
+
+#include "FeaturePipeline.hpp"
+#include "../../CommonServer/types/NumericTypes.hpp"
+#include "../../CommonServer/utils/ConfigManager.hpp"
+
+namespace BeaconTech::Strategies
+{
+    FeatureParams FeatureParams::fromConfig()
+    {
+        const Common::ConfigSnapshot& config = Common::ConfigManager::config();
+        return FeatureParams{static_cast<std::int64_t>(config.featureHalfLifeMillis) * 1'000'000,
+                             static_cast<std::int64_t>(config.featureWindowMillis) * 1'000'000,
+                             config.featureWindowCapacity, config.featureSpreadEvents};
+    }
+
+    // Columns are padded to a whole number of cache lines so that every column starts on one
+    FeatureStorage::FeatureStorage(const std::string& name, std::uint32_t capacity, std::size_t columns,
+                                   const FeatureParams& params)
+        : capacity{capacity},
+          stride{(capacity + DOUBLES_PER_CACHE_LINE - 1) / DOUBLES_PER_CACHE_LINE * DOUBLES_PER_CACHE_LINE},
+          columns{columns}, nextColumn{0}, params{params},
+          values(columns * stride, Common::NaN, Common::HugePageAllocator<double>{name})
+    {
+
+    }
+
+    double* FeatureStorage::column()
+    {
+        if (nextColumn == columns) throw std::logic_error{"A feature took more columns than it declared"};
+
+        return values.data() + nextColumn++ * stride;
+    }
+} // namespace BeaconTech::Strategies
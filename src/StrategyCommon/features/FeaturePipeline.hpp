@@ -0,0 +1,261 @@
+//
+// Composes features at compile time. A pipeline is declared with the features a strategy reads:
+//
+//   FeaturePipeline<FairPrice, SpreadStats>
+//
+// and every feature they depend on (e.g. SpreadStats depends on Spread) is added ahead of them, so the
+// features are always updated after their dependencies. The resolved features are held in a tuple and each
+// book update is a fold over them, which the compiler inlines into one straight-line function: there are
+// no virtual calls or branches per feature, and features that are not listed cost nothing.
+//
+// A feature is a type with
+//
+//   using Dependencies = FeatureList<...>;           // Features it reads through the pipeline
+//   static constexpr std::size_t COLUMNS = n;        // Columns of slot indexed values it needs
+//   explicit Feature(FeatureStorage& storage);       // Takes its columns with storage.column()
+//   template<typename Pipeline>
+//   void update(std::uint32_t slot, const BookTop& top, const BookTop& previous, const Pipeline& pipeline);
+//
+// and optionally a compute(first, last, book) that recomputes a range of slots from the BBO columns for
+// batch updates. Features read each other with pipeline.template get<Feature>(). See Features.hpp.
+//
+// The pipeline keeps the BBO of every instrument, and the values of every feature, in cache line aligned
+// columns indexed by the dense slot the InstrumentRegistry assigned the instrument (structure of arrays).
+// The columns are carved out of one allocation of pre-faulted (and where possible huge page) memory.
+//
+// Created by Michael Lewis on 1/29/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_FEATUREPIPELINE_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_FEATUREPIPELINE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "../../CommonServer/memory/HugePageAllocator.hpp"
+
+namespace BeaconTech::Strategies
+{
+
+    template<typename... Features>
+    struct FeatureList
+    {
+    };
+
+    namespace detail
+    {
+        template<typename List, typename Feature>
+        struct AppendUnique;
+
+        template<typename... Features, typename Feature>
+        struct AppendUnique<FeatureList<Features...>, Feature>
+        {
+            using type = std::conditional_t<(std::is_same_v<Features, Feature> || ...),
+                                            FeatureList<Features...>, FeatureList<Features..., Feature>>;
+        };
+
+        // Appends each feature to the list after its dependencies, skipping features already in the list
+        template<typename List, typename... Features>
+        struct Resolve
+        {
+            using type = List;
+        };
+
+        template<typename List, typename Dependencies>
+        struct ResolveList;
+
+        template<typename List, typename... Dependencies>
+        struct ResolveList<List, FeatureList<Dependencies...>>
+        {
+            using type = typename Resolve<List, Dependencies...>::type;
+        };
+
+        template<typename List, typename Feature, typename... Rest>
+        struct Resolve<List, Feature, Rest...>
+        {
+            using WithDependencies = typename ResolveList<List, typename Feature::Dependencies>::type;
+            using type = typename Resolve<typename AppendUnique<WithDependencies, Feature>::type, Rest...>::type;
+        };
+
+        template<typename List>
+        struct PipelineTuple;
+
+        template<typename... Features>
+        struct PipelineTuple<FeatureList<Features...>>
+        {
+            using type = std::tuple<Features...>;
+        };
+    }
+
+    // The features listed and their dependencies, each after its dependencies
+    template<typename... Features>
+    using ResolveFeatures = typename detail::Resolve<FeatureList<>, Features...>::type;
+
+    // The time of a book update and the BBO after it. Prices are NaN when a side of the book is empty
+    struct BookTop
+    {
+        std::int64_t nanos;
+        double bidPrice;
+        double bidSize;
+        double askPrice;
+        double askSize;
+    };
+
+    // The BBO columns (slot -> value) that batch updates read
+    struct BookColumns
+    {
+        const double* bidPrices;
+        const double* askPrices;
+        const double* bidSizes;
+        const double* askSizes;
+    };
+
+    // Settings of the rolling window features
+    //
+    //   "featureHalfLifeMillis": "1000"
+    //   "featureWindowMillis": "1000"
+    //   "featureWindowCapacity": "4096"   (samples a time window holds before evicting early)
+    //   "featureSpreadEvents": "100"
+    struct FeatureParams
+    {
+        std::int64_t halfLifeNanos;
+        std::int64_t windowNanos;
+        std::uint32_t windowCapacity;
+        std::uint32_t spreadEvents;
+
+        static FeatureParams fromConfig();
+    };
+
+    // Hands out the columns of one allocation in order. Every column starts on a cache line and holds
+    // getCapacity() values that start as NaN
+    class FeatureStorage
+    {
+    private:
+        static constexpr std::size_t DOUBLES_PER_CACHE_LINE = 64 / sizeof(double);
+
+        std::uint32_t capacity;
+        std::size_t stride;
+        std::size_t columns;
+        std::size_t nextColumn;
+        FeatureParams params;
+        std::vector<double, Common::HugePageAllocator<double>> values;
+
+    public:
+        FeatureStorage(const std::string& name, std::uint32_t capacity, std::size_t columns, const FeatureParams& params);
+
+        // Throws if more columns are taken than the storage was created with
+        double* column();
+
+        inline std::uint32_t getCapacity() const noexcept { return capacity; }
+
+        inline const FeatureParams& getParams() const noexcept { return params; }
+
+        // Deleted default ctors and assignment operators
+        FeatureStorage() = delete;
+
+        FeatureStorage(const FeatureStorage& other) = delete;
+
+        FeatureStorage(FeatureStorage&& other) = delete;
+
+        FeatureStorage& operator=(const FeatureStorage& other) = delete;
+
+        FeatureStorage& operator=(FeatureStorage&& other) = delete;
+    };
+
+    template<typename... Features>
+    class FeaturePipeline
+    {
+    private:
+        using Resolved = ResolveFeatures<Features...>;
+        using Tuple = typename detail::PipelineTuple<Resolved>::type;
+
+        static constexpr std::size_t BOOK_COLUMNS = 4;
+
+        template<typename... Ordered>
+        static constexpr std::size_t countColumns(FeatureList<Ordered...>) noexcept
+        {
+            return (BOOK_COLUMNS + ... + Ordered::COLUMNS);
+        }
+
+        FeatureStorage storage;
+
+        // The BBO of each instrument as of its last update (slot -> value)
+        double* bidPrices;
+        double* askPrices;
+        double* bidSizes;
+        double* askSizes;
+
+        Tuple features;
+
+        // Features are constructed in order, so their columns are taken in order
+        template<typename... Ordered>
+        static Tuple createFeatures(FeatureStorage& storage, FeatureList<Ordered...>)
+        {
+            return Tuple{Ordered{storage}...};
+        }
+
+    public:
+        FeaturePipeline(const std::string& name, std::uint32_t capacity, const FeatureParams& params)
+            : storage{name, capacity, countColumns(Resolved{}), params},
+              bidPrices{storage.column()}, askPrices{storage.column()},
+              bidSizes{storage.column()}, askSizes{storage.column()},
+              features{createFeatures(storage, Resolved{})}
+        {
+            std::fill_n(bidSizes, capacity, 0.0);
+            std::fill_n(askSizes, capacity, 0.0);
+        }
+
+        virtual ~FeaturePipeline() = default;
+
+        inline std::uint32_t getCapacity() const noexcept { return storage.getCapacity(); }
+
+        template<typename Feature>
+        inline const Feature& get() const noexcept { return std::get<Feature>(features); }
+
+        inline BookColumns getBook() const noexcept { return BookColumns{bidPrices, askPrices, bidSizes, askSizes}; }
+
+        // Updates every feature of the instrument in dependency order, then records the BBO as the previous
+        // one. The previous BBO carries the time of this update
+        inline void update(std::uint32_t slot, const BookTop& top)
+        {
+            const BookTop previous{top.nanos, bidPrices[slot], bidSizes[slot], askPrices[slot], askSizes[slot]};
+
+            std::apply([&](auto&... feature) { (feature.update(slot, top, previous, *this), ...); }, features);
+
+            bidPrices[slot] = top.bidPrice;
+            bidSizes[slot] = top.bidSize;
+            askPrices[slot] = top.askPrice;
+            askSizes[slot] = top.askSize;
+        }
+
+        // Recomputes the slots [first, last) of every feature that supports batch updates from the BBO columns
+        inline void compute(std::uint32_t first, std::uint32_t last) noexcept
+        {
+            const BookColumns book = getBook();
+            std::apply([&](auto&... feature) {
+                ([&](auto& each) {
+                    if constexpr (requires { each.compute(first, last, book); }) each.compute(first, last, book);
+                }(feature), ...);
+            }, features);
+        }
+
+        // Deleted default ctors and assignment operators
+        FeaturePipeline() = delete;
+
+        FeaturePipeline(const FeaturePipeline& other) = delete;
+
+        FeaturePipeline(FeaturePipeline&& other) = delete;
+
+        FeaturePipeline& operator=(const FeaturePipeline& other) = delete;
+
+        FeaturePipeline& operator=(FeaturePipeline&& other) = delete;
+    };
+
+} // namespace BeaconTech::Strategies
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_FEATUREPIPELINE_HPP
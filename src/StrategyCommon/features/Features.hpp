@@ -0,0 +1,407 @@
+//
+// The features a FeaturePipeline can be composed from (see FeaturePipeline.hpp). Each feature keeps its
+// values in slot indexed columns:
+//
+// 1) FairPrice          - Size weighted price of the BBO, tilted toward where the market is trending
+// 2) MidPrice           - Mid price of the BBO
+// 3) Spread             - Spread of the BBO
+// 4) BookImbalance      - Imbalance of the BBO sizes, from -1 (only offers) to 1 (only bids)
+// 5) EwmaMidPrice       - EWMA of the mid price, decaying with a half-life of featureHalfLifeMillis
+// 6) RealizedVolatility - The square root of the sum of squared log returns of the mid price over the
+//                         last featureWindowMillis. It is not annualized
+// 7) OrderFlowImbalance - The net size added to the bid less the net size added to the ask at the touch
+//                         over the last featureWindowMillis (Cont, Kukanov and Stoikov)
+// 8) UpdateIntensity    - Book updates per second over the last featureWindowMillis. Trade prints are not
+//                         forwarded to the engines (fills reach the book as cancels), so this stands in
+//                         for trade intensity
+// 9) SpreadStats        - Spread mean and standard deviation over the last featureSpreadEvents book updates
+//
+// Features 1-4 are computed from the BBO alone and support batch updates. The rolling window features
+// (5-9) are updated incrementally with the operators in WindowOperators.hpp and keep their window state
+// per instrument, created the first time the pipeline sees the instrument. They skip updates with a
+// one-sided book (a NaN price), except the order flow window which counts every update for UpdateIntensity.
+//
+// Created by Michael Lewis on 1/29/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_FEATURES_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_FEATURES_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "FeaturePipeline.hpp"
+#include "WindowOperators.hpp"
+
+namespace BeaconTech::Strategies
+{
+    namespace detail
+    {
+        inline bool isTwoSided(const BookTop& top) noexcept
+        {
+            return !std::isnan(top.bidPrice) && !std::isnan(top.askPrice);
+        }
+    }
+
+    // The rolling window state of every instrument, created the first time the instrument is updated so
+    // that an engine only holds windows for the instruments routed to it
+    template<typename State>
+    class SlotStates
+    {
+    private:
+        std::vector<std::unique_ptr<State>> states;   // slot -> state
+
+    public:
+        explicit SlotStates(std::uint32_t capacity) : states(capacity)
+        {
+
+        }
+
+        template<typename... Args>
+        inline State& get(std::uint32_t slot, Args&&... args)
+        {
+            std::unique_ptr<State>& state = states[slot];
+            if (!state) [[unlikely]] state = std::make_unique<State>(std::forward<Args>(args)...);
+
+            return *state;
+        }
+    };
+
+    // The weighted price of the current BBO moves to where the market is trending. For example, the market
+    // is likely to trend toward the offer when there are more open bids, so the fair price is tilted toward
+    // the offer. Conversely, the market is likely to trend toward the bid when there are more open offers,
+    // so the fair price is tilted toward the bid.
+    class FairPrice
+    {
+    private:
+        double* values;
+
+        static inline void computeColumns(const double* __restrict bidPrices, const double* __restrict askPrices,
+                                          const double* __restrict bidSizes, const double* __restrict askSizes,
+                                          double* __restrict values, std::uint32_t first, std::uint32_t last) noexcept
+        {
+            for (std::uint32_t slot = first; slot < last; ++slot)
+            {
+                values[slot] = (bidPrices[slot] * askSizes[slot] + askPrices[slot] * bidSizes[slot])
+                               / (bidSizes[slot] + askSizes[slot]);
+            }
+        }
+
+    public:
+        using Dependencies = FeatureList<>;
+        static constexpr std::size_t COLUMNS = 1;
+
+        explicit FairPrice(FeatureStorage& storage) : values{storage.column()}
+        {
+
+        }
+
+        template<typename Pipeline>
+        inline void update(std::uint32_t slot, const BookTop& top, const BookTop&, const Pipeline&) noexcept
+        {
+            values[slot] = (top.bidPrice * top.askSize + top.askPrice * top.bidSize) / (top.bidSize + top.askSize);
+        }
+
+        inline void compute(std::uint32_t first, std::uint32_t last, const BookColumns& book) noexcept
+        {
+            computeColumns(book.bidPrices, book.askPrices, book.bidSizes, book.askSizes, values, first, last);
+        }
+
+        inline double getValue(std::uint32_t slot) const noexcept { return values[slot]; }
+    };
+
+    class MidPrice
+    {
+    private:
+        double* values;
+
+        static inline void computeColumns(const double* __restrict bidPrices, const double* __restrict askPrices,
+                                          double* __restrict values, std::uint32_t first, std::uint32_t last) noexcept
+        {
+            for (std::uint32_t slot = first; slot < last; ++slot)
+            {
+                values[slot] = (bidPrices[slot] + askPrices[slot]) * 0.5;
+            }
+        }
+
+    public:
+        using Dependencies = FeatureList<>;
+        static constexpr std::size_t COLUMNS = 1;
+
+        explicit MidPrice(FeatureStorage& storage) : values{storage.column()}
+        {
+
+        }
+
+        template<typename Pipeline>
+        inline void update(std::uint32_t slot, const BookTop& top, const BookTop&, const Pipeline&) noexcept
+        {
+            values[slot] = (top.bidPrice + top.askPrice) * 0.5;
+        }
+
+        inline void compute(std::uint32_t first, std::uint32_t last, const BookColumns& book) noexcept
+        {
+            computeColumns(book.bidPrices, book.askPrices, values, first, last);
+        }
+
+        inline double getValue(std::uint32_t slot) const noexcept { return values[slot]; }
+    };
+
+    class Spread
+    {
+    private:
+        double* values;
+
+        static inline void computeColumns(const double* __restrict bidPrices, const double* __restrict askPrices,
+                                          double* __restrict values, std::uint32_t first, std::uint32_t last) noexcept
+        {
+            for (std::uint32_t slot = first; slot < last; ++slot)
+            {
+                values[slot] = askPrices[slot] - bidPrices[slot];
+            }
+        }
+
+    public:
+        using Dependencies = FeatureList<>;
+        static constexpr std::size_t COLUMNS = 1;
+
+        explicit Spread(FeatureStorage& storage) : values{storage.column()}
+        {
+
+        }
+
+        template<typename Pipeline>
+        inline void update(std::uint32_t slot, const BookTop& top, const BookTop&, const Pipeline&) noexcept
+        {
+            values[slot] = top.askPrice - top.bidPrice;
+        }
+
+        inline void compute(std::uint32_t first, std::uint32_t last, const BookColumns& book) noexcept
+        {
+            computeColumns(book.bidPrices, book.askPrices, values, first, last);
+        }
+
+        inline double getValue(std::uint32_t slot) const noexcept { return values[slot]; }
+    };
+
+    class BookImbalance
+    {
+    private:
+        double* values;
+
+        static inline void computeColumns(const double* __restrict bidSizes, const double* __restrict askSizes,
+                                          double* __restrict values, std::uint32_t first, std::uint32_t last) noexcept
+        {
+            for (std::uint32_t slot = first; slot < last; ++slot)
+            {
+                values[slot] = (bidSizes[slot] - askSizes[slot]) / (bidSizes[slot] + askSizes[slot]);
+            }
+        }
+
+    public:
+        using Dependencies = FeatureList<>;
+        static constexpr std::size_t COLUMNS = 1;
+
+        explicit BookImbalance(FeatureStorage& storage) : values{storage.column()}
+        {
+
+        }
+
+        template<typename Pipeline>
+        inline void update(std::uint32_t slot, const BookTop& top, const BookTop&, const Pipeline&) noexcept
+        {
+            values[slot] = (top.bidSize - top.askSize) / (top.bidSize + top.askSize);
+        }
+
+        inline void compute(std::uint32_t first, std::uint32_t last, const BookColumns& book) noexcept
+        {
+            computeColumns(book.bidSizes, book.askSizes, values, first, last);
+        }
+
+        inline double getValue(std::uint32_t slot) const noexcept { return values[slot]; }
+    };
+
+    class EwmaMidPrice
+    {
+    private:
+        double* values;
+        std::vector<TimeDecayEwma> averages;     // slot -> average
+
+    public:
+        using Dependencies = FeatureList<MidPrice>;
+        static constexpr std::size_t COLUMNS = 1;
+
+        explicit EwmaMidPrice(FeatureStorage& storage)
+            : values{storage.column()},
+              averages(storage.getCapacity(), TimeDecayEwma{storage.getParams().halfLifeNanos})
+        {
+
+        }
+
+        template<typename Pipeline>
+        inline void update(std::uint32_t slot, const BookTop& top, const BookTop&, const Pipeline& pipeline) noexcept
+        {
+            const double mid = pipeline.template get<MidPrice>().getValue(slot);
+            if (std::isnan(mid)) return;
+
+            averages[slot].update(top.nanos, mid);
+            values[slot] = averages[slot].getValue();
+        }
+
+        inline double getValue(std::uint32_t slot) const noexcept { return values[slot]; }
+    };
+
+    // Only mid price changes are recorded as returns, so a quiet instrument does not fill the window with
+    // zeros. The window is still advanced on every update so that old returns expire
+    class RealizedVolatility
+    {
+    private:
+        double* values;
+        SlotStates<TimeWindow> squaredReturns;
+        std::int64_t windowNanos;
+        std::uint32_t windowCapacity;
+
+    public:
+        using Dependencies = FeatureList<MidPrice>;
+        static constexpr std::size_t COLUMNS = 1;
+
+        explicit RealizedVolatility(FeatureStorage& storage)
+            : values{storage.column()}, squaredReturns{storage.getCapacity()},
+              windowNanos{storage.getParams().windowNanos}, windowCapacity{storage.getParams().windowCapacity}
+        {
+
+        }
+
+        template<typename Pipeline>
+        inline void update(std::uint32_t slot, const BookTop& top, const BookTop& previous, const Pipeline& pipeline)
+        {
+            TimeWindow& window = squaredReturns.get(slot, windowNanos, windowCapacity);
+            window.advance(top.nanos);
+
+            const double mid = pipeline.template get<MidPrice>().getValue(slot);
+            const double previousMid = (previous.bidPrice + previous.askPrice) * 0.5;
+            if (mid != previousMid && mid > 0.0 && previousMid > 0.0)
+            {
+                const double logReturn = std::log(mid / previousMid);
+                window.add(top.nanos, logReturn * logReturn);
+            }
+
+            values[slot] = window.size() == 0 ? 0.0 : std::sqrt(std::max(window.getSum(), 0.0));
+        }
+
+        inline double getValue(std::uint32_t slot) const noexcept { return values[slot]; }
+    };
+
+    // The size added at the touch. A price that improves adds the whole new level, a price that worsens
+    // removes the whole previous level and an unchanged price adds the change in size. Every update is
+    // recorded (with no flow when the book is one-sided), so the window also counts the book updates
+    class OrderFlowImbalance
+    {
+    private:
+        double* values;
+        double* rates;
+        SlotStates<TimeWindow> flows;
+        std::int64_t windowNanos;
+        std::uint32_t windowCapacity;
+
+    public:
+        using Dependencies = FeatureList<>;
+        static constexpr std::size_t COLUMNS = 2;
+
+        explicit OrderFlowImbalance(FeatureStorage& storage)
+            : values{storage.column()}, rates{storage.column()}, flows{storage.getCapacity()},
+              windowNanos{storage.getParams().windowNanos}, windowCapacity{storage.getParams().windowCapacity}
+        {
+
+        }
+
+        template<typename Pipeline>
+        inline void update(std::uint32_t slot, const BookTop& top, const BookTop& previous, const Pipeline&)
+        {
+            double flow = 0.0;
+            if (detail::isTwoSided(top) && detail::isTwoSided(previous))
+            {
+                flow += top.bidPrice >= previous.bidPrice ? top.bidSize : 0.0;
+                flow -= top.bidPrice <= previous.bidPrice ? previous.bidSize : 0.0;
+                flow -= top.askPrice <= previous.askPrice ? top.askSize : 0.0;
+                flow += top.askPrice >= previous.askPrice ? previous.askSize : 0.0;
+            }
+
+            TimeWindow& window = flows.get(slot, windowNanos, windowCapacity);
+            window.add(top.nanos, flow);
+            values[slot] = window.getSum();
+            rates[slot] = window.getRate();
+        }
+
+        inline double getValue(std::uint32_t slot) const noexcept { return values[slot]; }
+
+        // Book updates per second over the window
+        inline double getRate(std::uint32_t slot) const noexcept { return rates[slot]; }
+    };
+
+    // Reads the update count of the order flow window rather than keeping a second window of the same updates
+    class UpdateIntensity
+    {
+    private:
+        double* values;
+
+    public:
+        using Dependencies = FeatureList<OrderFlowImbalance>;
+        static constexpr std::size_t COLUMNS = 1;
+
+        explicit UpdateIntensity(FeatureStorage& storage) : values{storage.column()}
+        {
+
+        }
+
+        template<typename Pipeline>
+        inline void update(std::uint32_t slot, const BookTop&, const BookTop&, const Pipeline& pipeline) noexcept
+        {
+            values[slot] = pipeline.template get<OrderFlowImbalance>().getRate(slot);
+        }
+
+        inline double getValue(std::uint32_t slot) const noexcept { return values[slot]; }
+    };
+
+    class SpreadStats
+    {
+    private:
+        double* means;
+        double* stdDevs;
+        SlotStates<CountWindow> spreads;
+        std::uint32_t spreadEvents;
+
+    public:
+        using Dependencies = FeatureList<Spread>;
+        static constexpr std::size_t COLUMNS = 2;
+
+        explicit SpreadStats(FeatureStorage& storage)
+            : means{storage.column()}, stdDevs{storage.column()}, spreads{storage.getCapacity()},
+              spreadEvents{storage.getParams().spreadEvents}
+        {
+
+        }
+
+        template<typename Pipeline>
+        inline void update(std::uint32_t slot, const BookTop& top, const BookTop&, const Pipeline& pipeline)
+        {
+            if (!detail::isTwoSided(top)) return;
+
+            CountWindow& window = spreads.get(slot, spreadEvents);
+            window.add(pipeline.template get<Spread>().getValue(slot));
+            means[slot] = window.getMean();
+            stdDevs[slot] = window.getStdDev();
+        }
+
+        inline double getMean(std::uint32_t slot) const noexcept { return means[slot]; }
+
+        inline double getStdDev(std::uint32_t slot) const noexcept { return stdDevs[slot]; }
+    };
+
+} // namespace BeaconTech::Strategies
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_FEATURES_HPP
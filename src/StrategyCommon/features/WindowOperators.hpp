@@ -0,0 +1,283 @@
+//
+// Incremental operators for rolling window features. Every operator is updated in O(1) per sample
+// (amortized for time windows, which expire each sample exactly once) and never rescans its history:
+//
+// 1) Welford        - Running mean and variance that supports removing samples as well as adding them
+// 2) Ewma           - Exponentially weighted moving average with a fixed weight per sample
+// 3) TimeDecayEwma  - Exponentially weighted moving average that decays with the time between samples
+// 4) CountWindow    - Mean and variance of the last N samples
+// 5) TimeWindow     - Sum, mean, variance and rate of the samples within a time horizon
+//
+// Windows keep their samples in a RingBuffer that is allocated once with a fixed capacity, so updates
+// never allocate. A TimeWindow that is full evicts its oldest sample early, so size the capacity for the
+// busiest instrument. Timestamps are nanoseconds and must not go backwards; earlier timestamps are
+// treated as the latest one seen.
+//
+// Removing samples from a Welford accumulator can leave a slightly negative variance after rounding,
+// so variances are clamped at 0.
+//
+// Created by Michael Lewis on 1/28/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_WINDOWOPERATORS_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_WINDOWOPERATORS_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace BeaconTech::Strategies
+{
+
+    // A FIFO of at most capacity elements. The storage is rounded up to a power of 2 so that indexes wrap with a mask
+    template<typename T>
+    class RingBuffer
+    {
+    private:
+        std::vector<T> elements;
+        std::size_t mask;
+        std::size_t capacity;
+        std::size_t head;
+        std::size_t count;
+
+    public:
+        explicit RingBuffer(std::size_t capacity)
+            : elements(std::bit_ceil(std::max<std::size_t>(capacity, 1))), mask{elements.size() - 1},
+              capacity{std::max<std::size_t>(capacity, 1)}, head{0}, count{0}
+        {
+
+        }
+
+        inline bool empty() const noexcept { return count == 0; }
+
+        inline bool full() const noexcept { return count == capacity; }
+
+        inline std::size_t size() const noexcept { return count; }
+
+        inline std::size_t getCapacity() const noexcept { return capacity; }
+
+        inline const T& front() const noexcept { return elements[head]; }
+
+        inline const T& back() const noexcept { return elements[(head + count - 1) & mask]; }
+
+        // Must not be called when full
+        inline void pushBack(const T& element) noexcept
+        {
+            elements[(head + count) & mask] = element;
+            ++count;
+        }
+
+        // Must not be called when empty
+        inline void popFront() noexcept
+        {
+            head = (head + 1) & mask;
+            --count;
+        }
+    };
+
+    class Welford
+    {
+    private:
+        std::uint64_t count{0};
+        double mean{0.0};
+        double m2{0.0};     // Sum of squared differences from the mean
+
+    public:
+        inline void add(double sample) noexcept
+        {
+            ++count;
+            const double delta = sample - mean;
+            mean += delta / static_cast<double>(count);
+            m2 += delta * (sample - mean);
+        }
+
+        // Must only be called with a sample that was added
+        inline void remove(double sample) noexcept
+        {
+            if (count <= 1)
+            {
+                reset();
+                return;
+            }
+
+            const double previousMean = mean;
+            --count;
+            mean -= (sample - previousMean) / static_cast<double>(count);
+            m2 = std::max(m2 - (sample - previousMean) * (sample - mean), 0.0);
+        }
+
+        inline void reset() noexcept
+        {
+            count = 0;
+            mean = 0.0;
+            m2 = 0.0;
+        }
+
+        inline std::uint64_t getCount() const noexcept { return count; }
+
+        inline double getMean() const noexcept { return count == 0 ? std::numeric_limits<double>::quiet_NaN() : mean; }
+
+        inline double getSum() const noexcept { return mean * static_cast<double>(count); }
+
+        // Sample variance
+        inline double getVariance() const noexcept
+        {
+            return count < 2 ? std::numeric_limits<double>::quiet_NaN() : m2 / static_cast<double>(count - 1);
+        }
+
+        inline double getStdDev() const noexcept { return std::sqrt(getVariance()); }
+    };
+
+    // Each sample is weighted by alpha (0, 1]. The first sample seeds the average
+    class Ewma
+    {
+    private:
+        double alpha;
+        double value;
+
+    public:
+        explicit Ewma(double alpha) : alpha{alpha}, value{std::numeric_limits<double>::quiet_NaN()}
+        {
+
+        }
+
+        inline void update(double sample) noexcept
+        {
+            value = std::isnan(value) ? sample : value + alpha * (sample - value);
+        }
+
+        inline double getValue() const noexcept { return value; }
+    };
+
+    // The weight of the previous average halves every halfLifeNanos, so a sample that arrives after a long
+    // quiet period moves the average further than one that arrives immediately after the last
+    class TimeDecayEwma
+    {
+    private:
+        double halfLifeNanos;
+        std::int64_t lastNanos;
+        double value;
+
+    public:
+        explicit TimeDecayEwma(std::int64_t halfLifeNanos)
+            : halfLifeNanos{static_cast<double>(std::max<std::int64_t>(halfLifeNanos, 1))}, lastNanos{0},
+              value{std::numeric_limits<double>::quiet_NaN()}
+        {
+
+        }
+
+        inline void update(std::int64_t nanos, double sample) noexcept
+        {
+            if (std::isnan(value))
+            {
+                value = sample;
+                lastNanos = nanos;
+                return;
+            }
+
+            const std::int64_t elapsed = std::max<std::int64_t>(nanos - lastNanos, 0);
+            const double weight = std::exp2(-static_cast<double>(elapsed) / halfLifeNanos);
+            value = sample + weight * (value - sample);
+            lastNanos = std::max(nanos, lastNanos);
+        }
+
+        inline double getValue() const noexcept { return value; }
+    };
+
+    class CountWindow
+    {
+    private:
+        RingBuffer<double> samples;
+        Welford stats;
+
+    public:
+        explicit CountWindow(std::size_t capacity) : samples{capacity}, stats{}
+        {
+
+        }
+
+        inline void add(double sample) noexcept
+        {
+            if (samples.full())
+            {
+                stats.remove(samples.front());
+                samples.popFront();
+            }
+
+            samples.pushBack(sample);
+            stats.add(sample);
+        }
+
+        inline std::size_t size() const noexcept { return samples.size(); }
+
+        inline double getMean() const noexcept { return stats.getMean(); }
+
+        inline double getStdDev() const noexcept { return stats.getStdDev(); }
+    };
+
+    class TimeWindow
+    {
+    private:
+        struct Sample
+        {
+            std::int64_t nanos;
+            double value;
+        };
+
+        RingBuffer<Sample> samples;
+        Welford stats;
+        std::int64_t horizonNanos;
+        std::int64_t latestNanos;
+
+        inline void evictOldest() noexcept
+        {
+            stats.remove(samples.front().value);
+            samples.popFront();
+        }
+
+    public:
+        TimeWindow(std::int64_t horizonNanos, std::size_t capacity)
+            : samples{capacity}, stats{}, horizonNanos{std::max<std::int64_t>(horizonNanos, 1)},
+              latestNanos{std::numeric_limits<std::int64_t>::min()}
+        {
+
+        }
+
+        // Expires the samples that are older than the horizon at nanos
+        inline void advance(std::int64_t nanos) noexcept
+        {
+            latestNanos = std::max(latestNanos, nanos);
+            while (!samples.empty() && samples.front().nanos <= latestNanos - horizonNanos) evictOldest();
+        }
+
+        inline void add(std::int64_t nanos, double sample) noexcept
+        {
+            advance(nanos);
+            if (samples.full()) evictOldest();
+
+            samples.pushBack(Sample{latestNanos, sample});
+            stats.add(sample);
+        }
+
+        inline std::size_t size() const noexcept { return samples.size(); }
+
+        inline double getSum() const noexcept { return stats.getSum(); }
+
+        inline double getMean() const noexcept { return stats.getMean(); }
+
+        inline double getStdDev() const noexcept { return stats.getStdDev(); }
+
+        // Samples per second over the horizon
+        inline double getRate() const noexcept
+        {
+            return static_cast<double>(samples.size()) * 1e9 / static_cast<double>(horizonNanos);
+        }
+    };
+
+} // namespace BeaconTech::Strategies
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_WINDOWOPERATORS_HPP
@@ -0,0 +1,46 @@
+//
+// Maps instrument ids onto dense slots so that per-instrument state can live in flat arrays.
+//
+// Created by Michael Lewis on 1/27/24.
+//
+
+#include <algorithm>
+#include <iostream>
+
+#include "InstrumentRegistry.hpp"
+#include "../../CommonServer/logging/LogLevel.hpp"
+
+namespace BeaconTech::Strategies
+{
+    // At least two slots so that there is always one besides the overflow slot
+    InstrumentRegistry::InstrumentRegistry(std::uint32_t capacity)
+        : capacity{std::max(capacity, 2U)}, nextSlot{0}, overflowed{false}
+    {
+        slots.reserve(this->capacity);
+    }
+
+    // Returns the slot of the instrument, assigning the next free slot the first time it is seen. Once
+    // every slot is taken the overflow slot is returned without recording the instrument, so the map is
+    // never rehashed on the hot path
+    std::uint32_t InstrumentRegistry::slot(std::uint32_t instrumentId)
+    {
+        auto it = slots.find(instrumentId);
+        if (it != slots.end()) [[likely]] return it->second;
+
+        if (nextSlot < getOverflowSlot()) [[likely]]
+        {
+            slots.emplace(instrumentId, nextSlot);
+            return nextSlot++;
+        }
+
+        if (!overflowed)
+        {
+            overflowed = true;
+            std::cerr << Common::LogLevel::WARN.getDesc() << " : More than " << getOverflowSlot()
+                      << " instruments, sharing the overflow slot from instrumentId=" << instrumentId
+                      << ". Raise maxInstruments" << std::endl;
+        }
+
+        return getOverflowSlot();
+    }
+} // namespace BeaconTech::Strategies
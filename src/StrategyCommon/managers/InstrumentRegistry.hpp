@@ -0,0 +1,61 @@
+//
+// Maps instrument ids onto dense slots 0..capacity-1 so that per-instrument state (strategy parameters,
+// features) can live in flat arrays indexed by slot instead of hash maps keyed by instrument id.
+//
+// Slots are assigned in the order instruments are first seen, starting with the instruments listed in
+// the configs at startup. The last slot is an overflow slot that is shared by every instrument seen
+// after the others are taken, so an unexpected instrument never grows the arrays on the hot path.
+// Instruments in the overflow slot are not recorded, so the map never holds more than capacity - 1
+// entries either. Raise maxInstruments if the overflow slot is ever used.
+//
+// The registry is only accessed by the market data consumer thread (and by the StrategyServer before
+// that thread starts), so it requires no synchronization. Engines only ever see the slots it assigned.
+//
+//   "maxInstruments": "4096"
+//
+// Created by Michael Lewis on 1/27/24.
+//
+
+#ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_INSTRUMENTREGISTRY_HPP
+#define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_INSTRUMENTREGISTRY_HPP
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace BeaconTech::Strategies
+{
+
+    class InstrumentRegistry
+    {
+    private:
+        std::uint32_t capacity;
+        std::unordered_map<std::uint32_t, std::uint32_t> slots; // instrumentId -> slot
+        std::uint32_t nextSlot;
+        bool overflowed;
+
+    public:
+        explicit InstrumentRegistry(std::uint32_t capacity);
+
+        virtual ~InstrumentRegistry() = default;
+
+        std::uint32_t slot(std::uint32_t instrumentId);
+
+        inline std::uint32_t getCapacity() const noexcept { return capacity; }
+
+        inline std::uint32_t getOverflowSlot() const noexcept { return capacity - 1; }
+
+        // Deleted default ctors and assignment operators
+        InstrumentRegistry() = delete;
+
+        InstrumentRegistry(const InstrumentRegistry& other) = delete;
+
+        InstrumentRegistry(InstrumentRegistry&& other) = delete;
+
+        InstrumentRegistry& operator=(const InstrumentRegistry& other) = delete;
+
+        InstrumentRegistry& operator=(InstrumentRegistry&& other) = delete;
+    };
+
+} // namespace BeaconTech::Strategies
+
+#endif //MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_INSTRUMENTREGISTRY_HPP
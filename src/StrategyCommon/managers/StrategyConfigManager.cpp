@@ -1,9 +1,130 @@
 //
+// Holds the strategy parameters of every instrument in a dense table indexed by instrument slot.
+//
 // Created by Michael Lewis on 10/28/23.
 //
 
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
 #include "StrategyConfigManager.hpp"
+#include "../../CommonServer/logging/LogLevel.hpp"
+#include "../../CommonServer/utils/ConfigManager.hpp"
 
 namespace BeaconTech::Strategies
 {
-} // BeaconTech::Strategies
\ No newline at end of file
+    namespace
+    {
+        // The whole field must be a number that fits the type, as with the ConfigManager. Unsigned fields
+        // reject a sign rather than wrapping a negative value
+        template<typename T>
+        T parseField(const std::string& field, const char* name)
+        {
+            T value{};
+            const char* end = field.data() + field.size();
+            const auto result = std::from_chars(field.data(), end, value);
+            if (result.ec != std::errc{} || result.ptr != end)
+            {
+                throw std::invalid_argument{std::string{name} + " is not a valid number"};
+            }
+
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                if (!std::isfinite(value)) throw std::invalid_argument{std::string{name} + " must be finite"};
+            }
+
+            return value;
+        }
+    }
+
+    StrategyConfigManager::StrategyConfigManager(InstrumentRegistry& instruments)
+        : instruments{instruments}, params(instruments.getCapacity())
+    {
+        loadInstrumentParams(Common::ConfigManager::config().instrumentParamsFile);
+
+        params[instruments.getOverflowSlot()].enabled = false;
+    }
+
+    // Loads the parameters of the listed instruments, assigning each of them a slot. Blank lines and
+    // lines starting with # are ignored
+    void StrategyConfigManager::loadInstrumentParams(const std::string& paramsFile)
+    {
+        if (paramsFile.empty()) return;
+
+        std::ifstream file{paramsFile, std::ios::in};
+        if (!file.is_open())
+        {
+            std::cerr << Common::LogLevel::WARN.getDesc()
+                      << " : Unable to open instrument params file " << paramsFile << std::endl;
+            return;
+        }
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.empty() || line.front() == '#') continue;
+
+            try
+            {
+                std::uint32_t instrumentId = 0;
+                const InstrumentParams instrumentParams = parseInstrumentParams(line, instrumentId);
+
+                const std::uint32_t slot = instruments.slot(instrumentId);
+                if (slot == instruments.getOverflowSlot())
+                {
+                    std::cerr << Common::LogLevel::WARN.getDesc()
+                              << " : Ignoring instrument params beyond maxInstruments " << line << std::endl;
+                    continue;
+                }
+
+                params[slot] = instrumentParams;
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << Common::LogLevel::WARN.getDesc()
+                          << " : Ignoring invalid instrument params " << line << " - " << e.what() << std::endl;
+            }
+        }
+    }
+
+    // Parses instrumentId,targetSpreadBps,targetSize,maxOrderSize,tickSize,enabled. Throws if a field is invalid
+    InstrumentParams StrategyConfigManager::parseInstrumentParams(const std::string& line, std::uint32_t& instrumentId)
+    {
+        std::vector<std::string> fields;
+        std::stringstream stream{line};
+        std::string field;
+        while (std::getline(stream, field, ',')) fields.push_back(field);
+
+        if (fields.empty() || fields.size() > 6 || fields[0].empty())
+        {
+            throw std::invalid_argument{"expected instrumentId,targetSpreadBps,targetSize,maxOrderSize,tickSize,enabled"};
+        }
+
+        fields.resize(6);
+        instrumentId = parseField<std::uint32_t>(fields[0], "instrumentId");
+
+        InstrumentParams instrumentParams{};
+        if (!fields[1].empty()) instrumentParams.targetSpreadBps = parseField<double>(fields[1], "targetSpreadBps");
+        if (!fields[2].empty()) instrumentParams.targetSize = parseField<std::uint32_t>(fields[2], "targetSize");
+        if (!fields[3].empty()) instrumentParams.maxOrderSize = parseField<std::uint32_t>(fields[3], "maxOrderSize");
+        if (!fields[4].empty()) instrumentParams.tickSize = parseField<double>(fields[4], "tickSize");
+        if (!fields[5].empty())
+        {
+            if (fields[5] != "true" && fields[5] != "false") throw std::invalid_argument{"enabled must be true or false"};
+            instrumentParams.enabled = fields[5] == "true";
+        }
+
+        if (instrumentParams.targetSpreadBps < 0.0 || instrumentParams.tickSize < 0.0)
+        {
+            throw std::invalid_argument{"targetSpreadBps and tickSize must not be negative"};
+        }
+
+        return instrumentParams;
+    }
+} // BeaconTech::Strategies
@@ -1,16 +1,78 @@
 //
+// Holds the strategy parameters of every instrument in a dense table indexed by the slot the
+// InstrumentRegistry assigned it, so a strategy fetches the parameters of a book update with a single
+// indexed load instead of a hash lookup.
+//
+// The parameters are loaded at startup from the file configured by instrumentParamsFile. Each line is
+// formatted as instrumentId,targetSpreadBps,targetSize,maxOrderSize,tickSize,enabled. Empty fields keep
+// their defaults, as do instruments that are not listed:
+//
+//   # instrumentId,targetSpreadBps,targetSize,maxOrderSize,tickSize,enabled
+//   1234,0.0005,200,1000,0.01,true
+//   5678,,50,,,true
+//   9012,,,,,false
+//
+// A targetSpreadBps or targetSize of 0 defers to the engine's reloadable configs of the same name, so
+// only the instruments that need their own values have to be listed. maxOrderSize caps the size of each
+// order request (0 is no cap). It does not limit the position, which the strategy does not track. A
+// tickSize of 0 leaves prices unrounded. The overflow slot is shared by unknown instruments and is
+// always disabled.
+//
+//   "instrumentParamsFile": ""
+//
+// The table is written before the engines start and only read after that, so it requires no synchronization.
+//
 // Created by Michael Lewis on 10/28/23.
 //
 
 #ifndef MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_STRATEGYCONFIGMANAGER_HPP
 #define MULTI_THREADED_ALGORITHMIC_TRADING_SYSTEM_STRATEGYCONFIGMANAGER_HPP
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "InstrumentRegistry.hpp"
+
 namespace BeaconTech::Strategies
 {
 
+    struct InstrumentParams
+    {
+        double targetSpreadBps{0.0};
+        std::uint32_t targetSize{0};
+        std::uint32_t maxOrderSize{0};
+        double tickSize{0.0};
+        bool enabled{true};
+    };
+
     class StrategyConfigManager
     {
+    private:
+        InstrumentRegistry& instruments;
+        std::vector<InstrumentParams> params;   // slot -> params
+
+        void loadInstrumentParams(const std::string& paramsFile);
+
+        static InstrumentParams parseInstrumentParams(const std::string& line, std::uint32_t& instrumentId);
+
+    public:
+        explicit StrategyConfigManager(InstrumentRegistry& instruments);
+
+        virtual ~StrategyConfigManager() = default;
+
+        inline const InstrumentParams& getParams(std::uint32_t slot) const noexcept { return params[slot]; }
+
+        // Deleted default ctors and assignment operators
+        StrategyConfigManager() = delete;
+
+        StrategyConfigManager(const StrategyConfigManager& other) = delete;
+
+        StrategyConfigManager(StrategyConfigManager&& other) = delete;
+
+        StrategyConfigManager& operator=(const StrategyConfigManager& other) = delete;
 
+        StrategyConfigManager& operator=(StrategyConfigManager&& other) = delete;
     };
 
 } // BeaconTech::Strategies